@@ -1,61 +1,221 @@
-#include "RC_DepthDrawer.h"
-
-#include <cfloat>
-
-// ==============================/  class RC_DepthDrawer   /==============================
-
-RC_DepthDrawer::RC_DepthDrawer() {}
-RC_DepthDrawer::~RC_DepthDrawer() {
-    delete fDepthBuffer;
-}
-
-void RC_DepthDrawer::Init( olc::PixelGameEngine *gfx ) {
-    // store pointer to pge to enable calling it's (render) functions
-    pgePtr = gfx;
-    // Initialize depth buffer
-    fDepthBuffer = new float[ gfx->ScreenWidth() * gfx->ScreenHeight() ];
-}
-
-int RC_DepthDrawer::ScreenWidth() {  return pgePtr->ScreenWidth();  }
-int RC_DepthDrawer::ScreenHeight() { return pgePtr->ScreenHeight(); }
-
-// Variant on Draw() that takes fDepth and the depth buffer into account.
-// Pixel col is only drawn if fDepth is less than the depth buffer at that screen location (in which case the depth buffer is updated)
-void RC_DepthDrawer::Draw( float fDepth, int x, int y, olc::Pixel col ) {
-    // prevent out of bounds drawing
-    if (x >= 0 && x < pgePtr->ScreenWidth() &&
-        y >= 0 && y < pgePtr->ScreenHeight()) {
-
-        if (fDepth <= fDepthBuffer[ y * pgePtr->ScreenWidth() + x ]) {
-            fDepthBuffer[ y * pgePtr->ScreenWidth() + x ] = fDepth;
-            pgePtr->Draw( x, y, col );
-        }
-    }
-}
-
-// sets all pixels of the depth buffer to absolute max depth value
-void RC_DepthDrawer::Reset() {
-    for (int i = 0; i < pgePtr->ScreenHeight() * pgePtr->ScreenWidth(); i++) {
-        fDepthBuffer[ i ] = FLT_MAX;
-    }
-}
-
-// set a subrange of slice nSlice in the depth buffer to absolute max depth value
-void RC_DepthDrawer::Reset( int nSlice, int nLowY, int nHghY ) {
-    for (int y = nLowY; y <= nHghY; y++) {
-        fDepthBuffer[ y * pgePtr->ScreenWidth() + nSlice ] = FLT_MAX;
-    }
-}
-
-bool RC_DepthDrawer::IsMasked( int x, int y, float fDepth ) {
-    bool bResult = false;
-    // prevent out of bounds checking
-    if (x >= 0 && x < pgePtr->ScreenWidth() &&
-        y >= 0 && y < pgePtr->ScreenHeight()) {
-
-        bResult = fDepthBuffer[ y * pgePtr->ScreenWidth() + x ] < fDepth;
-    } else {
-        bResult = true;
-    }
-    return bResult;
-}
+#include "RC_DepthDrawer.h"
+
+#include <algorithm>
+#include <cfloat>
+
+// ==============================/  class RC_DepthDrawer   /==============================
+
+RC_DepthDrawer::RC_DepthDrawer() {}
+RC_DepthDrawer::~RC_DepthDrawer() {
+    delete[] fDepthBuffer;
+    delete[] fShadeBuffer;
+}
+
+void RC_DepthDrawer::Init( olc::PixelGameEngine *gfx, int nW, int nH ) {
+    // store pointer to pge to enable calling it's (render) functions
+    pgePtr = gfx;
+    // Initialize depth buffer - a buffer of a previous Init() is released
+    delete[] fDepthBuffer;
+    delete[] fShadeBuffer;
+    fShadeBuffer = nullptr;
+    nWidth  = (nW < 0) ? gfx->ScreenWidth()  : nW;
+    nHeight = (nH < 0) ? gfx->ScreenHeight() : nH;
+    fDepthBuffer = new float[ nWidth * nHeight ];
+}
+
+int RC_DepthDrawer::ScreenWidth() {  return nWidth;  }
+int RC_DepthDrawer::ScreenHeight() { return nHeight; }
+
+// Variant on Draw() that takes fDepth and the depth buffer into account.
+// Pixel col is only drawn if fDepth is less than the depth buffer at that screen location (in which case the depth buffer is updated)
+void RC_DepthDrawer::Draw( float fDepth, int x, int y, olc::Pixel col, float fShadeDist ) {
+    // prevent out of bounds drawing
+    if (x >= 0 && x < nWidth &&
+        y >= 0 && y < nHeight) {
+
+        if (fDepth <= fDepthBuffer[ y * nWidth + x ]) {
+            fDepthBuffer[ y * nWidth + x ] = fDepth;
+            pgePtr->Draw( x, y, col );
+            if (fShadeBuffer != nullptr) {
+                fShadeBuffer[ y * nWidth + x ] = fShadeDist;
+            }
+        }
+    }
+}
+
+bool RC_DepthDrawer::ClipColumnSpan( int x, int &y0, int &y1, int &nOffset ) {
+    if (x < 0 || x >= nWidth) {
+        return false;
+    }
+    nOffset = std::max( 0, -y0 );
+    y0 += nOffset;
+    y1  = std::min( y1, nHeight - 1 );
+    return y0 <= y1;
+}
+
+// Span variant of Draw() with one depth value for the whole span
+void RC_DepthDrawer::DrawColumnSpan( int x, int y0, int y1, float fDepth, const olc::Pixel *pPixels, const float *pShadeDists ) {
+    int nOffset;
+    if (ClipColumnSpan( x, y0, y1, nOffset )) {
+        float      *pDepth = &fDepthBuffer[ y0 * nWidth + x ];
+        olc::Pixel *pPixel = &pgePtr->GetDrawTarget()->GetData()[ y0 * nWidth + x ];
+        pPixels += nOffset;
+        for (int y = y0; y <= y1; y++, pDepth += nWidth, pPixel += nWidth, pPixels++) {
+            if (fDepth <= *pDepth) {
+                *pDepth = fDepth;
+                *pPixel = *pPixels;
+            }
+        }
+        if (fShadeBuffer != nullptr) {
+            SetShadeColumn( x, y0, y1, &fDepth, 0, (pShadeDists == nullptr) ? nullptr : pShadeDists + nOffset );
+        }
+    }
+}
+
+// Span variant of Draw() with a depth value per pixel
+void RC_DepthDrawer::DrawColumnSpan( int x, int y0, int y1, const float *pDepths, const olc::Pixel *pPixels, const float *pShadeDists ) {
+    int nOffset;
+    if (ClipColumnSpan( x, y0, y1, nOffset )) {
+        float      *pDepth = &fDepthBuffer[ y0 * nWidth + x ];
+        olc::Pixel *pPixel = &pgePtr->GetDrawTarget()->GetData()[ y0 * nWidth + x ];
+        pDepths += nOffset;
+        pPixels += nOffset;
+        for (int y = y0; y <= y1; y++, pDepth += nWidth, pPixel += nWidth, pDepths++, pPixels++) {
+            if (*pDepths <= *pDepth) {
+                *pDepth = *pDepths;
+                *pPixel = *pPixels;
+            }
+        }
+        if (fShadeBuffer != nullptr) {
+            SetShadeColumn( x, y0, y1, pDepths - (y1 - y0 + 1), 1, (pShadeDists == nullptr) ? nullptr : pShadeDists + nOffset );
+        }
+    }
+}
+
+// Span variant of Draw() with one depth value and one colour for the whole span
+void RC_DepthDrawer::FillColumnSpan( int x, int y0, int y1, float fDepth, olc::Pixel col ) {
+    int nOffset;
+    if (ClipColumnSpan( x, y0, y1, nOffset )) {
+        float      *pDepth = &fDepthBuffer[ y0 * nWidth + x ];
+        olc::Pixel *pPixel = &pgePtr->GetDrawTarget()->GetData()[ y0 * nWidth + x ];
+        for (int y = y0; y <= y1; y++, pDepth += nWidth, pPixel += nWidth) {
+            if (fDepth <= *pDepth) {
+                *pDepth = fDepth;
+                *pPixel = col;
+            }
+        }
+        if (fShadeBuffer != nullptr) {
+            SetShadeColumn( x, y0, y1, &fDepth, 0, nullptr );
+        }
+    }
+}
+
+// Row variant of DrawColumnSpan() with one depth value for the whole span
+void RC_DepthDrawer::DrawRowSpan( int y, int x0, int x1, float fDepth, const olc::Pixel *pPixels, const float *pShadeDists ) {
+    if (y < 0 || y >= nHeight) {
+        return;
+    }
+    int nOffset = std::max( 0, -x0 );
+    x0 += nOffset;
+    x1  = std::min( x1, nWidth - 1 );
+    float      *pDepth = &fDepthBuffer[ y * nWidth ];
+    olc::Pixel *pPixel = &pgePtr->GetDrawTarget()->GetData()[ y * nWidth ];
+    pPixels += nOffset;
+    for (int x = x0; x <= x1; x++, pPixels++) {
+        if (fDepth <= pDepth[x]) {
+            pDepth[x] = fDepth;
+            pPixel[x] = *pPixels;
+        }
+    }
+    if (fShadeBuffer != nullptr) {
+        float *pShade = &fShadeBuffer[ y * nWidth ];
+        for (int x = x0; x <= x1; x++) {
+            if (pDepth[x] == fDepth) {
+                pShade[x] = (pShadeDists == nullptr) ? 0.0f : pShadeDists[ nOffset + x - x0 ];
+            }
+        }
+    }
+}
+
+// Writes the shade distances of the span y0 - y1 of column x (which is clipped already) into the shade buffer. It's called after the span
+// is drawn, so the pixels that passed the depth test are the ones that have the depth of the span now. pDepths has one depth per pixel if
+// nDepthStep is 1, or one depth for the whole span if it's 0. Without pShadeDists the pixels are final (shade distance 0.0f).
+void RC_DepthDrawer::SetShadeColumn( int x, int y0, int y1, const float *pDepths, int nDepthStep, const float *pShadeDists ) {
+    float *pDepth = &fDepthBuffer[ y0 * nWidth + x ];
+    float *pShade = &fShadeBuffer[ y0 * nWidth + x ];
+    for (int i = 0; i <= y1 - y0; i++, pDepth += nWidth, pShade += nWidth) {
+        if (*pDepth == pDepths[ i * nDepthStep ]) {
+            *pShade = (pShadeDists == nullptr) ? 0.0f : pShadeDists[i];
+        }
+    }
+}
+
+const float *RC_DepthDrawer::GetDepthRow( int y ) {
+    return &fDepthBuffer[ y * nWidth ];
+}
+
+void RC_DepthDrawer::EnableShadeBuffer( bool bEnable ) {
+    if (bEnable && fShadeBuffer == nullptr) {
+        fShadeBuffer = new float[ nWidth * nHeight ]();
+    } else if (!bEnable) {
+        delete[] fShadeBuffer;
+        fShadeBuffer = nullptr;
+    }
+}
+
+bool RC_DepthDrawer::HasShadeBuffer() { return fShadeBuffer != nullptr; }
+
+float *RC_DepthDrawer::GetShadeRow( int y ) {
+    return (fShadeBuffer == nullptr) ? nullptr : &fShadeBuffer[ y * nWidth ];
+}
+
+// sets all pixels of the depth buffer to absolute max depth value
+void RC_DepthDrawer::Reset() {
+    for (int i = 0; i < nHeight * nWidth; i++) {
+        fDepthBuffer[ i ] = FLT_MAX;
+    }
+    if (fShadeBuffer != nullptr) {
+        for (int i = 0; i < nHeight * nWidth; i++) {
+            fShadeBuffer[ i ] = 0.0f;
+        }
+    }
+}
+
+// set a subrange of slice nSlice in the depth buffer to absolute max depth value
+void RC_DepthDrawer::Reset( int nSlice, int nLowY, int nHghY ) {
+    for (int y = nLowY; y <= nHghY; y++) {
+        fDepthBuffer[ y * nWidth + nSlice ] = FLT_MAX;
+    }
+    if (fShadeBuffer != nullptr) {
+        for (int y = nLowY; y <= nHghY; y++) {
+            fShadeBuffer[ y * nWidth + nSlice ] = 0.0f;
+        }
+    }
+}
+
+// copy the complete depth buffer of rSrc
+void RC_DepthDrawer::CopyFrom( RC_DepthDrawer &rSrc ) {
+    for (int i = 0; i < nHeight * nWidth; i++) {
+        fDepthBuffer[ i ] = rSrc.fDepthBuffer[ i ];
+    }
+}
+
+// copy slice nSlice of the depth buffer of rSrc
+void RC_DepthDrawer::CopyFrom( RC_DepthDrawer &rSrc, int nSlice ) {
+    for (int y = 0; y < nHeight; y++) {
+        fDepthBuffer[ y * nWidth + nSlice ] = rSrc.fDepthBuffer[ y * nWidth + nSlice ];
+    }
+}
+
+bool RC_DepthDrawer::IsMasked( int x, int y, float fDepth ) {
+    bool bResult = false;
+    // prevent out of bounds checking
+    if (x >= 0 && x < nWidth &&
+        y >= 0 && y < nHeight) {
+
+        bResult = fDepthBuffer[ y * nWidth + x ] < fDepth;
+    } else {
+        bResult = true;
+    }
+    return bResult;
+}
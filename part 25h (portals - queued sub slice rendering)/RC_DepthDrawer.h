@@ -1,42 +1,79 @@
-#ifndef RC_DEPTHDRAWER_H
-#define RC_DEPTHDRAWER_H
-
-#include "olcPixelGameEngine.h"
-
-//////////////////////////////////  RC_DepthDrawer   //////////////////////////////////////////
-
-/* I need a uniform way to draw to screen using the PGE, and incorporating a shared depth buffer (2D).
- * This class implements that functionality.
- */
-
-// ==============================/  class RC_DepthDrawer   /==============================
-
-class RC_DepthDrawer {
-private:
-    // the 2D depth buffer
-    float *fDepthBuffer = nullptr;
-    olc::PixelGameEngine *pgePtr = nullptr;
-
-public:
-    RC_DepthDrawer();
-
-    ~RC_DepthDrawer();
-
-    void Init( olc::PixelGameEngine *gfx );
-
-    int ScreenWidth();
-    int ScreenHeight();
-
-    // Variant on Draw() that takes fDepth and the depth buffer into account.
-    // Pixel col is only drawn if fDepth is less than the depth buffer at that screen location (in which case the depth buffer is updated)
-    void Draw( float fDepth, int x, int y, olc::Pixel col );
-
-    // sets all pixels of the depth buffer to absolute max depth value
-    void Reset();
-    void Reset( int nSlice, int nLowY, int nHghY );
-
-    bool IsMasked( int x, int y, float fDepth );
-};
-
-
-#endif // RC_DEPTHDRAWER_H
+#ifndef RC_DEPTHDRAWER_H
+#define RC_DEPTHDRAWER_H
+
+#include "olcPixelGameEngine.h"
+
+//////////////////////////////////  RC_DepthDrawer   //////////////////////////////////////////
+
+/* I need a uniform way to draw to screen using the PGE, and incorporating a shared depth buffer (2D).
+ * This class implements that functionality.
+ */
+
+// ==============================/  class RC_DepthDrawer   /==============================
+
+class RC_DepthDrawer {
+private:
+    // the 2D depth buffer
+    float *fDepthBuffer = nullptr;
+    int    nWidth = 0, nHeight = 0;    // size of the depth buffer - and of the draw target it's used with
+    // the optional shade buffer: per pixel the distance to shade it with afterwards, or 0.0f if the pixel is final already
+    float *fShadeBuffer = nullptr;
+    olc::PixelGameEngine *pgePtr = nullptr;
+
+public:
+    RC_DepthDrawer();
+
+    ~RC_DepthDrawer();
+
+    // (re)allocates the depth buffer for a draw target of nW x nH pixels (-1 means: the screen size of gfx)
+    void Init( olc::PixelGameEngine *gfx, int nW = -1, int nH = -1 );
+
+    int ScreenWidth();
+    int ScreenHeight();
+
+    // Variant on Draw() that takes fDepth and the depth buffer into account.
+    // Pixel col is only drawn if fDepth is less than the depth buffer at that screen location (in which case the depth buffer is updated)
+    void Draw( float fDepth, int x, int y, olc::Pixel col, float fShadeDist = 0.0f );
+
+    // Span variants of Draw(), to draw the rows y0 up to and including y1 of screen column x at once. Element i of the pDepths and
+    // pPixels arrays is for row y0 + i. The bounds are checked once per span, and the pixels are written directly into the draw
+    // target, so the pixel mode of the PGE is not applied (the draw target must have the size of the depth buffer)
+    // If pShadeDists is passed, these are the shade distances of the pixels for the shade buffer (see EnableShadeBuffer())
+    void DrawColumnSpan( int x, int y0, int y1, float fDepth, const olc::Pixel *pPixels, const float *pShadeDists = nullptr );
+    void DrawColumnSpan( int x, int y0, int y1, const float *pDepths, const olc::Pixel *pPixels, const float *pShadeDists = nullptr );
+    // same, but with one colour for the whole span
+    void FillColumnSpan( int x, int y0, int y1, float fDepth, olc::Pixel col );
+    // row variant of DrawColumnSpan(): draws the columns x0 up to and including x1 of screen row y at once
+    void DrawRowSpan( int y, int x0, int x1, float fDepth, const olc::Pixel *pPixels, const float *pShadeDists = nullptr );
+
+    // With the shade buffer enabled, each pixel that is drawn also gets a shade distance: the distance that the pixel must be
+    // shaded with by a deferred shading pass, or 0.0f if it was drawn shaded already (that's the default for all draw functions).
+    // The shade buffer is released by Init(), and it's set to 0.0f where the depth buffer is reset.
+    void EnableShadeBuffer( bool bEnable );
+    bool HasShadeBuffer();
+    // returns a pointer to row y of the shade buffer (nullptr if it's not enabled)
+    float *GetShadeRow( int y );
+
+    // returns a pointer to row y of the depth buffer, for passes that work through a screen row themselves
+    const float *GetDepthRow( int y );
+
+    // sets all pixels of the depth buffer to absolute max depth value
+    void Reset();
+    void Reset( int nSlice, int nLowY, int nHghY );
+
+    // copies the depth buffer of rSrc (which must have the same size) - either all of it, or only slice nSlice
+    void CopyFrom( RC_DepthDrawer &rSrc );
+    void CopyFrom( RC_DepthDrawer &rSrc, int nSlice );
+
+    bool IsMasked( int x, int y, float fDepth );
+
+private:
+    // clips the span y0 - y1 of column x against the screen. Returns false if nothing is left, otherwise nOffset is set to the
+    // nr of rows that were clipped off at the top
+    bool ClipColumnSpan( int x, int &y0, int &y1, int &nOffset );
+    // sets the shade distances of the pixels of a (clipped) column span that passed the depth test
+    void SetShadeColumn( int x, int y0, int y1, const float *pDepths, int nDepthStep, const float *pShadeDists );
+};
+
+
+#endif // RC_DEPTHDRAWER_H
@@ -1,337 +1,712 @@
-#include "RC_Map.h"
-
-// =========/  functions/methods for class RC_Map  /==============================
-
-RC_Map::RC_Map() {}
-
-RC_Map::~RC_Map() {}
-
-// First initialize the map calling this method ...
-void RC_Map::InitMap(
-    int nID,
-    std::vector<PortalDescriptor> &vPortDescs,
-    olc::Sprite *floorTxtr,
-    olc::Pixel skyCol
-) {
-/* Additional checks to build in:
- *   1. consistency of map ID with location in map vector
- */
-    nMapID          = nID;
-    vPDs            = vPortDescs;
-    pFloorSpritePtr = floorTxtr;
-    SkyColour       = skyCol;
-
-    nMapX = nMapY = nMapZ = -1;
-}
-
-// ... then add at least 1 layer to it using this method
-void RC_Map::AddLayer(
-    std::vector<std::string> &sUserMap,
-    std::vector<olc::Sprite *> &vWallTextures,
-    std::vector<olc::Sprite *> &vCeilTextures,
-    std::vector<olc::Sprite *> &vRoofTextures
-) {
-    // for the first layer (with index 0) these values will be set and can be used for error checking
-    if (nMapX == -1) { nMapX = (sUserMap.empty() ? 0 : (int)sUserMap[0].length()); }
-    if (nMapY == -1) { nMapY = (int)sUserMap.size(); }
-
-    // grab layer nr to add
-    int nCurLevel = (int)bMaps.size();
-    // prepare a container of map cells for this additional layer, as well as an auxiliary map cell pointer
-    std::vector<RC_MapCell *> vLevelMapCells;
-    RC_MapCell *pMapCellPtr = nullptr;
-
-    // check if map passed is empty
-    if (sUserMap.empty()) {
-        std::cout << "ERROR: AddLayer() --> user map is empty..." << std::endl;
-    } else {
-        // check if consistent on x dimension
-        for (int i = 0; i < (int)sUserMap.size(); i++) {
-            if ((int)sUserMap[i].length() != nMapX) {
-                std::cout << "ERROR: AddLayer() --> mismatch in line " << i << " between nMapX = " << nMapX << " and dimensions of sUserMap = " << (int)sUserMap[i].length() << std::endl;
-            }
-        }
-        // check if consistent on y dimension
-        if ((int)sUserMap.size() != nMapY) {
-            std::cout << "ERROR: AddLayer() --> mismatch between nMapY = " << nMapY << " and dimensions of sUserMap = " << (int)sUserMap.size() << std::endl;
-        }
-    }
-
-    for (int y = 0; y < nMapY; y++) {
-        for (int x = 0; x < nMapX; x++) {
-
-            // get the character from the input map, and use it to obtain the map cell info from the blueprint library
-            char cTileID = sUserMap[ y ][ x ];
-            MapCellBluePrint &refMapCell = GetMapCellBluePrint( cTileID );
-
-            // distinguish following cases: 1. empty map cell, 2. dynamic 3. regular (textured)
-            if (refMapCell.bEmpty) {
-                // create a new map cell...
-                pMapCellPtr = new RC_MapCell;
-                pMapCellPtr->Init( x, y, nCurLevel );
-                // ... and set it to empty
-                pMapCellPtr->SetEmpty( true );
-            } else {
-
-                // map cell is not empty: do additional stuff for dynamic map cells
-                if (refMapCell.bDynamic) {
-                    // create a dynamic map cell
-                    RC_MapCellDynamic *aux = new RC_MapCellDynamic;
-                    // initialise the dynamic map cell
-                    aux->Init( x, y, nCurLevel );
-
-                    pMapCellPtr = aux;
-                } else {
-                    // if its not a dynamic cell, it's a regular (textured) map cell
-                    pMapCellPtr = new RC_MapCell;
-                    pMapCellPtr->Init( x, y, nCurLevel );
-                }
-                // either way it is not empty
-                pMapCellPtr->SetEmpty( false );
-
-                // since this block is not empty, we need to fill all the faces for it
-                for (int i = 0; i < FACE_NR_OF; i++) {
-                    // use the index from the refMapCell to grab a reference to the face blueprint for this face index (i)
-                    int nFaceBPIx = refMapCell.nFaces[i];
-                    FaceBluePrint &refFace = vFaceBluePrintLib[ nFaceBPIx ];
-
-                    // prepare a new sprite pointer value
-                    olc::Sprite *auxSpritePtr = nullptr;
-                    switch ( refFace.nFaceType ) {
-                        case TYPE_FACE_WALL: auxSpritePtr = vWallTextures[ refFace.nFaceIndex ]; break;
-                        case TYPE_FACE_CEIL: auxSpritePtr = vCeilTextures[ refFace.nFaceIndex ]; break;
-                        case TYPE_FACE_ROOF: auxSpritePtr = vRoofTextures[ refFace.nFaceIndex ]; break;
-                        default: std::cout << "ERROR: AddLayer() --> face type unknown: " << refFace.nFaceType << std::endl;
-                    }
-                    // if this face is an animated type face, we need to create a different type RC_Face for it
-                    if (refFace.bAnimated) {
-                        RC_FaceAnimated *pFacePtr = new RC_FaceAnimated;
-                        pFacePtr->Init( i, auxSpritePtr, refFace.bTransparent, ANIM_STATE_CLOSED, 32, 32 );
-                        pMapCellPtr->SetFacePtr( i, pFacePtr );
-                    } else if (refFace.bPortal) {
-                        RC_FacePortal *pFacePtr = new RC_FacePortal;
-                        // get a reference to the portal descriptor for this location in the map
-                        PortalDescriptor &rPD = GetPortalDescriptor( nCurLevel, x, y );
-                        // add portal info to this face, besides the regular info (face index and sprite ptr)
-                        pFacePtr->Init(
-                            i,
-                            auxSpritePtr,
-                            nMapID, nCurLevel, x, y,
-                            rPD.nMapExit, rPD.nLevelExit, rPD.nTileExitX, rPD.nTileExitY,
-                            rPD.fExitAngle_deg
-                        );
-                        pMapCellPtr->SetFacePtr( i, pFacePtr );
-                    } else {
-                        RC_Face *pFacePtr = new RC_Face;
-                        pFacePtr->Init( i, auxSpritePtr, refFace.bTransparent );
-                        pMapCellPtr->SetFacePtr( i, pFacePtr );
-                    }
-                }
-            }
-            // Finally, put the basic info into the new map cell
-            pMapCellPtr->SetID( refMapCell.cID );
-            pMapCellPtr->SetHeight( refMapCell.fHeight );
-            pMapCellPtr->SetPermeable( refMapCell.bPermeable );
-
-            // Having set up the map cell, add it to this map layer
-            vLevelMapCells.push_back( pMapCellPtr );
-        }
-    }
-
-    // after assembly integrity check
-    //   * check whether all map cell pointers have a value and a map cell object associated,
-    //   * if the map cell object is not empty, check that there are 6 face objects associated with the map cell
-    for (int y = 0; y < nMapY; y++) {
-        for (int x = 0; x < nMapX; x++) {
-            RC_MapCell *aux = vLevelMapCells[ y * nMapX + x ];
-            if (aux == nullptr) {
-                std::cout << "ERROR: AddLayer() --> nullptr map cell ptr encountered at ( " << x << ", " << y << ", " << nMapZ << ")" << std::endl;
-            } else {
-                if (aux->IsEmpty()) {
-                    for (int i = 0; i < FACE_NR_OF; i++) {
-                    	// map cell is empty: all face pointers should equal nullptr
-                        if (aux->GetFacePtr_raw( i ) != nullptr) {
-                            std::cout << "ERROR: AddLayer() --> empty map cell at ( " << x << ", " << y << ", " << nMapZ << ") contains non-nullptr face pointer for face " << i << std::endl;
-                        }
-                    }
-            	} else {
-                    for (int i = 0; i < FACE_NR_OF; i++) {
-                    	// map cell is not empty: all face pointers should NOT equal nullptr
-                        if (aux->GetFacePtr( i ) == nullptr) {
-                            std::cout << "ERROR: AddLayer() --> nullptr face pointer encountered for face " << i << " at non-empty map cell ( " << x << ", " << y << ", " << nMapZ << ")" << std::endl;
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    // having set up the complete map layer, add the layer to the map
-    bMaps.push_back( vLevelMapCells );
-    nMapZ = (int)bMaps.size();
-}
-
-// method to clean up the object before it gets out of scope
-void RC_Map::FinalizeMap() {
-
-    for (auto &elt : bMaps ) {
-        for (auto &elt2 : elt) {
-            delete elt2;
-        }
-        elt.clear();
-    }
-
-    bMaps.clear();
-}
-
-// getters for map ID, width and height
-int RC_Map::GetID() {     return nMapID; }
-int RC_Map::GetWidth() {  return nMapX;  }
-int RC_Map::GetHeight() { return nMapY;  }
-
-// returns current number of layers in this map object - use fMaps as representative model
-int RC_Map::NrOfLayers() {
-    return (int)bMaps.size();
-}
-
-// returns the diagonal length of the map (2D) - useful for setting max distance value
-float RC_Map::DiagonalLength() {
-    return sqrt( nMapX * nMapX + nMapY * nMapY );
-}
-
-// returns the diagonal length of the map (3D)
-float RC_Map::DiagonalLength3D() {
-    return sqrt( nMapX * nMapX + nMapY * nMapY + nMapZ * nMapZ );
-}
-
-// returns whether (x, y) is within map boundaries
-bool RC_Map::IsInBounds( float x, float y ) {
-    return (x >= 0 && x < nMapX && y >= 0 && y < nMapY);
-}
-
-// returns whether (x, y, z) is within map boundaries
-bool RC_Map::IsInBounds( float x, float y, float z ) {
-    return IsInBounds( x, y ) && (z >= 0 && z < nMapZ);
-}
-
-// getter for (cumulated) cell height at coordinates (x, y)
-// Note - there's no intuitive meaning for this method in maps with holes
-float RC_Map::CellHeight( int x, int y ) {
-    float result = 0.0f;
-    if (!IsInBounds( x, y )) {
-        std::cout << "ERROR: RC_Map::CellHeight() --> map indices out of bounds: (" << x << ", " << y << ")" << std::endl;
-        result = -1.0f;
-    } else {
-        for (int i = 0; i < (int)bMaps.size(); i++) {
-            result += bMaps[i][y * nMapX + x]->GetHeight();
-        }
-    }
-    return result;
-}
-
-// getter for obtaining height value of the cell at layer, coordinates (x, y)
-float RC_Map::CellHeightAt( int x, int y, int layer ) {
-    float result = -1.0f;
-    if (!IsInBounds( x, y, layer )) {
-        std::cout << "ERROR: RC_Map::CellHeightAt() --> map indices out of bounds: (" << x << ", " << y << ", " << layer << ")" << std::endl;
-    } else {
-        result = bMaps[layer][y * nMapX + x]->GetHeight();
-    }
-    return result;
-}
-
-// getter for obtaining the character value of the cell at layer, coordinates (x, y)
-char RC_Map::CellValueAt( int x, int y, int layer ) {
-    char result = ' ';
-    if (!IsInBounds( x, y, layer )) {
-        std::cout << "ERROR: RC_Map::CellValueAt() --> map indices out of bounds: (" << x << ", " << y << ", " << layer << ")" << std::endl;
-    } else {
-        result = bMaps[layer][y * nMapX + x]->GetID();
-    }
-    return result;
-}
-
-// getter for obtaining the pointer to the associated block (can return nullptr) of the cell at layer, coordinates (x, y)
-RC_MapCell *RC_Map::MapCellPtrAt( int x, int y, int layer ) {
-    RC_MapCell *result = nullptr;
-    if (!IsInBounds( x, y, layer )) {
-        std::cout << "ERROR: RC_Map::MapCellPtrAt() --> map indices out of bounds: (" << x << ", " << y << ", " << layer << ")" << std::endl;
-        std::cout << "Map ID = " << nMapID << ", size X = " << nMapX << ", size Y = " << nMapY << ", size Z = " << nMapZ << std::endl;
-    } else {
-        result = bMaps[ layer ][y * nMapX + x];
-        // build in error check here, so you don't have to check afterwards
-        if (result == nullptr) {
-            std::cout << "FATAL: RC_Map::MapCellPtrAt() --> nullptr result at: ("  << x << ", " << y << "),  layer: " << layer << std::endl;
-        }
-    }
-    return result;
-}
-
-// collision detection on the map:
-// Note that int( fH ) denotes layer to check, and (fH - int( fH )) denotes height to check within that layer
-// and fR is the radius of the object (considered as a pillar shape)
-bool RC_Map::Collides( float fX, float fY, float fH, float fR, float fVX, float fVY ) {
-
-    bool bResult;
-
-    float fOffsetX;
-    float fOffsetY;
-    if (fVX == 0.0f) { fOffsetX = 0.0f; } else { fOffsetX = (fVX < 0.0f ? -fR : fR); }
-    if (fVY == 0.0f) { fOffsetY = 0.0f; } else { fOffsetY = (fVY < 0.0f ? -fR : fR); }
-
-    if (!IsInBounds( fX + fOffsetX, fY + fOffsetY ) || (fH - fR) < 0.0f) {
-        bResult = true;
-    } else if (fH > NrOfLayers()) {
-        bResult = false;
-    } else  {
-        bResult = (
-            CellHeightAt( int( fX + fOffsetX ), int( fY + fOffsetY ), int( fH )) >= (fH - int( fH )) &&
-            !MapCellPtrAt( int( fX + fOffsetX ), int( fY + fOffsetY ), int( fH ))->IsPermeable()
-        );
-    }
-    return bResult;
-}
-
-void RC_Map::SetFloorSpritePtr( olc::Sprite *pSpritePtr ) {
-    pFloorSpritePtr = pSpritePtr;
-}
-
-olc::Sprite *RC_Map::GetFloorSpritePtr() {
-    return pFloorSpritePtr;
-}
-
-void RC_Map::SetSkyColour( olc::Pixel col ) {
-    SkyColour = col;
-}
-
-olc::Pixel RC_Map::GetSkyColour() {
-    return SkyColour;
-}
-
-// searches the portal descriptor for this RC_Map that is identified by the combination of (nL, nX, nY)
-// returns a reference to it.
-PortalDescriptor &RC_Map::GetPortalDescriptor( int nL, int nX, int nY ) {
-
-    int nPDindex = -1;
-    for (int i = 0; i < (int)vPDs.size() && (nPDindex == -1); i++) {
-        PortalDescriptor &aux = vPDs[i];
-        if (aux.nMapEntry != nMapID) {
-            std::cout << "ERROR: RC_Map::GetPortalDescriptor() --> encountered mismatch between this map ID: " << nMapID << " and reference map id: " << aux.nMapEntry << std::endl;
-        } else {
-            if (aux.nLevelEntry == nL && aux.nTileEntryX == nX && aux.nTileEntryY == nY) {
-                nPDindex = i;
-            }
-        }
-    }
-
-    // check on errors
-    if (nPDindex == -1) {
-        std::cout << "ERROR: RC_Map::GetPortalDescriptor() --> couldn't find descriptor for map ID: " << nMapID << ", layer: " << nL << ", tile: (" << nX << ", " << nY << "). ";
-        std::cout << "using first available portal (index 0) " << std::endl;
-        nPDindex = 0;
-    }
-
-    return vPDs[ nPDindex ];
-}
-
-// ==============================/  end of file   /==============================
+#include "RC_Map.h"
+
+// =========/  functions/methods for class RC_Map  /==============================
+
+RC_Map::RC_Map() {}
+
+RC_Map::~RC_Map() {}
+
+// First initialize the map calling this method ...
+void RC_Map::InitMap(
+    int nID,
+    std::vector<PortalDescriptor> &vPortDescs,
+    olc::Sprite *floorTxtr,
+    olc::Pixel skyCol,
+    float fDrawDist,
+    olc::Pixel fogCol
+) {
+/* Additional checks to build in:
+ *   1. consistency of map ID with location in map vector
+ */
+    nMapID          = nID;
+    vPDs            = vPortDescs;
+    pFloorSpritePtr = floorTxtr;
+    SkyColour       = skyCol;
+    fDrawDistance   = fDrawDist;
+    FogColour       = fogCol;
+
+    nMapX = nMapY = nMapZ = -1;
+}
+
+// ... then add at least 1 layer to it using this method
+void RC_Map::AddLayer(
+    std::vector<std::string> &sUserMap,
+    std::vector<olc::Sprite *> &vWallTextures,
+    std::vector<olc::Sprite *> &vCeilTextures,
+    std::vector<olc::Sprite *> &vRoofTextures
+) {
+    // check the map size against the range of the tile coordinates in the DDA
+    int nUserMapX = (sUserMap.empty() ? 0 : (int)sUserMap[0].length());
+    int nUserMapY = (int)sUserMap.size();
+    if (nUserMapX > MAP_MAX_SIZE || nUserMapY > MAP_MAX_SIZE) {
+        std::cout << "ERROR: AddLayer() --> map size " << nUserMapX << " x " << nUserMapY << " exceeds max. map size " << MAP_MAX_SIZE << " x " << MAP_MAX_SIZE << ", layer is not added" << std::endl;
+        return;
+    }
+    // for the first layer (with index 0) these values will be set and can be used for error checking
+    if (nMapX == -1) { nMapX = (sUserMap.empty() ? 0 : (int)sUserMap[0].length()); }
+    if (nMapY == -1) { nMapY = (int)sUserMap.size(); }
+
+    // grab layer nr to add
+    int nCurLevel = (int)bMaps.size();
+    // prepare a container of map cells for this additional layer
+    std::vector<RC_MapCell *> vLevelMapCells;
+    // keep the textures, to be able to create map cells afterwards (see ReplaceMapCellAt())
+    vWallTxtrs = vWallTextures;
+    vCeilTxtrs = vCeilTextures;
+    vRoofTxtrs = vRoofTextures;
+
+    // check if map passed is empty
+    if (sUserMap.empty()) {
+        std::cout << "ERROR: AddLayer() --> user map is empty..." << std::endl;
+    } else {
+        // check if consistent on x dimension
+        for (int i = 0; i < (int)sUserMap.size(); i++) {
+            if ((int)sUserMap[i].length() != nMapX) {
+                std::cout << "ERROR: AddLayer() --> mismatch in line " << i << " between nMapX = " << nMapX << " and dimensions of sUserMap = " << (int)sUserMap[i].length() << std::endl;
+            }
+        }
+        // check if consistent on y dimension
+        if ((int)sUserMap.size() != nMapY) {
+            std::cout << "ERROR: AddLayer() --> mismatch between nMapY = " << nMapY << " and dimensions of sUserMap = " << (int)sUserMap.size() << std::endl;
+        }
+    }
+
+    for (int y = 0; y < nMapY; y++) {
+        for (int x = 0; x < nMapX; x++) {
+            // create the map cell from the character in the input map, and add it to this map layer
+            vLevelMapCells.push_back( CreateMapCell( sUserMap[ y ][ x ], x, y, nCurLevel ));
+        }
+    }
+
+    // after assembly integrity check
+    //   * check whether all map cell pointers have a value and a map cell object associated,
+    //   * if the map cell object is not empty, check that there are 6 face objects associated with the map cell
+    for (int y = 0; y < nMapY; y++) {
+        for (int x = 0; x < nMapX; x++) {
+            RC_MapCell *aux = vLevelMapCells[ y * nMapX + x ];
+            if (aux == nullptr) {
+                std::cout << "ERROR: AddLayer() --> nullptr map cell ptr encountered at ( " << x << ", " << y << ", " << nMapZ << ")" << std::endl;
+            } else {
+                if (aux->IsEmpty()) {
+                    for (int i = 0; i < FACE_NR_OF; i++) {
+                    	// map cell is empty: all face pointers should equal nullptr
+                        if (aux->GetFacePtr_raw( i ) != nullptr) {
+                            std::cout << "ERROR: AddLayer() --> empty map cell at ( " << x << ", " << y << ", " << nMapZ << ") contains non-nullptr face pointer for face " << i << std::endl;
+                        }
+                    }
+            	} else {
+                    for (int i = 0; i < FACE_NR_OF; i++) {
+                    	// map cell is not empty: all face pointers should NOT equal nullptr
+                        if (aux->GetFacePtr( i ) == nullptr) {
+                            std::cout << "ERROR: AddLayer() --> nullptr face pointer encountered for face " << i << " at non-empty map cell ( " << x << ", " << y << ", " << nMapZ << ")" << std::endl;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // having set up the complete map layer, add the layer to the map
+    bMaps.push_back( vLevelMapCells );
+    nMapZ = (int)bMaps.size();
+
+    // the nr of layers has changed, so rebuild the height columns
+    vHeightColumns.resize( nMapX * nMapY * nMapZ );
+    for (int y = 0; y < nMapY; y++) {
+        for (int x = 0; x < nMapX; x++) {
+            for (int z = 0; z < nMapZ; z++) {
+                vHeightColumns[ (y * nMapX + x) * nMapZ + z ] = bMaps[z][y * nMapX + x]->GetHeight();
+            }
+        }
+    }
+    // and the distance fields, occupancy pyramid and boundary masks as well
+    InitDistFields();
+    InitOccPyramid();
+    InitBoundaryMasks();
+}
+
+// creates a map cell at (x, y, layer) from the blueprint with ID cTileID, using the textures that were passed to AddLayer()
+RC_MapCell *RC_Map::CreateMapCell( char cTileID, int x, int y, int layer ) {
+    RC_MapCell *pMapCellPtr = nullptr;
+
+    // use the character to obtain the map cell info from the blueprint library
+    MapCellBluePrint &refMapCell = GetMapCellBluePrint( cTileID );
+
+    // distinguish following cases: 1. empty map cell, 2. dynamic 3. regular (textured)
+    if (refMapCell.bEmpty) {
+        // create a new map cell...
+        pMapCellPtr = new RC_MapCell;
+        pMapCellPtr->Init( x, y, layer );
+        // ... and set it to empty
+        pMapCellPtr->SetEmpty( true );
+    } else {
+
+        // map cell is not empty: do additional stuff for dynamic map cells
+        if (refMapCell.bDynamic) {
+            // create a dynamic map cell
+            RC_MapCellDynamic *aux = new RC_MapCellDynamic;
+            // initialise the dynamic map cell
+            aux->Init( x, y, layer );
+
+            pMapCellPtr = aux;
+        } else {
+            // if its not a dynamic cell, it's a regular (textured) map cell
+            pMapCellPtr = new RC_MapCell;
+            pMapCellPtr->Init( x, y, layer );
+        }
+        // either way it is not empty
+        pMapCellPtr->SetEmpty( false );
+
+        // since this block is not empty, we need to fill all the faces for it
+        for (int i = 0; i < FACE_NR_OF; i++) {
+            // use the index from the refMapCell to grab a reference to the face blueprint for this face index (i)
+            int nFaceBPIx = refMapCell.nFaces[i];
+            FaceBluePrint &refFace = vFaceBluePrintLib[ nFaceBPIx ];
+
+            // prepare a new sprite pointer value
+            olc::Sprite *auxSpritePtr = nullptr;
+            switch ( refFace.nFaceType ) {
+                case TYPE_FACE_WALL: auxSpritePtr = vWallTxtrs[ refFace.nFaceIndex ]; break;
+                case TYPE_FACE_CEIL: auxSpritePtr = vCeilTxtrs[ refFace.nFaceIndex ]; break;
+                case TYPE_FACE_ROOF: auxSpritePtr = vRoofTxtrs[ refFace.nFaceIndex ]; break;
+                default: std::cout << "ERROR: CreateMapCell() --> face type unknown: " << refFace.nFaceType << std::endl;
+            }
+            // if this face is an animated type face, we need to create a different type RC_Face for it
+            if (refFace.bAnimated) {
+                RC_FaceAnimated *pFacePtr = new RC_FaceAnimated;
+                pFacePtr->Init( i, auxSpritePtr, refFace.bTransparent, ANIM_STATE_CLOSED, 32, 32 );
+                pMapCellPtr->SetFacePtr( i, pFacePtr );
+            } else if (refFace.bPortal) {
+                RC_FacePortal *pFacePtr = new RC_FacePortal;
+                // get a reference to the portal descriptor for this location in the map
+                PortalDescriptor &rPD = GetPortalDescriptor( layer, x, y );
+                // add portal info to this face, besides the regular info (face index and sprite ptr)
+                pFacePtr->Init(
+                    i,
+                    auxSpritePtr,
+                    nMapID, layer, x, y,
+                    rPD.nMapExit, rPD.nLevelExit, rPD.nTileExitX, rPD.nTileExitY,
+                    rPD.fExitAngle_deg
+                );
+                pMapCellPtr->SetFacePtr( i, pFacePtr );
+            } else {
+                RC_Face *pFacePtr = new RC_Face;
+                pFacePtr->Init( i, auxSpritePtr, refFace.bTransparent );
+                pMapCellPtr->SetFacePtr( i, pFacePtr );
+            }
+        }
+    }
+    // Finally, put the basic info into the new map cell
+    pMapCellPtr->SetID( refMapCell.cID );
+    pMapCellPtr->SetHeight( refMapCell.fHeight );
+    pMapCellPtr->SetPermeable( refMapCell.bPermeable );
+
+    return pMapCellPtr;
+}
+
+// method to clean up the object before it gets out of scope
+void RC_Map::FinalizeMap() {
+
+    for (auto &elt : bMaps ) {
+        for (auto &elt2 : elt) {
+            delete elt2;
+        }
+        elt.clear();
+    }
+
+    bMaps.clear();
+    vHeightColumns.clear();
+    vDistFields.clear();
+    vDistFieldAll.clear();
+    vOccPyramid.clear();
+    vBoundaryColumns.clear();
+    vChangeLog.clear();
+    nChangeCount = 0;
+}
+
+// getters for map ID, width and height
+int RC_Map::GetID() {     return nMapID; }
+int RC_Map::GetWidth() {  return nMapX;  }
+int RC_Map::GetHeight() { return nMapY;  }
+
+// returns current number of layers in this map object - use fMaps as representative model
+int RC_Map::NrOfLayers() {
+    return (int)bMaps.size();
+}
+
+// returns the diagonal length of the map (2D) - useful for setting max distance value
+float RC_Map::DiagonalLength() {
+    return sqrt( nMapX * nMapX + nMapY * nMapY );
+}
+
+// returns the diagonal length of the map (3D)
+float RC_Map::DiagonalLength3D() {
+    return sqrt( nMapX * nMapX + nMapY * nMapY + nMapZ * nMapZ );
+}
+
+// returns whether (x, y) is within map boundaries
+bool RC_Map::IsInBounds( float x, float y ) {
+    return (x >= 0 && x < nMapX && y >= 0 && y < nMapY);
+}
+
+// returns whether (x, y, z) is within map boundaries
+bool RC_Map::IsInBounds( float x, float y, float z ) {
+    return IsInBounds( x, y ) && (z >= 0 && z < nMapZ);
+}
+
+// getter for (cumulated) cell height at coordinates (x, y)
+// Note - there's no intuitive meaning for this method in maps with holes
+float RC_Map::CellHeight( int x, int y ) {
+    float result = 0.0f;
+    if (!IsInBounds( x, y )) {
+        std::cout << "ERROR: RC_Map::CellHeight() --> map indices out of bounds: (" << x << ", " << y << ")" << std::endl;
+        result = -1.0f;
+    } else {
+        for (int i = 0; i < (int)bMaps.size(); i++) {
+            result += bMaps[i][y * nMapX + x]->GetHeight();
+        }
+    }
+    return result;
+}
+
+// getter for obtaining height value of the cell at layer, coordinates (x, y)
+float RC_Map::CellHeightAt( int x, int y, int layer ) {
+    float result = -1.0f;
+    if (!IsInBounds( x, y, layer )) {
+        std::cout << "ERROR: RC_Map::CellHeightAt() --> map indices out of bounds: (" << x << ", " << y << ", " << layer << ")" << std::endl;
+    } else {
+        result = bMaps[layer][y * nMapX + x]->GetHeight();
+    }
+    return result;
+}
+
+// getter for obtaining the character value of the cell at layer, coordinates (x, y)
+char RC_Map::CellValueAt( int x, int y, int layer ) {
+    char result = ' ';
+    if (!IsInBounds( x, y, layer )) {
+        std::cout << "ERROR: RC_Map::CellValueAt() --> map indices out of bounds: (" << x << ", " << y << ", " << layer << ")" << std::endl;
+    } else {
+        result = bMaps[layer][y * nMapX + x]->GetID();
+    }
+    return result;
+}
+
+// getter for obtaining the pointer to the associated block (can return nullptr) of the cell at layer, coordinates (x, y)
+RC_MapCell *RC_Map::MapCellPtrAt( int x, int y, int layer ) {
+    RC_MapCell *result = nullptr;
+    if (!IsInBounds( x, y, layer )) {
+        std::cout << "ERROR: RC_Map::MapCellPtrAt() --> map indices out of bounds: (" << x << ", " << y << ", " << layer << ")" << std::endl;
+        std::cout << "Map ID = " << nMapID << ", size X = " << nMapX << ", size Y = " << nMapY << ", size Z = " << nMapZ << std::endl;
+    } else {
+        result = bMaps[ layer ][y * nMapX + x];
+        // build in error check here, so you don't have to check afterwards
+        if (result == nullptr) {
+            std::cout << "FATAL: RC_Map::MapCellPtrAt() --> nullptr result at: ("  << x << ", " << y << "),  layer: " << layer << std::endl;
+        }
+    }
+    return result;
+}
+
+// returns a pointer to the column of NrOfLayers() cell heights at coordinates (x, y), indexed by layer
+// NOTE: no bounds checking here (it's meant for the DDA inner loop) - caller must check using IsInBounds()
+float *RC_Map::HeightColumnAt( int x, int y ) {
+    return &vHeightColumns[ (y * nMapX + x) * nMapZ ];
+}
+
+// must be called if the height of the map cell at (x, y, layer) has changed (for instance for dynamic map cells),
+// to keep the height columns in sync with the map cell objects
+void RC_Map::SyncCellHeight( int x, int y, int layer ) {
+    if (!IsInBounds( x, y, layer )) {
+        std::cout << "ERROR: RC_Map::SyncCellHeight() --> map indices out of bounds: (" << x << ", " << y << ", " << layer << ")" << std::endl;
+    } else {
+        // cache occupancy before the change, to see if the distance fields must be updated
+        bool bWasOccupied    = IsOccupied( x, y, layer );
+        bool bWasOccupiedAll = IsOccupied( x, y, -1    );
+
+        vHeightColumns[ (y * nMapX + x) * nMapZ + layer ] = bMaps[layer][y * nMapX + x]->GetHeight();
+        // keep track of the change in the change log
+        vChangeLog.resize( CHANGE_LOG_SIZE );
+        vChangeLog[ nChangeCount % CHANGE_LOG_SIZE ] = y * nMapX + x;
+        nChangeCount += 1;
+
+        // only a transition between empty and non-empty affects the distance fields
+        bool bIsOccupied    = IsOccupied( x, y, layer );
+        bool bIsOccupiedAll = IsOccupied( x, y, -1    );
+        if (bIsOccupied    != bWasOccupied   ) { UpdateDistField( x, y, layer, bIsOccupied    ); UpdateOccPyramid( x, y, layer, bIsOccupied    ); }
+        if (bIsOccupiedAll != bWasOccupiedAll) { UpdateDistField( x, y, -1   , bIsOccupiedAll ); UpdateOccPyramid( x, y, -1   , bIsOccupiedAll ); }
+    }
+}
+
+// replaces the map cell at (x, y, layer) by pMapCell (the old map cell object is deleted), and keeps the height columns
+// and distance fields in sync
+void RC_Map::ReplaceMapCellAt( int x, int y, int layer, RC_MapCell *pMapCell ) {
+    if (!IsInBounds( x, y, layer )) {
+        std::cout << "ERROR: RC_Map::ReplaceMapCellAt() --> map indices out of bounds: (" << x << ", " << y << ", " << layer << ")" << std::endl;
+    } else if (pMapCell == nullptr) {
+        std::cout << "ERROR: RC_Map::ReplaceMapCellAt() --> nullptr map cell passed for: (" << x << ", " << y << ", " << layer << ")" << std::endl;
+    } else {
+        delete bMaps[layer][y * nMapX + x];
+        pMapCell->Init( x, y, layer );
+        bMaps[layer][y * nMapX + x] = pMapCell;
+        SyncCellHeight( x, y, layer );
+        // the boundary masks of this cell and its four neighbours are affected
+        int vNbX[5] = { x, x + 1, x - 1, x    , x     };
+        int vNbY[5] = { y, y    , y    , y + 1, y - 1 };
+        for (int i = 0; i < 5; i++) {
+            if (IsInBounds( vNbX[i], vNbY[i] )) {
+                BoundaryColumnAt( vNbX[i], vNbY[i] )[ layer ] = CalcBoundaryMask( vNbX[i], vNbY[i], layer );
+            }
+        }
+    }
+}
+
+void RC_Map::ReplaceMapCellAt( int x, int y, int layer, char cTileID ) {
+    if (!IsInBounds( x, y, layer )) {
+        std::cout << "ERROR: RC_Map::ReplaceMapCellAt() --> map indices out of bounds: (" << x << ", " << y << ", " << layer << ")" << std::endl;
+    } else {
+        ReplaceMapCellAt( x, y, layer, CreateMapCell( cTileID, x, y, layer ));
+    }
+}
+
+int RC_Map::DistFieldAt( int x, int y, int layer ) { return vDistFields[ layer ][ y * nMapX + x ]; }
+int RC_Map::DistFieldAllAt( int x, int y ) {         return vDistFieldAll[      y * nMapX + x ]; }
+
+// returns the highest pyramid level for which the block containing (x, y) is completely empty in layer (or in all layers
+// if layer == -1), or 0 if there's no such level
+// NOTE: no bounds checking here (it's meant for the DDA inner loop) - caller must check using IsInBounds()
+int RC_Map::EmptyBlockLevel( int x, int y, int layer ) {
+    for (int nLevel = OCC_PYRAMID_LEVELS; nLevel > 0; nLevel--) {
+        int nShift = OCC_BLOCK_SHIFT( nLevel );
+        int nBlocksX = ((nMapX - 1) >> nShift) + 1;
+        if (OccBlocks( nLevel, layer )[ (y >> nShift) * nBlocksX + (x >> nShift) ] == 0) {
+            return nLevel;
+        }
+    }
+    return 0;
+}
+
+int RC_Map::GetChangeCount() { return nChangeCount; }
+
+// puts the cells (as y * nMapX + x) that changed height after nSinceCount in vCells. Returns false if the change log
+// doesn't reach back that far
+bool RC_Map::GetChangedCells( int nSinceCount, std::vector<int> &vCells ) {
+    vCells.clear();
+    if (nSinceCount < nChangeCount - CHANGE_LOG_SIZE || nSinceCount > nChangeCount) {
+        return false;
+    }
+    for (int i = nSinceCount; i < nChangeCount; i++) {
+        vCells.push_back( vChangeLog[ i % CHANGE_LOG_SIZE ] );
+    }
+    return true;
+}
+
+// returns a pointer to the column of NrOfLayers() boundary masks at coordinates (x, y), indexed by layer
+// NOTE: no bounds checking here (it's meant for the DDA inner loop) - caller must check using IsInBounds()
+uint8_t *RC_Map::BoundaryColumnAt( int x, int y ) {
+    return &vBoundaryColumns[ (y * nMapX + x) * nMapZ ];
+}
+
+// collision detection on the map:
+// Note that int( fH ) denotes layer to check, and (fH - int( fH )) denotes height to check within that layer
+// and fR is the radius of the object (considered as a pillar shape)
+bool RC_Map::Collides( float fX, float fY, float fH, float fR, float fVX, float fVY ) {
+
+    bool bResult;
+
+    float fOffsetX;
+    float fOffsetY;
+    if (fVX == 0.0f) { fOffsetX = 0.0f; } else { fOffsetX = (fVX < 0.0f ? -fR : fR); }
+    if (fVY == 0.0f) { fOffsetY = 0.0f; } else { fOffsetY = (fVY < 0.0f ? -fR : fR); }
+
+    if (!IsInBounds( fX + fOffsetX, fY + fOffsetY ) || (fH - fR) < 0.0f) {
+        bResult = true;
+    } else if (fH > NrOfLayers()) {
+        bResult = false;
+    } else  {
+        bResult = (
+            CellHeightAt( int( fX + fOffsetX ), int( fY + fOffsetY ), int( fH )) >= (fH - int( fH )) &&
+            !MapCellPtrAt( int( fX + fOffsetX ), int( fY + fOffsetY ), int( fH ))->IsPermeable()
+        );
+    }
+    return bResult;
+}
+
+void RC_Map::SetFloorSpritePtr( olc::Sprite *pSpritePtr ) {
+    pFloorSpritePtr = pSpritePtr;
+}
+
+olc::Sprite *RC_Map::GetFloorSpritePtr() {
+    return pFloorSpritePtr;
+}
+
+void RC_Map::SetSkyColour( olc::Pixel col ) {
+    SkyColour = col;
+}
+
+olc::Pixel RC_Map::GetSkyColour() {
+    return SkyColour;
+}
+
+void RC_Map::SetDrawDistance( float fDist ) {
+    fDrawDistance = fDist;
+}
+
+float RC_Map::GetDrawDistance() {
+    return HasFog() ? fDrawDistance : DiagonalLength();
+}
+
+bool RC_Map::HasFog() {
+    return fDrawDistance > 0.0f;
+}
+
+void RC_Map::SetFogColour( olc::Pixel col ) {
+    FogColour = col;
+}
+
+olc::Pixel RC_Map::GetFogColour() {
+    return FogColour;
+}
+
+// searches the portal descriptor for this RC_Map that is identified by the combination of (nL, nX, nY)
+// returns a reference to it.
+PortalDescriptor &RC_Map::GetPortalDescriptor( int nL, int nX, int nY ) {
+
+    int nPDindex = -1;
+    for (int i = 0; i < (int)vPDs.size() && (nPDindex == -1); i++) {
+        PortalDescriptor &aux = vPDs[i];
+        if (aux.nMapEntry != nMapID) {
+            std::cout << "ERROR: RC_Map::GetPortalDescriptor() --> encountered mismatch between this map ID: " << nMapID << " and reference map id: " << aux.nMapEntry << std::endl;
+        } else {
+            if (aux.nLevelEntry == nL && aux.nTileEntryX == nX && aux.nTileEntryY == nY) {
+                nPDindex = i;
+            }
+        }
+    }
+
+    // check on errors
+    if (nPDindex == -1) {
+        std::cout << "ERROR: RC_Map::GetPortalDescriptor() --> couldn't find descriptor for map ID: " << nMapID << ", layer: " << nL << ", tile: (" << nX << ", " << nY << "). ";
+        std::cout << "using first available portal (index 0) " << std::endl;
+        nPDindex = 0;
+    }
+
+    return vPDs[ nPDindex ];
+}
+
+// =========/  distance field methods  /==============================
+
+// returns whether map cell (x, y) is non-empty in layer (or in any layer if layer == -1) - cells outside the map count as non-empty
+// NOTE: a cell counts as non-empty if its height > 0.0f, since the rendering skips cells with height 0.0f anyway
+bool RC_Map::IsOccupied( int x, int y, int layer ) {
+    bool bResult = true;
+    if (IsInBounds( x, y )) {
+        float *pHeightColumn = HeightColumnAt( x, y );
+        if (layer >= 0) {
+            bResult = pHeightColumn[ layer ] > 0.0f;
+        } else {
+            bResult = false;
+            for (int z = 0; z < nMapZ && !bResult; z++) {
+                bResult = pHeightColumn[ z ] > 0.0f;
+            }
+        }
+    }
+    return bResult;
+}
+
+// works out the distance field value for (x, y) from scratch, by searching rings of increasing radius around it
+int RC_Map::CalcDistField( int x, int y, int layer ) {
+    if (IsOccupied( x, y, layer )) return 0;
+    // the map boundary counts as non-empty, so the result can't exceed the distance to it
+    int nMaxRadius = std::min( DIST_FIELD_MAX, std::min( std::min( x + 1, nMapX - x ), std::min( y + 1, nMapY - y )));
+    for (int r = 1; r < nMaxRadius; r++) {
+        // check top and bottom row of the ring, then the left and right column
+        for (int i = x - r; i <= x + r; i++) {
+            if (IsOccupied( i, y - r, layer ) || IsOccupied( i, y + r, layer )) return r;
+        }
+        for (int j = y - r + 1; j <= y + r - 1; j++) {
+            if (IsOccupied( x - r, j, layer ) || IsOccupied( x + r, j, layer )) return r;
+        }
+    }
+    return nMaxRadius;
+}
+
+// (re)builds all distance fields for the whole map
+void RC_Map::InitDistFields() {
+    vDistFields.resize( nMapZ );
+    for (int z = 0; z < nMapZ; z++) {
+        InitDistField( z, vDistFields[z] );
+    }
+    InitDistField( -1, vDistFieldAll );
+}
+
+// builds the distance field for layer (or the combined one if layer == -1). Instead of calling CalcDistField() for every cell (which
+// gets expensive on large maps), the Chebyshev distances are propagated in two passes over the map: a forward pass using the
+// neighbours to the left and above, and a backward pass using the neighbours to the right and below. The result is the same.
+void RC_Map::InitDistField( int layer, std::vector<uint8_t> &vField ) {
+    vField.resize( nMapX * nMapY );
+
+    // lambda to get the distance value of a neighbour - the map boundary counts as non-empty
+    auto get_value = [&]( int x, int y ) -> int {
+        return IsInBounds( x, y ) ? vField[ y * nMapX + x ] : 0;
+    };
+    // forward pass
+    for (int y = 0; y < nMapY; y++) {
+        for (int x = 0; x < nMapX; x++) {
+            int nValue = 0;
+            if (!IsOccupied( x, y, layer )) {
+                int nMin = std::min( std::min( get_value( x - 1, y ), get_value( x - 1, y - 1 )),
+                                     std::min( get_value( x    , y - 1 ), get_value( x + 1, y - 1 )));
+                nValue = std::min( nMin + 1, DIST_FIELD_MAX );
+            }
+            vField[ y * nMapX + x ] = nValue;
+        }
+    }
+    // backward pass
+    for (int y = nMapY - 1; y >= 0; y--) {
+        for (int x = nMapX - 1; x >= 0; x--) {
+            int nMin = std::min( std::min( get_value( x + 1, y ), get_value( x + 1, y + 1 )),
+                                 std::min( get_value( x    , y + 1 ), get_value( x - 1, y + 1 )));
+            if (nMin + 1 < vField[ y * nMapX + x ]) {
+                vField[ y * nMapX + x ] = nMin + 1;
+            }
+        }
+    }
+}
+
+// incremental update of the distance field for layer (or the combined one if layer == -1) after cell (x, y) became (non-)empty
+// Only cells within DIST_FIELD_MAX of (x, y) can be affected:
+//   * if (x, y) became non-empty, distance values can only decrease, and the new value follows directly from the distance to (x, y)
+//   * if (x, y) became empty, only the cells whose distance value was determined by (x, y) must be recalculated
+void RC_Map::UpdateDistField( int x, int y, int layer, bool bBecameOccupied ) {
+    std::vector<uint8_t> &vField = (layer >= 0 ? vDistFields[ layer ] : vDistFieldAll);
+
+    int xMin = std::max( 0, x - DIST_FIELD_MAX ), xMax = std::min( nMapX - 1, x + DIST_FIELD_MAX );
+    int yMin = std::max( 0, y - DIST_FIELD_MAX ), yMax = std::min( nMapY - 1, y + DIST_FIELD_MAX );
+    for (int j = yMin; j <= yMax; j++) {
+        for (int i = xMin; i <= xMax; i++) {
+            int nDist = std::max( abs( i - x ), abs( j - y ));
+            uint8_t &rValue = vField[ j * nMapX + i ];
+            if (bBecameOccupied) {
+                if (nDist < rValue) { rValue = nDist; }
+            } else {
+                if (nDist == rValue) { rValue = CalcDistField( i, j, layer ); }
+            }
+        }
+    }
+}
+
+// =========/  occupancy pyramid methods  /==============================
+
+// returns a reference to the block counts of the occupancy pyramid at level for layer (or the combined one if layer == -1)
+std::vector<int> &RC_Map::OccBlocks( int level, int layer ) {
+    return vOccPyramid[ level - 1 ][ layer >= 0 ? layer : nMapZ ];
+}
+
+// (re)builds the occupancy pyramid for the whole map
+void RC_Map::InitOccPyramid() {
+    vOccPyramid.resize( OCC_PYRAMID_LEVELS );
+    for (int nLevel = 1; nLevel <= OCC_PYRAMID_LEVELS; nLevel++) {
+        int nShift = OCC_BLOCK_SHIFT( nLevel );
+        int nBlocksX = ((nMapX - 1) >> nShift) + 1;
+        int nBlocksY = ((nMapY - 1) >> nShift) + 1;
+        // one set of block counts per layer, plus one for all layers combined
+        vOccPyramid[ nLevel - 1 ].resize( nMapZ + 1 );
+        for (int z = -1; z < nMapZ; z++) {
+            std::vector<int> &vBlocks = OccBlocks( nLevel, z );
+            vBlocks.assign( nBlocksX * nBlocksY, 0 );
+            for (int y = 0; y < nMapY; y++) {
+                for (int x = 0; x < nMapX; x++) {
+                    if (IsOccupied( x, y, z )) {
+                        vBlocks[ (y >> nShift) * nBlocksX + (x >> nShift) ] += 1;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// incremental update of the occupancy pyramid for layer (or the combined one if layer == -1) after cell (x, y) became (non-)empty
+void RC_Map::UpdateOccPyramid( int x, int y, int layer, bool bBecameOccupied ) {
+    for (int nLevel = 1; nLevel <= OCC_PYRAMID_LEVELS; nLevel++) {
+        int nShift = OCC_BLOCK_SHIFT( nLevel );
+        int nBlocksX = ((nMapX - 1) >> nShift) + 1;
+        OccBlocks( nLevel, layer )[ (y >> nShift) * nBlocksX + (x >> nShift) ] += (bBecameOccupied ? +1 : -1);
+    }
+}
+
+// =========/  boundary mask methods  /==============================
+
+// works out the boundary mask for map cell (x, y, layer) by comparing it with its neighbours.
+// A ray that enters this cell through face F comes from the neighbour on that side. That crossing is a boundary if:
+//   * the neighbour is outside the map, or
+//   * face F of this cell is a portal or transparent face, or
+//   * the top or bottom face of this cell or the neighbour is transparent, or
+//   * a side face of the neighbour is a portal or transparent face (then this cell may be visible through the neighbour), or
+//   * the heights of the cells differ
+// For dynamic cells the heights can change, so then the height comparison is left to the DDA (BOUNDARY_DYNAMIC bit)
+uint8_t RC_Map::CalcBoundaryMask( int x, int y, int layer ) {
+
+    // lambda to check if the top or bottom face of a map cell is transparent
+    auto has_transparent_top_or_bottom = [=]( RC_MapCell *pCell ) {
+        if (pCell->IsEmpty()) return false;
+        return pCell->GetFacePtr( FACE_TOP )->IsTransparent() || pCell->GetFacePtr( FACE_BOTTOM )->IsTransparent();
+    };
+    // lambda to check if any side face of a map cell is a portal or transparent face
+    auto has_see_through_side = [=]( RC_MapCell *pCell ) {
+        if (pCell->IsEmpty()) return false;
+        for (int i = FACE_EAST; i <= FACE_NORTH; i++) {
+            if (pCell->GetFacePtr( i )->IsPortal() || pCell->GetFacePtr( i )->IsTransparent()) return true;
+        }
+        return false;
+    };
+
+    RC_MapCell *pThisCell = bMaps[layer][y * nMapX + x];
+    uint8_t nResult = 0;
+    for (int nFace = FACE_EAST; nFace <= FACE_NORTH; nFace++) {
+        // work out where the neighbour is for the ray entering via nFace
+        int nbX = x, nbY = y;
+        switch (nFace) {
+            case FACE_EAST : nbX += 1; break;
+            case FACE_WEST : nbX -= 1; break;
+            case FACE_SOUTH: nbY += 1; break;
+            case FACE_NORTH: nbY -= 1; break;
+        }
+        bool bStatic = false, bDynamic = false;
+        if (!IsInBounds( nbX, nbY )) {
+            bStatic = true;
+        } else {
+            RC_MapCell *pNbCell = bMaps[layer][nbY * nMapX + nbX];
+            if (!pThisCell->IsEmpty()) {
+                RC_Face *pFace = pThisCell->GetFacePtr( nFace );
+                bStatic |= pFace->IsPortal() || pFace->IsTransparent();
+            }
+            bStatic |= has_transparent_top_or_bottom( pThisCell ) || has_transparent_top_or_bottom( pNbCell );
+            bStatic |= has_see_through_side( pNbCell );
+            if (pThisCell->IsDynamic() || pNbCell->IsDynamic()) {
+                bDynamic = true;
+            } else {
+                bStatic |= pThisCell->GetHeight() != pNbCell->GetHeight();
+            }
+        }
+        if (bStatic) {
+            nResult |= BOUNDARY_STATIC( nFace );
+        } else if (bDynamic) {
+            nResult |= BOUNDARY_DYNAMIC( nFace );
+        }
+    }
+    return nResult;
+}
+
+// (re)builds the boundary masks for the whole map
+void RC_Map::InitBoundaryMasks() {
+    vBoundaryColumns.resize( nMapX * nMapY * nMapZ );
+    for (int y = 0; y < nMapY; y++) {
+        for (int x = 0; x < nMapX; x++) {
+            for (int z = 0; z < nMapZ; z++) {
+                vBoundaryColumns[ (y * nMapX + x) * nMapZ + z ] = CalcBoundaryMask( x, y, z );
+            }
+        }
+    }
+}
+
+// ==============================/  end of file   /==============================
@@ -1,100 +1,206 @@
-#ifndef RC_MAP_H
-#define RC_MAP_H
-
-//////////////////////////////////  RC_Map   //////////////////////////////////////////
-
-/* The game map is an RC_Map object, which is a 3D grid having a width (x-size), a height (y-size)
- * and a nr of layers (z-size). The structure is divided in discrete cells (in 2D we would call it
- * tiled, here "blocked" is more appropriate), it's components (blocks) are modeled by RC_MapCell objects.
- *
- * A map cell object is either empty, or it is not empty, in which case it contains six faces.
- *
- * In it's most basic form, a face is just a texture. It can be more advanced, like an animated face.
- * Either way it uses sprites from the sprite lists for walls, roofs, and ceilings. These sprite lists
- * are defined in the map definition file.
- */
-
-#include <list>
-
-#include "RC_MapCell.h"
-#include "RC_Object.h"
-
-// ==============================/  class RC_Map  /==============================
-
-class RC_Map {
-
-private:
-    int nMapID = -1;     // the map ID is also its index in the vMaps[] vector
-    int nMapX  =  0;     // dimensions for the map
-    int nMapY  =  0;
-    int nMapZ  =  0;
-
-    std::vector<std::vector<RC_MapCell *>> bMaps;  // all map cell is stored per tile in an RC_MapCell type (derived) object
-    std::vector<PortalDescriptor> vPDs;            // portals are described in a separate vector. Note that this vector
-                                                   // only contains portals that exit from this map
-    olc::Sprite *pFloorSpritePtr = nullptr;        // a pointer to the sprite that is used as floor texture
-    olc::Pixel SkyColour = olc::CYAN;              // the colour that is used to paint the sky
-
-public:
-    std::list<RC_Object> vListObjects;     // list of all objects in the game
-
-public:
-
-    RC_Map();
-    ~RC_Map();
-
-    // First initialize the map calling this method ...
-    void InitMap( int nID, std::vector<PortalDescriptor> &vPortDescs, olc::Sprite *floorTxtr = nullptr, olc::Pixel skyCol = olc::CYAN );
-    // ... then add nSizeZ (at least 1) layers to it using this method
-    void AddLayer( std::vector<std::string> &sUserMap, std::vector<olc::Sprite *> &vWallTextures,
-                                                       std::vector<olc::Sprite *> &vCeilTextures,
-                                                       std::vector<olc::Sprite *> &vRoofTextures );
-
-    // method to clean up the object before it gets out of scope
-    void FinalizeMap();
-
-    // getters for map width and height
-    int GetID();
-    int GetWidth();
-    int GetHeight();
-    // returns the diagonal length of the map - useful for setting max distance value
-    float DiagonalLength();
-    float DiagonalLength3D();
-    // returns current number of layers in this map object - use fMaps as representative model
-    int NrOfLayers();
-
-    // returns whether (x, y) is within map boundaries
-    bool IsInBounds( float x, float y );
-    // returns whether (x, y, z) is within map boundaries (z is the layer height)
-    bool IsInBounds( float x, float y, float z );
-
-    // getter for (cumulated) cell height at coordinates (x, y)
-    // Note - there's no intuitive meaning for this method in maps with holes
-    float CellHeight( int x, int y );
-
-    // getter for obtaining height value of the cell at layer, coordinates (x, y)
-    float CellHeightAt( int x, int y, int layer );
-
-    // getter for obtaining the character value of the cell at layer, coordinates (x, y)
-    char CellValueAt( int x, int y, int layer );
-
-    // getter for obtaining the pointer to the associated block of the cell at layer, coordinates (x, y)
-    RC_MapCell *MapCellPtrAt( int x, int y, int layer );
-
-    // collision detection on the map:
-    // Note that int( fH ) denotes layer to check, and (fH - int( fH )) denotes height to check within that layer
-    // and fR is the radius of the object (considered as a pillar shape)
-    bool Collides( float fX, float fY, float fH, float fR, float fVX, float fVY );
-
-    void SetFloorSpritePtr( olc::Sprite *pSpritePtr );
-    olc::Sprite *GetFloorSpritePtr();
-
-    void SetSkyColour( olc::Pixel col );
-    olc::Pixel GetSkyColour();
-
-private:
-    // returns a reference to the portal whose entry is in this map at map cell (nL, nX, nY)
-    PortalDescriptor &GetPortalDescriptor( int nL, int nX, int nY );
-};
-
-#endif // RC_MAP_H
+#ifndef RC_MAP_H
+#define RC_MAP_H
+
+//////////////////////////////////  RC_Map   //////////////////////////////////////////
+
+/* The game map is an RC_Map object, which is a 3D grid having a width (x-size), a height (y-size)
+ * and a nr of layers (z-size). The structure is divided in discrete cells (in 2D we would call it
+ * tiled, here "blocked" is more appropriate), it's components (blocks) are modeled by RC_MapCell objects.
+ *
+ * A map cell object is either empty, or it is not empty, in which case it contains six faces.
+ *
+ * In it's most basic form, a face is just a texture. It can be more advanced, like an animated face.
+ * Either way it uses sprites from the sprite lists for walls, roofs, and ceilings. These sprite lists
+ * are defined in the map definition file.
+ */
+
+#include <list>
+#include <cstdint>
+
+#include "RC_MapCell.h"
+#include "RC_Object.h"
+
+// the DDA keeps the tile coordinates of its hit points in 16 bit (see IntersectInfo in main.cpp), so maps can't be wider or higher than this
+#define MAP_MAX_SIZE   INT16_MAX
+
+// the distance field values are clamped to this value (in cells). Larger values allow bigger jumps in open areas, but
+// make the incremental updates of the distance field more expensive
+#define DIST_FIELD_MAX   16
+
+// bits in the boundary mask of a map cell. The face parameter is the face through which a ray enters the map cell (FACE_EAST .. FACE_NORTH)
+#define BOUNDARY_STATIC( face )    (0x01 << (face))   // entering the cell through this face is always a boundary
+#define BOUNDARY_DYNAMIC( face )   (0x10 << (face))   // entering the cell through this face is a boundary if the heights differ
+
+// the occupancy pyramid groups the map cells into square blocks. Level 1 blocks are 8 x 8 cells, and each next level groups
+// 8 x 8 blocks of the level below (so level 2 blocks are 64 x 64 cells). Level 0 would be the map cell itself
+#define OCC_PYRAMID_LEVELS   2
+#define OCC_LEVEL_SHIFT      3
+#define OCC_BLOCK_SHIFT( level )   ((level) * OCC_LEVEL_SHIFT)    // log2 of the block size (in cells) at pyramid level
+
+// the most recent cell height changes are kept in a log of this size, so that cached ray results can be checked against them
+#define CHANGE_LOG_SIZE   1024
+
+// ==============================/  class RC_Map  /==============================
+
+class RC_Map {
+
+private:
+    int nMapID = -1;     // the map ID is also its index in the vMaps[] vector
+    int nMapX  =  0;     // dimensions for the map
+    int nMapY  =  0;
+    int nMapZ  =  0;
+
+    std::vector<std::vector<RC_MapCell *>> bMaps;  // all map cell is stored per tile in an RC_MapCell type (derived) object
+    std::vector<float> vHeightColumns;             // copy of the map cell heights, stored per (x, y) as a column of nMapZ layer heights
+                                                   // this layout enables the multi layer DDA to read all layers of a cell in one go
+    std::vector<std::vector<uint8_t>> vDistFields; // per layer a distance field: the Chebyshev distance (in cells) from each cell to the nearest
+                                                   // non-empty cell or the map boundary, clamped to DIST_FIELD_MAX
+    std::vector<uint8_t> vDistFieldAll;            // same, but for all layers combined (i.e. a cell is non-empty if it's non-empty in any layer)
+    std::vector<std::vector<std::vector<int>>>     // occupancy pyramid: per level (index 0 is level 1) and per layer (the last index is for all
+                   vOccPyramid;                    // layers combined) the nr of non-empty cells in each block
+    std::vector<uint8_t> vBoundaryColumns;         // per (x, y) a column of nMapZ boundary masks (see BOUNDARY_STATIC and BOUNDARY_DYNAMIC), that
+                                                   // tell the DDA whether crossing into that cell via a specific face is a boundary that needs rendering
+    std::vector<int> vChangeLog;                   // ring buffer of the cells (as y * nMapX + x) whose height changed most recently
+    int nChangeCount = 0;                          // total nr of cell height changes so far
+    std::vector<olc::Sprite *> vWallTxtrs;          // the textures that were passed to AddLayer(), needed to create map cells afterwards
+    std::vector<olc::Sprite *> vCeilTxtrs;
+    std::vector<olc::Sprite *> vRoofTxtrs;
+    std::vector<PortalDescriptor> vPDs;            // portals are described in a separate vector. Note that this vector
+                                                   // only contains portals that exit from this map
+    olc::Sprite *pFloorSpritePtr = nullptr;        // a pointer to the sprite that is used as floor texture
+    olc::Pixel SkyColour = olc::CYAN;              // the colour that is used to paint the sky
+    float fDrawDistance  = 0.0f;                   // beyond this distance nothing is visible in this map (0.0f means: no limit) ...
+    olc::Pixel FogColour = olc::GREY;              // ... and the scene fades into this colour towards it
+
+public:
+    std::list<RC_Object> vListObjects;     // list of all objects in the game
+
+public:
+
+    RC_Map();
+    ~RC_Map();
+
+    // First initialize the map calling this method ...
+    void InitMap( int nID, std::vector<PortalDescriptor> &vPortDescs, olc::Sprite *floorTxtr = nullptr, olc::Pixel skyCol = olc::CYAN,
+                  float fDrawDist = 0.0f, olc::Pixel fogCol = olc::GREY );
+    // ... then add nSizeZ (at least 1) layers to it using this method
+    void AddLayer( std::vector<std::string> &sUserMap, std::vector<olc::Sprite *> &vWallTextures,
+                                                       std::vector<olc::Sprite *> &vCeilTextures,
+                                                       std::vector<olc::Sprite *> &vRoofTextures );
+
+    // method to clean up the object before it gets out of scope
+    void FinalizeMap();
+
+    // getters for map width and height
+    int GetID();
+    int GetWidth();
+    int GetHeight();
+    // returns the diagonal length of the map - useful for setting max distance value
+    float DiagonalLength();
+    float DiagonalLength3D();
+    // returns current number of layers in this map object - use fMaps as representative model
+    int NrOfLayers();
+
+    // returns whether (x, y) is within map boundaries
+    bool IsInBounds( float x, float y );
+    // returns whether (x, y, z) is within map boundaries (z is the layer height)
+    bool IsInBounds( float x, float y, float z );
+
+    // getter for (cumulated) cell height at coordinates (x, y)
+    // Note - there's no intuitive meaning for this method in maps with holes
+    float CellHeight( int x, int y );
+
+    // getter for obtaining height value of the cell at layer, coordinates (x, y)
+    float CellHeightAt( int x, int y, int layer );
+
+    // getter for obtaining the character value of the cell at layer, coordinates (x, y)
+    char CellValueAt( int x, int y, int layer );
+
+    // getter for obtaining the pointer to the associated block of the cell at layer, coordinates (x, y)
+    RC_MapCell *MapCellPtrAt( int x, int y, int layer );
+
+    // returns a pointer to the column of NrOfLayers() cell heights at coordinates (x, y), indexed by layer
+    // NOTE: no bounds checking here (it's meant for the DDA inner loop) - caller must check using IsInBounds()
+    float *HeightColumnAt( int x, int y );
+    // must be called if the height of the map cell at (x, y, layer) has changed (for instance for dynamic map cells),
+    // to keep the height columns in sync with the map cell objects
+    void SyncCellHeight( int x, int y, int layer );
+    // replaces the map cell at (x, y, layer) by pMapCell (the old map cell object is deleted), and keeps the height columns
+    // and distance fields in sync
+    void ReplaceMapCellAt( int x, int y, int layer, RC_MapCell *pMapCell );
+    // same, but creates the new map cell from the blueprint with ID cTileID (using the textures that were passed to AddLayer())
+    void ReplaceMapCellAt( int x, int y, int layer, char cTileID );
+
+    // returns the nr of cell height changes so far. Store it with results that depend on the map heights ...
+    int GetChangeCount();
+    // ... and use this method to get the cells (as y * GetWidth() + x) that changed after that count. It returns false if the change log
+    // doesn't reach back that far, in which case any cell might have changed
+    bool GetChangedCells( int nSinceCount, std::vector<int> &vCells );
+
+    // Getters for the distance fields: returns the Chebyshev distance from (x, y) to the nearest non-empty cell in the layer
+    // (or in any layer for the DistFieldAllAt() variant). All cells within a square of radius (result - 1) around (x, y) are empty,
+    // so a ray can skip across that square. The map boundary counts as non-empty.
+    // NOTE: no bounds checking here (it's meant for the DDA inner loop) - caller must check using IsInBounds()
+    int DistFieldAt( int x, int y, int layer );
+    int DistFieldAllAt( int x, int y );
+
+    // Getter for the occupancy pyramid: returns the highest level (1 .. OCC_PYRAMID_LEVELS) for which the block containing (x, y) is
+    // completely empty in layer (or in all layers if layer == -1), or 0 if there's no such level. The block at level L is the square of
+    // cells with the same (x >> OCC_BLOCK_SHIFT( L ), y >> OCC_BLOCK_SHIFT( L )), clipped to the map boundaries.
+    // NOTE: no bounds checking here (it's meant for the DDA inner loop) - caller must check using IsInBounds()
+    int EmptyBlockLevel( int x, int y, int layer );
+
+    // returns a pointer to the column of NrOfLayers() boundary masks at coordinates (x, y), indexed by layer
+    // NOTE: no bounds checking here (it's meant for the DDA inner loop) - caller must check using IsInBounds()
+    uint8_t *BoundaryColumnAt( int x, int y );
+
+    // collision detection on the map:
+    // Note that int( fH ) denotes layer to check, and (fH - int( fH )) denotes height to check within that layer
+    // and fR is the radius of the object (considered as a pillar shape)
+    bool Collides( float fX, float fY, float fH, float fR, float fVX, float fVY );
+
+    void SetFloorSpritePtr( olc::Sprite *pSpritePtr );
+    olc::Sprite *GetFloorSpritePtr();
+
+    void SetSkyColour( olc::Pixel col );
+    olc::Pixel GetSkyColour();
+
+    // the draw distance limits the visible distance in this map. If it's not set (0.0f), the diagonal length is returned
+    void SetDrawDistance( float fDist );
+    float GetDrawDistance();
+    // returns whether a draw distance is set for this map - only then the fog is applied
+    bool HasFog();
+    void SetFogColour( olc::Pixel col );
+    olc::Pixel GetFogColour();
+
+private:
+    // returns a reference to the portal whose entry is in this map at map cell (nL, nX, nY)
+    PortalDescriptor &GetPortalDescriptor( int nL, int nX, int nY );
+    // creates a map cell at (x, y, layer) from the blueprint with ID cTileID
+    RC_MapCell *CreateMapCell( char cTileID, int x, int y, int layer );
+
+    // returns whether map cell (x, y) is non-empty in layer (or in any layer if layer == -1) - cells outside the map count as non-empty
+    bool IsOccupied( int x, int y, int layer );
+    // works out the distance field value for (x, y) from scratch, by searching rings of increasing radius around it
+    int CalcDistField( int x, int y, int layer );
+    // (re)builds all distance fields for the whole map
+    void InitDistFields();
+    // builds the distance field for layer (or the combined one if layer == -1) in two passes over the map
+    void InitDistField( int layer, std::vector<uint8_t> &vField );
+    // incremental update of the distance field for layer (or the combined one if layer == -1) after cell (x, y) became (non-)empty
+    void UpdateDistField( int x, int y, int layer, bool bBecameOccupied );
+
+    // returns a reference to the block counts of the occupancy pyramid at level for layer (or the combined one if layer == -1)
+    std::vector<int> &OccBlocks( int level, int layer );
+    // (re)builds the occupancy pyramid for the whole map
+    void InitOccPyramid();
+    // incremental update of the occupancy pyramid for layer (or the combined one if layer == -1) after cell (x, y) became (non-)empty
+    void UpdateOccPyramid( int x, int y, int layer, bool bBecameOccupied );
+
+    // works out the boundary mask for map cell (x, y, layer) by comparing it with its neighbours
+    uint8_t CalcBoundaryMask( int x, int y, int layer );
+    // (re)builds the boundary masks for the whole map
+    void InitBoundaryMasks();
+};
+
+#endif // RC_MAP_H
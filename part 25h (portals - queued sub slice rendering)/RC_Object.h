@@ -1,91 +1,92 @@
-#ifndef RC_OBJECT_H
-#define RC_OBJECT_H
-
-#include "RC_DepthDrawer.h"
-#include "RC_Misc.h"
-
-// constants for collision detection with walls
-#define RADIUS_PLAYER   0.2f
-#define RADIUS_ELF      0.2f
-
-// test objects
-#define OBJ_PERC_DYN     0.01f    // this percent of *empty* tiles will be used as the nr of test objects
-#define OBJ_PERC_STAT    0.03f
-#define OBJ_PERC_BUSH    0.02f
-#define OBJ_PERC_TREE    0.04f
-
-//////////////////////////////////  RC_Object   //////////////////////////////////////////
-
-/* Besides background scenery (walls, floor, roof and ceilings), the game experience is built up using objects.
- * They can be stationary or moving around. These objects are modeled by the RC_Object class.
- */
-
-class RC_Map;   // forward declare
-
-// ==============================/  class RC_Object   /==============================
-
-// used to be definition of object record
-class RC_Object {
-
-private:
-    float x, y;             // position in the map
-    float scale;            // 1.0f is 100%
-
-    float vx, vy;           // velocity
-    float fObjAngle_rad;
-    float fObjSpeed;
-
-    float fDistToPlayer,
-          fAngleToPlayer;  // w.r.t. player
-
-    olc::Sprite *sprite = nullptr;
-
-public:
-    RC_Object();
-    RC_Object( float fX, float fY, float fS, float fD, float fA, olc::Sprite *pS );
-
-    void SetX( float fX );
-    void SetY( float fY );
-
-    float GetX();
-    float GetY();
-
-    void SetPos( float fX, float fY );
-
-    void SetScale(            float fS );
-    void SetDistToPlayer(     float fD );
-    void SetAngleToPlayer(    float fA );
-
-    float GetScale();
-    float GetDistToPlayer();
-    float GetAngleToPlayer();
-
-    void SetSprite( olc::Sprite *pS );
-    olc::Sprite *GetSprite();
-
-    void SetVX( float fVX );
-    void SetVY( float fVY );
-
-    float GetVX();
-    float GetVY();
-    float GetAngle();   // in radians!!
-    float GetSpeed();
-
-    void Update( RC_Map *curMap, float fElapsedTime );
-    void Print();
-
-    // work out distance and angle between object and player, and
-    // store it in the object itself
-    void PrepareRender( float fPx, float fPy, float fPa_deg );
-    void Render( RC_DepthDrawer &ddrwr, float fPh, float fFOV_rad, float fMaxDist, int nHorHeight );
-
-public:
-    bool bStationary = true;
-    bool bAnimated   = false;   // future use
-
-private:
-    void UpdateObjAngle();
-    void UpdateObjSpeed();
-};
-
-#endif // RC_OBJECT_H
+#ifndef RC_OBJECT_H
+#define RC_OBJECT_H
+
+#include "RC_DepthDrawer.h"
+#include "RC_Misc.h"
+
+// constants for collision detection with walls
+#define RADIUS_PLAYER   0.2f
+#define RADIUS_ELF      0.2f
+
+// test objects
+#define OBJ_PERC_DYN     0.01f    // this percent of *empty* tiles will be used as the nr of test objects
+#define OBJ_PERC_STAT    0.03f
+#define OBJ_PERC_BUSH    0.02f
+#define OBJ_PERC_TREE    0.04f
+
+//////////////////////////////////  RC_Object   //////////////////////////////////////////
+
+/* Besides background scenery (walls, floor, roof and ceilings), the game experience is built up using objects.
+ * They can be stationary or moving around. These objects are modeled by the RC_Object class.
+ */
+
+class RC_Map;   // forward declare
+
+// ==============================/  class RC_Object   /==============================
+
+// used to be definition of object record
+class RC_Object {
+
+private:
+    float x, y;             // position in the map
+    float scale;            // 1.0f is 100%
+
+    float vx, vy;           // velocity
+    float fObjAngle_rad;
+    float fObjSpeed;
+
+    float fDistToPlayer,
+          fAngleToPlayer;  // w.r.t. player
+
+    olc::Sprite *sprite = nullptr;
+
+public:
+    RC_Object();
+    RC_Object( float fX, float fY, float fS, float fD, float fA, olc::Sprite *pS );
+
+    void SetX( float fX );
+    void SetY( float fY );
+
+    float GetX();
+    float GetY();
+
+    void SetPos( float fX, float fY );
+
+    void SetScale(            float fS );
+    void SetDistToPlayer(     float fD );
+    void SetAngleToPlayer(    float fA );
+
+    float GetScale();
+    float GetDistToPlayer();
+    float GetAngleToPlayer();
+
+    void SetSprite( olc::Sprite *pS );
+    olc::Sprite *GetSprite();
+
+    void SetVX( float fVX );
+    void SetVY( float fVY );
+
+    float GetVX();
+    float GetVY();
+    float GetAngle();   // in radians!!
+    float GetSpeed();
+
+    void Update( RC_Map *curMap, float fElapsedTime );
+    void Print();
+
+    // work out distance and angle between object and player, and
+    // store it in the object itself
+    void PrepareRender( float fPx, float fPy, float fPa_deg );
+    // if bFog is set, the object pixels are blended into fogCol from fFogStrt onwards, and completely at fMaxDist
+    void Render( RC_DepthDrawer &ddrwr, float fPh, float fFOV_rad, float fMaxDist, int nHorHeight, bool bFog, float fFogStrt, const olc::Pixel &fogCol );
+
+public:
+    bool bStationary = true;
+    bool bAnimated   = false;   // future use
+
+private:
+    void UpdateObjAngle();
+    void UpdateObjSpeed();
+};
+
+#endif // RC_OBJECT_H
@@ -0,0 +1,205 @@
+#include "RC_RayQuery.h"
+
+#include <cfloat>
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+
+#include "RC_Misc.h"
+
+// ==============================/  class RC_RayQuery   /==============================
+
+RC_RayQuery::RC_RayQuery() {}
+
+RC_RayQuery::~RC_RayQuery() {
+    Finalize();
+}
+
+void RC_RayQuery::Init( std::vector<RC_Map> *pMapVector, RC_ThreadPool *pPool ) {
+    pMaps       = pMapVector;
+    pThreadPool = pPool;
+}
+
+void RC_RayQuery::Finalize() {
+    pMaps       = nullptr;
+    pThreadPool = nullptr;
+}
+
+int RC_RayQuery::NrOfThreads() { return (pThreadPool == nullptr) ? 1 : pThreadPool->NrOfThreads(); }
+
+// A DDA through the grid of a single layer. At each grid crossing the map cell that is entered is checked. If it's entered through
+// a portal face, the DDA is restarted in the other map, at the exit of the portal and with the direction rotated like the view is
+// rotated when rendering through that portal.
+bool RC_RayQuery::CastRay( const RayQuery &rQuery, RayQueryResult &rResult ) {
+
+    rResult.bHit     = false;
+    rResult.nMap     = rQuery.nMap;
+    rResult.nLayer   = rQuery.nLayer;
+    rResult.nCellX   = int( rQuery.fOrgX );
+    rResult.nCellY   = int( rQuery.fOrgY );
+    rResult.nFaceHit = FACE_UNKNOWN;
+    rResult.fHitX    = rQuery.fOrgX;
+    rResult.fHitY    = rQuery.fOrgY;
+    rResult.fDist    = 0.0f;
+    rResult.nPortals = 0;
+
+    if (pMaps == nullptr || rQuery.nMap < 0 || rQuery.nMap >= (int)pMaps->size()) {
+        std::cout << "ERROR: RC_RayQuery::CastRay() --> invalid map index: " << rQuery.nMap << std::endl;
+        return false;
+    }
+    float fDirLen = sqrt( rQuery.fDirX * rQuery.fDirX + rQuery.fDirY * rQuery.fDirY );
+    if (fDirLen == 0.0f) {
+        std::cout << "ERROR: RC_RayQuery::CastRay() --> direction vector has length 0" << std::endl;
+        return false;
+    }
+
+    int   nMap   = rQuery.nMap;
+    int   nLayer = rQuery.nLayer;
+    float fFromX = rQuery.fOrgX;
+    float fFromY = rQuery.fOrgY;
+    float fDX    = rQuery.fDirX / fDirLen;
+    float fDY    = rQuery.fDirY / fDirLen;
+    float fDistSoFar = 0.0f;    // distance covered in the maps before the last portal
+
+    bool bDone = false;
+    while (!bDone) {
+        RC_Map &rMap = (*pMaps)[ nMap ];
+        if (nLayer < 0 || nLayer >= rMap.NrOfLayers()) {
+            std::cout << "ERROR: RC_RayQuery::CastRay() --> invalid layer: " << nLayer << " in map: " << nMap << std::endl;
+            return false;
+        }
+        float fMaxDist = rQuery.fMaxDist - fDistSoFar;
+
+        // set up the DDA - this is the same set up as for the renderer's DDA
+        float fSX = (fDX == 0.0f) ? FLT_MAX : sqrt( 1.0f + (fDY / fDX) * (fDY / fDX));
+        float fSY = (fDY == 0.0f) ? FLT_MAX : sqrt( 1.0f + (fDX / fDY) * (fDX / fDY));
+        int nStepX = (fDX > 0.0f) ? +1 : -1;
+        int nStepY = (fDY > 0.0f) ? +1 : -1;
+        int nCurX  = int( fFromX );
+        int nCurY  = int( fFromY );
+        // if the ray doesn't move in x or y direction, it never crosses a grid line in that direction
+        float fLengthX = (fDX == 0.0f) ? FLT_MAX : ((nStepX < 0) ? fFromX - float( nCurX ) : float( nCurX + 1 ) - fFromX) * fSX;
+        float fLengthY = (fDY == 0.0f) ? FLT_MAX : ((nStepY < 0) ? fFromY - float( nCurY ) : float( nCurY + 1 ) - fFromY) * fSY;
+
+        bool bPortalPassed = false;
+        while (!bDone && !bPortalPassed) {
+            // advance to next map cell
+            float fDist;
+            bool  bHorGridLine;
+            if (fLengthX < fLengthY) {
+                nCurX += nStepX; fDist = fLengthX; fLengthX += fSX; bHorGridLine = false;
+            } else {
+                nCurY += nStepY; fDist = fLengthY; fLengthY += fSY; bHorGridLine = true;
+            }
+
+            if (fDist >= fMaxDist || !rMap.IsInBounds( nCurX, nCurY )) {
+                // nothing was hit: report where the ray ended
+                fDist = std::min( fDist, fMaxDist );
+                rResult.nCellX = int( fFromX + fDist * fDX );
+                rResult.nCellY = int( fFromY + fDist * fDY );
+                rResult.fHitX  = fFromX + fDist * fDX;
+                rResult.fHitY  = fFromY + fDist * fDY;
+                rResult.fDist  = fDistSoFar + fDist;
+                bDone = true;
+            } else {
+                RC_MapCell *pCell = rMap.MapCellPtrAt( nCurX, nCurY, nLayer );
+                if (!pCell->IsEmpty() && pCell->GetHeight() > 0.0f) {
+                    int nFace;
+                    if (bHorGridLine) {
+                        nFace = (nStepY < 0 ? FACE_SOUTH : FACE_NORTH);
+                    } else {
+                        nFace = (nStepX < 0 ? FACE_EAST  : FACE_WEST );
+                    }
+                    RC_Face *pFace = pCell->GetFacePtr( nFace );
+                    float fHitX = fFromX + fDist * fDX;
+                    float fHitY = fFromY + fDist * fDY;
+
+                    if (pFace->IsPortal() && (rQuery.nFlags & RAYQ_FOLLOW_PORTALS) && rResult.nPortals < RAYQ_MAX_PORTALS) {
+                        // continue at the exit of the portal, the way RenderSubSlice() does for the sub slices through portals
+                        RC_FacePortal *pPortal = (RC_FacePortal *)pFace;
+                        int nOtherX = pPortal->GetToX();
+                        int nOtherY = pPortal->GetToY();
+                        switch (pPortal->GetExitDir()) {
+                            case FACE_EAST : fFromX = nOtherX;                      fFromY = fHitY + (nOtherY - nCurY); break;
+                            case FACE_WEST : fFromX = nOtherX + 0.99999f;           fFromY = fHitY + (nOtherY - nCurY); break;
+                            case FACE_SOUTH: fFromX = fHitX + (nOtherX - nCurX);    fFromY = nOtherY;                   break;
+                            case FACE_NORTH: fFromX = fHitX + (nOtherX - nCurX);    fFromY = nOtherY + 0.99999f;        break;
+                            default: std::cout << "ERROR: RC_RayQuery::CastRay() --> this exit direction does not implement" << std::endl;
+                        }
+                        // rotate the direction over the difference between the exit direction and the orientation of the other map
+                        float fDiffAngle_rad = deg2rad( pPortal->GetToAngle() - pPortal->GetExitAngleDeg());
+                        float fNewDX = fDX * cos( fDiffAngle_rad ) - fDY * sin( fDiffAngle_rad );
+                        float fNewDY = fDX * sin( fDiffAngle_rad ) + fDY * cos( fDiffAngle_rad );
+                        fDX = fNewDX;
+                        fDY = fNewDY;
+
+                        nLayer     += pPortal->GetToLevel() - pPortal->GetFromLevel();
+                        nMap        = pPortal->GetToMap();
+                        fDistSoFar += fDist;
+                        rResult.nPortals += 1;
+                        bPortalPassed = true;
+
+                    } else if (!((rQuery.nFlags & RAYQ_PASS_PERMEABLE  ) && pCell->IsPermeable()) &&
+                               !((rQuery.nFlags & RAYQ_PASS_TRANSPARENT) && pFace->IsTransparent())) {
+                        // this map cell blocks the ray
+                        rResult.bHit     = true;
+                        rResult.nCellX   = nCurX;
+                        rResult.nCellY   = nCurY;
+                        rResult.nFaceHit = nFace;
+                        rResult.fHitX    = fHitX;
+                        rResult.fHitY    = fHitY;
+                        rResult.fDist    = fDistSoFar + fDist;
+                        bDone = true;
+                    }
+                }
+            }
+        }
+        rResult.nMap   = nMap;
+        rResult.nLayer = nLayer;
+    }
+    return rResult.bHit;
+}
+
+void RC_RayQuery::CastBatch( const std::vector<RayQuery> &vQueries, std::vector<RayQueryResult> &vResults ) {
+    vResults.resize( vQueries.size());
+
+    // each thread takes chunks of queries from the batch until there are none left
+    std::atomic<int> nNextQuery( 0 );
+    int nBatchSize = (int)vQueries.size();
+    auto process_batch = [&]( int nThread ) {
+        while (true) {
+            int nFirst = nNextQuery.fetch_add( RAYQ_CHUNK_SIZE );
+            if (nFirst >= nBatchSize)
+                break;
+            int nLast = std::min( nFirst + RAYQ_CHUNK_SIZE, nBatchSize );
+            for (int i = nFirst; i < nLast; i++) {
+                CastRay( vQueries[i], vResults[i] );
+            }
+        }
+    };
+    // small batches are not worth waking up the threads of the pool for
+    if (pThreadPool == nullptr || nBatchSize <= RAYQ_CHUNK_SIZE) {
+        process_batch( 0 );
+    } else {
+        pThreadPool->Run( process_batch );
+    }
+}
+
+bool RC_RayQuery::CanSee( int nMap, int nLayer, float fFromX, float fFromY, float fToX, float fToY ) {
+    RayQuery sQuery;
+    sQuery.nMap     = nMap;
+    sQuery.nLayer   = nLayer;
+    sQuery.fOrgX    = fFromX;
+    sQuery.fOrgY    = fFromY;
+    sQuery.fDirX    = fToX - fFromX;
+    sQuery.fDirY    = fToY - fFromY;
+    sQuery.fMaxDist = sqrt( sQuery.fDirX * sQuery.fDirX + sQuery.fDirY * sQuery.fDirY );
+    sQuery.nFlags   = RAYQ_LINE_OF_SIGHT;
+    if (sQuery.fMaxDist == 0.0f)
+        return true;
+
+    RayQueryResult sResult;
+    return !CastRay( sQuery, sResult );
+}
+
+// ==============================/  end of file   /==============================
@@ -0,0 +1,86 @@
+#ifndef RC_RAYQUERY_H
+#define RC_RAYQUERY_H
+
+//////////////////////////////////  RC_RayQuery   //////////////////////////////////////////
+
+/* Ray queries for the game logic, like "can A see B" or "which face does this shot hit". This is separate from the
+ * renderer's DDA: a query works on one layer only, and just returns the first blocking map cell along the ray.
+ *
+ * A map cell blocks the ray if it's not empty, unless the query flags let it pass (see RAYQ_PASS_PERMEABLE and
+ * RAYQ_PASS_TRANSPARENT). If the face that the ray enters through is a portal, the ray continues in the map the
+ * portal leads to (if RAYQ_FOLLOW_PORTALS is set), so results can be in another map than the query.
+ *
+ * Queries can be cast one by one on the calling thread using CastRay(), or in batches using CastBatch(), which
+ * divides the batch over the threads of an RC_ThreadPool. This pool is passed in, so that it can be shared with the
+ * renderer. Both only read the maps, and are safe to call from multiple threads.
+ * NOTE: the maps must not change while queries are cast, so don't cast them during the update of the map cells.
+ */
+
+#include <vector>
+
+#include "RC_Map.h"
+#include "RC_ThreadPool.h"
+
+// flags for the ray queries
+#define RAYQ_PASS_PERMEABLE     0x01    // permeable map cells (the player can move through them) don't block the ray
+#define RAYQ_PASS_TRANSPARENT   0x02    // map cells that are entered through a transparent face don't block the ray
+#define RAYQ_FOLLOW_PORTALS     0x04    // rays continue through portals (otherwise a portal face blocks the ray)
+
+// convenience flag combinations for typical queries
+#define RAYQ_LINE_OF_SIGHT     (RAYQ_PASS_PERMEABLE | RAYQ_PASS_TRANSPARENT)
+#define RAYQ_HITSCAN           (RAYQ_PASS_PERMEABLE | RAYQ_FOLLOW_PORTALS)
+
+#define RAYQ_MAX_PORTALS        8      // max nr of portals a ray can pass, to prevent endless loops between portals
+#define RAYQ_CHUNK_SIZE        64      // nr of queries a thread takes from a batch at a time
+
+// a ray query: from (fOrgX, fOrgY) in map nMap and layer nLayer in direction (fDirX, fDirY), with a max length of fMaxDist
+typedef struct sRayQuery {
+    int   nMap;
+    int   nLayer;
+    float fOrgX, fOrgY;
+    float fDirX, fDirY;         // direction, doesn't need to be normalized
+    float fMaxDist;
+    int   nFlags = RAYQ_LINE_OF_SIGHT;
+} RayQuery;
+
+// the result of a ray query. If no blocking map cell was found (bHit is false), the location fields contain the point
+// where the ray ended (at the max distance or at the map boundary)
+typedef struct sRayQueryResult {
+    bool  bHit = false;         // was a blocking map cell found?
+    int   nMap, nLayer;         // the map and layer the ray ended in (these differ from the query if portals were passed)
+    int   nCellX, nCellY;       // the blocking map cell
+    int   nFaceHit;             // the face of the blocking map cell that was hit (FACE_EAST .. FACE_NORTH, or FACE_UNKNOWN)
+    float fHitX, fHitY;         // the point where the ray hit the map cell
+    float fDist;                // the distance along the ray (summed over portals)
+    int   nPortals;             // the nr of portals passed
+} RayQueryResult;
+
+// ==============================/  class RC_RayQuery   /==============================
+
+class RC_RayQuery {
+private:
+    std::vector<RC_Map> *pMaps = nullptr;   // the maps are addressed by index into this vector, like in the portals
+    RC_ThreadPool *pThreadPool = nullptr;   // the threads the batches are cast on
+
+public:
+    RC_RayQuery();
+    ~RC_RayQuery();
+
+    // pass a pointer to the vector of maps, and the thread pool to cast the batches on (nullptr means: on the calling thread only)
+    void Init( std::vector<RC_Map> *pMapVector, RC_ThreadPool *pPool );
+    // detaches the maps and the thread pool. Must be called before the maps are finalized
+    void Finalize();
+
+    // the nr of threads a batch is cast on
+    int NrOfThreads();
+
+    // casts a single query on the calling thread. Returns whether a blocking map cell was found
+    bool CastRay( const RayQuery &rQuery, RayQueryResult &rResult );
+    // casts a batch of queries using the thread pool. vResults is resized to the size of vQueries
+    void CastBatch( const std::vector<RayQuery> &vQueries, std::vector<RayQueryResult> &vResults );
+
+    // convenience: returns whether (fToX, fToY) can be seen from (fFromX, fFromY) in map nMap and layer nLayer (no portals)
+    bool CanSee( int nMap, int nLayer, float fFromX, float fFromY, float fToX, float fToY );
+};
+
+#endif // RC_RAYQUERY_H
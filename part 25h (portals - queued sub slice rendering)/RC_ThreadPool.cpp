@@ -0,0 +1,80 @@
+#include "RC_ThreadPool.h"
+
+#include <algorithm>
+
+// ==============================/  class RC_ThreadPool   /==============================
+
+RC_ThreadPool::RC_ThreadPool() {}
+
+RC_ThreadPool::~RC_ThreadPool() {
+    Finalize();
+}
+
+void RC_ThreadPool::Init( int nThreads ) {
+    Finalize();
+    if (nThreads < 1) {
+        nThreads = std::max( 1, int( std::thread::hardware_concurrency()));
+    }
+    bQuit = false;
+    // thread 0 is the calling thread. The workers get the current job id passed, so that they only wait for jobs that come after this point
+    for (int i = 1; i < nThreads; i++) {
+        vWorkers.emplace_back( &RC_ThreadPool::WorkerLoop, this, i, nJobID );
+    }
+}
+
+void RC_ThreadPool::Finalize() {
+    {
+        std::lock_guard<std::mutex> lock( mtxJob );
+        bQuit = true;
+    }
+    cvStart.notify_all();
+    for (auto &elt : vWorkers) {
+        elt.join();
+    }
+    vWorkers.clear();
+}
+
+int RC_ThreadPool::NrOfThreads() { return (int)vWorkers.size() + 1; }
+
+void RC_ThreadPool::Run( const std::function<void( int )> &fJob ) {
+    std::lock_guard<std::mutex> callerLock( mtxCaller );
+
+    if (!vWorkers.empty()) {
+        {
+            std::lock_guard<std::mutex> lock( mtxJob );
+            pJob         = &fJob;
+            nBusyWorkers = (int)vWorkers.size();
+            nJobID      += 1;
+        }
+        cvStart.notify_all();
+    }
+    // the calling thread does its part of the job, and then waits for the workers to finish
+    fJob( 0 );
+    if (!vWorkers.empty()) {
+        std::unique_lock<std::mutex> lock( mtxJob );
+        cvDone.wait( lock, [this] { return nBusyWorkers == 0; } );
+        pJob = nullptr;
+    }
+}
+
+void RC_ThreadPool::WorkerLoop( int nThread, int nSeenJobID ) {
+    std::unique_lock<std::mutex> lock( mtxJob );
+    while (true) {
+        cvStart.wait( lock, [&] { return bQuit || nJobID != nSeenJobID; } );
+        if (bQuit)
+            return;
+        nSeenJobID = nJobID;
+        const std::function<void( int )> *pCurJob = pJob;
+
+        lock.unlock();
+        (*pCurJob)( nThread );
+        lock.lock();
+
+        nBusyWorkers -= 1;
+        if (nBusyWorkers == 0) {
+            cvDone.notify_all();
+        }
+    }
+}
+
+// ==============================/  end of file   /==============================
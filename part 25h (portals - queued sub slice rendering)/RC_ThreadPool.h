@@ -0,0 +1,55 @@
+#ifndef RC_THREADPOOL_H
+#define RC_THREADPOOL_H
+
+//////////////////////////////////  RC_ThreadPool   //////////////////////////////////////////
+
+/* A pool of persistent worker threads, to spread work that is done each frame (like the rendering of the screen columns)
+ * over the cores, without the cost of starting threads every frame.
+ *
+ * Run() hands a job to all threads of the pool and returns when each of them has finished it. The job gets the index of
+ * the thread it runs on (0 .. NrOfThreads() - 1), so that it can use scratch buffers per thread. The calling thread helps
+ * out as thread 0, so a pool of 1 thread has no worker threads at all and just runs the job on the calling thread.
+ * How the work is divided over the threads is up to the job (e.g. by taking work items using an atomic counter).
+ */
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// ==============================/  class RC_ThreadPool   /==============================
+
+class RC_ThreadPool {
+private:
+    std::vector<std::thread> vWorkers;
+    std::mutex              mtxCaller;      // only one job at a time is run
+    std::mutex              mtxJob;         // protects the job variables below
+    std::condition_variable cvStart, cvDone;
+    const std::function<void( int )> *pJob = nullptr;
+    int               nJobID       = 0;     // incremented for each job, to wake up the workers
+    int               nBusyWorkers = 0;
+    bool              bQuit        = false;
+
+public:
+    RC_ThreadPool();
+    ~RC_ThreadPool();
+
+    // starts the pool with nThreads threads in total, including the calling thread (-1 means: the nr of hardware threads)
+    void Init( int nThreads = -1 );
+    // stops the worker threads
+    void Finalize();
+
+    int NrOfThreads();
+
+    // runs fJob( nThread ) on all threads of the pool, and returns when all of them are done. The pool can be shared: if another
+    // thread calls Run() while a job is running, it waits until that job is done.
+    // NOTE: so a job must not call Run() on its own pool
+    void Run( const std::function<void( int )> &fJob );
+
+private:
+    // the loop each worker thread runs. nSeenJobID is the id of the last job that was run before it started
+    void WorkerLoop( int nThread, int nSeenJobID );
+};
+
+#endif // RC_THREADPOOL_H
@@ -1,1645 +1,4350 @@
-// ELABORATING ON - Ray casting tutorial by Permadi
-// (starting with part 20 all code files are my own elaboration on the Permadi basis)
-//
-// Implementation of part 25 h - portal rendering with queued (instead of recursive) sub slice rendering
-//
-// Joseph21, july 5, 2023
-//
-// Dependencies:
-//   *  olcPixelGameEngine.h - (olc::PixelGameEngine header file) by JavidX9 (see: https://github.com/OneLoneCoder/olcPixelGameEngine)
-//   *  sprite files for texturing walls, roofs, floor and ceiling, as well as objects in the scene: use your own .png files and
-//      adapt the file names and paths in "map_16x16.h"
-//   *  include file "map_16x16.h" - contains the map definitions and the sprite file names
-
-/* Short description
-   -----------------
-   This implementation is a follow up of implementation part 25 g. See the description of that implementation as well (and check on
-   the differences between that cpp file and this one).
-
-   I rewrote the portal rendering code into a version that uses a queue instead of recursion. The idea being that it would give me more
-   control over the rendering order etc.
-
-   Summary of the changes I made:
-     * main.cpp
-         + Created two simple new modules t_queue.h and t_stack.h. These are templated
-         + I removed the recursion statistics and wrote some test code to render 1 sub slice per frame
-         + I also rewrote the DDA function to be as simple and straightforward as possible. The intelligence was put into a post filter function that is used to post process the output of the dda function. This design choice was made to give me more grip on the rendering process, and to split the DDA from the process of skipping or filtering irrelevant nodes.
-         + Made some improvements on the sampler lambda's for roofs and ceilings to improve wonky rendering bug.
-         + Got rid of the erase/remove_if idiom in OnUserUpdate(), since this is now put in the post filter function
-         + Experimented somewhat with the exact boundaries between roof and wall and between wall and ceiling. Either way there seem to be rounding errors...
-         + I added code in the slide renderer to clip the portal sub slice if it is masked by stuff that is closer by according to the depth buffer.
-     * RC_DepthDrawer
-         + Had to add two more functions, to reset only part of a depth buffer slice, and to check if a particular pixel is masking a given depth
-
-[ NOTE that I should use the same criteria for resetting subslice as I should for testing / rendering roofs, ceilings and walls ]
-
-   Have fun!
- */
-
-#include <cfloat>       // needed for constant FLT_MAX in the DDA function
-
-#define OLC_PGE_APPLICATION
-#include "olcPixelGameEngine.h"
-
-#include "t_queue.h"
-#include "t_stack.h"
-
-// ==============================/  specific include files   /==============================
-
-#include "RC_Screen.h"
-#include "RC_Misc.h"
-#include "RC_Face.h"
-#include "RC_MapCell.h"
-#include "RC_Map.h"
-#include "RC_DepthDrawer.h"
-#include "RC_Object.h"
-
-// ==============================/  constants   /==============================
-
-#define MULTI_LAYERS      true
-#define RENDER_CEILING       !MULTI_LAYERS    // render ceilings only for single layer world
-
-// shading constants
-#define RENDER_SHADED        true
-#define OBJECT_INTENSITY       5.0f   // for testing, reset to 1.5f afterwards!
-#define MULTIPLIER_INTENSITY   5.0f
-#define INTENSITY_SPEED        1.0f
-
-#define SHADE_FACTOR_MIN       0.1f   // the shade factor is clamped between these two values
-#define SHADE_FACTOR_MAX       1.0f
-
-// constants for speed movements - all movements are modulated with fElapsedTime
-#define SPEED_ROTATE          60.0f   //                            60 degrees per second
-#define SPEED_MOVE             5.0f   // forward and backward    -   5 units per second
-#define SPEED_STRAFE           5.0f   // left and right strafing -   5 units per second
-#define SPEED_LOOKUP         200.0f   // looking up or down      - 200 pixels per second
-#define SPEED_STRAFE_UP        1.0f   // flying or chrouching    -   1.0 unit per second
-
-// mini map constants
-#define MINIMAP_TILE_SIZE     (32 / PIXEL_SIZE)   // each minimap tile is ... pixels
-#define MINIMAP_SCALE_FACTOR   0.4    // should be 0.2
-
-#define SENSE_RADIUS    2.0f    // player must be this close to map cell center to be able to open doors etc
-#define SENSE_BLENDF    0.4f    // bland factor to render sense circle around player
-
-// colour constants
-#define COL_HUD_TXT     olc::YELLOW
-#define COL_HUD_BG      olc::VERY_DARK_GREEN
-
-// ==============================/  map definition here   /==============================
-
-#include "map_16x16.h"
-// ==============================/  queue type for sub slice info   /==============================
-
-// typedef for controlled sub slice rendering
-typedef struct sSubSliceRec {
-    float fViewAngle_deg;      // ranges over the field of view from - FOV / 2 to + FOV / 2
-    float fCurAngle_deg;       // angle of current slice in world space
-    float fVPAngle_deg;        // angle of the view point (typically identical to player angle) in world space
-    int   nCurMap;             // what map ...
-    float fPx, fPy, fPh;       // ... and location therein is the ray to be cast from?
-    float fStrtDist;           // precursor distance - to arrive at the portal of this map
-    int   nSlice;              // current slice to be rendered
-    int   nStrtY, nStopY;      // smallest (i.e. highest on screen) and largest (lowest on screen) y coordinate of sub slice
-    int   nHorHght;            // hight of horizon for this slice
-    bool  bResetSlice = false; // should depth buffer for this sub slice be cleared upfront?
-} SubSliceRec;
-
-typedef t_queue<SubSliceRec> SliceQueue;
-
-// ==============================/  stack type for delayed pixel rendering   /==============================
-
-typedef struct sDelayedPixel {
-    float depth;    // for depth drawing
-    int x, y;       // screen coordinates
-    olc::Pixel p;   // pixel to draw
-} DelayedPixel;
-
-typedef t_stack<DelayedPixel> PixelStack;
-
-// ==============================/  PGE derived ray caster engine   /==============================
-
-
-class MyRayCaster : public olc::PixelGameEngine {
-
-public:
-    MyRayCaster() {    // display the screen and pixel dimensions in the window caption
-        sAppName = "MyRayCaster - Permadi tutorial elaborations - S:(" + std::to_string( SCREEN_X / PIXEL_SIZE ) + ", " + std::to_string( SCREEN_Y / PIXEL_SIZE ) + ")" +
-                                                               ", P:(" + std::to_string(            PIXEL_SIZE ) + ", " + std::to_string(            PIXEL_SIZE ) + ")" ;
-    }
-
-private:
-    std::vector<RC_Map> vMaps;    // the list of all game map objects
-    int nActiveMap = 0;           // keeps track of which of the maps is currently active
-    float fMaxDistance;           // max visible distance - use length of map diagonal to overlook whole map
-
-    float fPlayerX     =  4.5f;    // player: position - is reset in OnUserCreate() using map definition data file
-    float fPlayerY     =  4.5f;
-    float fPlayerH     =  0.5f;   // player: height of eye point and field of view
-    float fPlayerA_deg = 90.0f;   // player: looking angle is in degrees - NOTE: 0.0f is EAST
-    float fPlayerLU    =  0.0f;   // factor for looking up or down (in pixel space: float is for smooth movement)
-    // rationale: when fPlayerH == 0.5f, then lookup factor == 0. When fPlayerH == 1.5f, the lookup factor equals one screen height
-
-    float fPlayerX_cached;         // to be able to see delta in player movement
-    float fPlayerY_cached;
-    float fPlayerH_cached;
-
-    float fPlayerFoV_deg = 60.0f;   // in degrees !!
-    float fPlayerFoV_rad;
-
-    float fAnglePerPixel_deg;      // how many degrees are needed to rotate to next screen slice? - is calculated in OnUserCreate()
-    float fDistToProjPlane;         // constant distance to projection plane - is calculated in OnUserCreate()
-
-    // all sprites for texturing the scene and the objects, grouped in categories
-    std::vector<olc::Sprite *> vWallSprites;
-    std::vector<olc::Sprite *> vCeilSprites;
-    std::vector<olc::Sprite *> vRoofSprites;
-    std::vector<olc::Sprite *> vFlorSprites;
-    std::vector<olc::Sprite *> vObjtSprites;
-
-    // var's and initial values for shading - trigger keys INS and DEL
-    float fObjectIntensity     = MULTI_LAYERS ? OBJECT_INTENSITY     :  0.2f;
-    float fIntensityMultiplier = MULTI_LAYERS ? MULTIPLIER_INTENSITY : 10.0f;
-
-    // toggles for rendering
-    bool bMinimap     = false;    // toggle on mini map rendering (trigger key P)
-    bool bMapRays     = false;    //           rays in mini map   (trigger key O)
-    bool bPlayerInfo  = false;    //           player info hud    (trigger key I)
-    bool bProcessInfo = false;    //           process info hud   (trigger key U)
-    bool bTestSlice   = false;    //           visible test slice (trigger key G)
-    bool bTestGrid    = false;    //           visible test grid  (trigger key H)
-
-    typedef struct sRayStruct {
-        olc::vf2d pointA, pointB;
-        int layer;
-    } RayType;
-    std::vector<RayType> vRayList;    // needed for ray rendering in minimap
-
-    // which of the slices to output in test mode
-    float fTestSlice;
-    int nActiveSlice = -1;
-    bool bTestMode = false;           // to trigger test output
-    bool bSlicedRendering = true;         // sliced or continuous rendering
-
-    // create a queue to handle the sub slice rendering
-    SliceQueue dSliceQueue;
-    int nSlicesPerFrame = 1;
-    int nFrameCntr = 0;
-
-    RC_DepthDrawer cDDrawer;              // depth drawing object
-
-public:
-
-    // create and fill the maps - these are defined in a separate file
-    // NOTES: 1) string arguments in AddLayer() must all have the same x and y dimensions
-    //        2) the z-dimension of the map is determined by the nr of layers added to it
-    //        3) the parameters vWallSprites, vCeilSprites and vRoofSprites must be initialised upfront
-    void InitMaps() {
-
-        // lambda expression to determine the sky clour per map
-        auto get_sky_colour = [=]( int mapID ) -> olc::Pixel {
-            if (mapID < (int)vSkyColours.size()) {
-                return vSkyColours[ mapID ];
-            } else {
-                return olc::CYAN;
-            }
-        };
-        // initialize all layers (counter n) for all maps (counter m) in the input data
-        for (int m = 0; m < (int)vMapLayouts.size(); m++) {
-            RC_Map tmp;
-            tmp.InitMap( m, vMapPortals[m], vFlorSprites[m], get_sky_colour( m ));
-            MapType &sMapLayout = vMapLayouts[m];
-            for (int n = 0; n < (int)sMapLayout.size(); n++) {
-                tmp.AddLayer( sMapLayout[n], vWallSprites, vCeilSprites, vRoofSprites );
-            }
-            vMaps.push_back( tmp );
-        }
-    }
-
-    // Four percentages are passed, for dynamic objects, stationary objects, bushes and trees.
-    void InitObjectsPerMap( RC_Map *pCurMapPtr, float fObjDynPerc, float fObjStatPerc, float fObjBushPerc, float fObjTreePerc ) {
-
-        // aux map to keep track of placed objects
-        // count nr of occupied cells at the same time
-        std::string sObjMap;
-        int nTilesOccupied = 0;
-        for (int y = 0; y < pCurMapPtr->GetHeight(); y++) {
-            for (int x = 0; x < pCurMapPtr->GetWidth(); x++) {
-                sObjMap.append( " " );
-                if (pCurMapPtr->CellHeight( x, y ) != 0.0f) {
-                    nTilesOccupied += 1;
-                }
-            }
-        }
-        // only place objects where there's nothing in the immediate (8 connected) neighbourhood
-        auto space_for_object = [=]( int x, int y ) -> bool {
-            int xMin = std::max( 0, x - 1 );
-            int yMin = std::max( 0, y - 1 );
-            int xMax = std::min( pCurMapPtr->GetWidth()  - 1, x + 1 );
-            int yMax = std::min( pCurMapPtr->GetHeight() - 1, y + 1 );
-            bool bOccupied = false;
-            for (int r = yMin; r <= yMax && !bOccupied; r++) {
-                for (int c = xMin; c <= xMax && !bOccupied; c++) {
-                    bOccupied = pCurMapPtr->CellHeight( c, r ) != 0.0f || sObjMap[ r * pCurMapPtr->GetWidth() + c ] != ' ';
-                }
-            }
-            return !bOccupied;
-        };
-
-        int nNrDynObjects  = int((pCurMapPtr->GetWidth() * pCurMapPtr->GetHeight() - nTilesOccupied) * fObjDynPerc);
-        int nNrStatObjects = int((pCurMapPtr->GetWidth() * pCurMapPtr->GetHeight() - nTilesOccupied) * fObjStatPerc);
-        int nNrBushObjects = int((pCurMapPtr->GetWidth() * pCurMapPtr->GetHeight() - nTilesOccupied) * fObjBushPerc);
-        int nNrTreeObjects = int((pCurMapPtr->GetWidth() * pCurMapPtr->GetHeight() - nTilesOccupied) * fObjTreePerc);
-        int nTotalNrObjects = nNrDynObjects + nNrStatObjects + nNrBushObjects + nNrTreeObjects;
-
-        int nDynChoices  =  1;    // these values are depending on the available object sprite files loaded via
-        int nStatChoices =  2;    // the user defined map
-        int nBushChoices = 10;
-        int nTreeChoices = 18;
-
-        // populate object list with randomly chosen, scaled and placed objects
-        for (int i = 0; i < nTotalNrObjects; i++) {
-            int nRandX, nRandY;
-            bool bFoundEmpty = false;
-            bool bMakeDynamic = false;
-            // find an empty spot in the map
-            do {
-                nRandX = rand() % pCurMapPtr->GetWidth();
-                nRandY = rand() % pCurMapPtr->GetHeight();
-
-                bFoundEmpty = space_for_object( nRandX, nRandY );
-            } while (!bFoundEmpty);
-
-            // determine object type - make sure that at least MIN_DYNAMIC_OBJS objects are dynamic
-            int nRandObj;
-            if (is_in_range( i,              0, nNrDynObjects  )) { nRandObj = rand() % nDynChoices;                                              } else
-            if (is_in_range( i,  nNrDynObjects, nNrStatObjects )) { nRandObj = rand() % nStatChoices + nDynChoices;                               } else
-            if (is_in_range( i, nNrStatObjects, nNrBushObjects )) { nRandObj = rand() % nBushChoices + nDynChoices + nStatChoices;                } else
-                                                                  { nRandObj = rand() % nTreeChoices + nDynChoices + nStatChoices + nBushChoices; }
-
-            // depending on object type, make dynamic or static and determine size
-            int nRandSize;
-            if (is_in_range( nRandObj, 0,  1 )) { bMakeDynamic = true ; nRandSize = rand() %  3 +  3; } else   // this is an elf girl, make dynamic
-            if (is_in_range( nRandObj, 1,  3 )) { bMakeDynamic = false; nRandSize =                6; } else   // these are stationary objects of fixed size
-            if (is_in_range( nRandObj, 3, 13 )) { bMakeDynamic = false; nRandSize = rand() %  8 +  2; } else   // these are bushes
-                                                { bMakeDynamic = false; nRandSize = rand() % 15 + 10; }        // trees
-
-            // create the object and put it in the list of objects
-            RC_Object tmpObj( float( nRandX ) + 0.5f, float( nRandY ) + 0.5f, float( nRandSize / 10.0f ), -1.0f, 0.0f, vObjtSprites[ nRandObj ] );
-            if (bMakeDynamic) {
-                tmpObj.bStationary = false;
-                tmpObj.SetVX( float_rand_between( -5.0f, 5.0f ));
-                tmpObj.SetVY( float_rand_between( -5.0f, 5.0f ));
-            } else {
-                tmpObj.bStationary = true;
-                tmpObj.SetVX( 0.0f );
-                tmpObj.SetVY( 0.0f );
-            }
-
-            pCurMapPtr->vListObjects.push_back( tmpObj );
-
-            // mark that an object is placed at this tile
-            sObjMap[ nRandY * pCurMapPtr->GetWidth() + nRandX ] = 'X';
-        }
-    }
-
-    bool OnUserCreate() override {
-
-        bool bSuccess = true;
-
-        // seed randomizer
-        srand( time( 0 ));
-        // initialize sine and cosine lookup arrays - these are meant for performance improvement
-        init_lu_sin_array();
-        init_lu_cos_array();
-        // Work out distance to projection plane. This is a constant float value, depending on the width of the projection plane and the field of view.
-        fDistToProjPlane = ((ScreenWidth() / 2.0f) / lu_sin( fPlayerFoV_deg / 2.0f )) * lu_cos( fPlayerFoV_deg / 2.0f );
-
-        // lambda expression for loading sprite files with error checking
-        auto load_sprite_file = [=]( const std::string &sFileName ) {
-            olc::Sprite *tmp = new olc::Sprite( sFileName );
-            if (tmp->width == 0 || tmp->height == 0) {
-                std::cout << "ERROR: OnUserCreate() --> can't load file: " << sFileName << std::endl;
-                delete tmp;
-                tmp = nullptr;
-            }
-            return tmp;
-        };
-        // lambda expression for loading all sprites for one category (walls, ceilings, roofs, floors or objects) into the
-        // associated container
-        auto load_sprites_from_files = [=]( std::vector<std::string> &vFileNames, std::vector<olc::Sprite *> &vSpritePtrs, const std::string &sType ) {
-            bool bNoErrors = true;
-            for (auto &sf : vFileNames) {
-                olc::Sprite *tmpPtr = load_sprite_file( sf );
-                bNoErrors &= (tmpPtr != nullptr);
-                vSpritePtrs.push_back( tmpPtr );
-            }
-            std::cout << "Loaded: " << (int)vFileNames.size() << " files into " << (int)vSpritePtrs.size() << " " << sType << " sprites."    << std::endl;
-            return bNoErrors;
-        };
-        // load all sprites into their associated container
-        bSuccess &= load_sprites_from_files( vWallSpriteFiles, vWallSprites, "wall"    );
-        bSuccess &= load_sprites_from_files( vCeilSpriteFiles, vCeilSprites, "ceiling" );
-        bSuccess &= load_sprites_from_files( vRoofSpriteFiles, vRoofSprites, "roof"    );
-        bSuccess &= load_sprites_from_files( vFlorSpriteFiles, vFlorSprites, "floor"   );
-        bSuccess &= load_sprites_from_files( vObjtSpriteFiles, vObjtSprites, "object"  );
-
-        // fill the library of face blueprints
-        InitFaceBluePrints( vWallSprites, vCeilSprites, vRoofSprites );
-        // fill the library of map cell blueprints
-        InitMapCellBluePrints();
-        // initialise all layers of all maps using the vMapLayouts vector
-        // as a results the vMaps vector is populated
-        InitMaps();
-        // initialise objects per map
-        float fObjPercentage = 0.0f;
-        for (int i = 0; i < (int)vMaps.size(); i++) {
-            // comment this switch out if you don't want objects in the maps
-//            switch( i ) {
-//                case 0: fObjPercentage = 2.0f; break;
-//                case 1: fObjPercentage = 0.0f; break;
-//                case 2: fObjPercentage = 1.0f; break;
-//            }
-            InitObjectsPerMap(
-                &(vMaps[i]),
-                fObjPercentage * OBJ_PERC_DYN,
-                fObjPercentage * OBJ_PERC_STAT,
-                fObjPercentage * OBJ_PERC_BUSH,
-                fObjPercentage * OBJ_PERC_TREE
-            );
-        }
-        // set the active map according to map def. data file
-        nActiveMap = nStartMap;
-        // max ray length for DDA is diagonal length of the map
-        fMaxDistance = vMaps[ nActiveMap ].DiagonalLength();
-
-        // set player initial position and orientation according to map def. data file
-        fPlayerX     = fStartPlayerX;
-        fPlayerY     = fStartPlayerY;
-        fPlayerH     = fStartPlayerZ;
-        fPlayerA_deg = fStartPlayerA;
-        fPlayerLU    = fStartPlayerLU;
-
-        // set cache player location variables
-        fPlayerX_cached = fPlayerX;
-        fPlayerY_cached = fPlayerY;
-        fPlayerH_cached = fPlayerH;
-
-        // set initial test slice value at middle of screen
-        fTestSlice = ScreenWidth() / 2.0f;
-        // determine how much degrees one pixel shift represents.
-        fAnglePerPixel_deg = fPlayerFoV_deg / float( ScreenWidth());
-        // determine the player field of view in radians as well
-        fPlayerFoV_rad = deg2rad( fPlayerFoV_deg );
-        // initialise the depth drawer object
-        cDDrawer.Init( this );
-
-        return bSuccess;
-    }
-
-    // Holds intersection point in float (world) coordinates and in int (tile) coordinates,
-    // the distance to the intersection point and the height of the map at these tile coordinates
-    typedef struct sIntersectInfo {
-        float fHitX,             // world space hit point
-              fHitY;
-        int   nHitX,             // tile space hit point
-              nHitY;
-        float fDistFrnt_raw,     // raw distances to front and back faces of hit block
-              fDistBack_raw;
-        float fDistFrnt_corr,    // corrected distances to front and back faces of hit block
-              fDistBack_corr;
-        float fHeight;           // height within the layer
-        int   nLayer = -1;       // nLayer == 0 --> ground layer
-
-        // these are on screen projected (O.S.P.) values (y coordinate in pixel space)
-        int osp_bot_frnt = -1;    // on screen projected bottom  of wall slice
-        int osp_bot_back = -1;    //                     bottom  of wall at back
-        int osp_top_frnt = -1;    //                     ceiling of wall slice
-        int osp_top_back = -1;    //                     ceiling of wall at back
-
-        int nFaceHit = FACE_UNKNOWN;     // which face was hit?
-        bool bHorizHit;                  // was the hit on a horizontal grid line?
-
-        bool bRemoveFlag = false;
-    } IntersectInfo;
-
-    // put info from hit point p to screen
-    void PrintHitPoint( IntersectInfo &p, bool bVerbose ) {
-        std::cout << "hit (world): ( " << p.fHitX << ", " << p.fHitY << " ) ";
-        std::cout << "hit (tile): ( " << p.nHitX << ", " << p.nHitY << " ) ";
-        std::cout << "raw dist.: "     << p.fDistFrnt_raw  << " ";
-        std::cout << "corr. dist.: "   << p.fDistFrnt_corr << " ";
-        std::cout << "lvl: " << p.nLayer << " hght: " << p.fHeight << " ";
-        if (bVerbose) {
-            std::cout << "bot frnt: " << p.osp_bot_frnt << " bot back: " << p.osp_bot_back << " ";
-            std::cout << "top frnt: " << p.osp_top_frnt << " top back: " << p.osp_top_back << " ";
-            switch (p.nFaceHit) {
-                case FACE_EAST   : std::cout << "EAST";    break;
-                case FACE_NORTH  : std::cout << "NORTH";   break;
-                case FACE_WEST   : std::cout << "WEST";    break;
-                case FACE_SOUTH  : std::cout << "SOUTH";   break;
-                case FACE_TOP    : std::cout << "TOP";     break;
-                case FACE_BOTTOM : std::cout << "BOTTOM";  break;
-                case FACE_UNKNOWN: std::cout << "UNKNOWN"; break;
-                default          : std::cout << "ERROR: "   << p.nFaceHit;
-            }
-        }
-        std::cout << std::endl;
-    }
-
-    // put info from hit list vHitList to screen
-    void PrintHitList( std::vector<IntersectInfo> &vHitList, bool bVerbose = false ) {
-        for (int i = 0; i < (int)vHitList.size(); i++) {
-            std::cout << "Elt: " << i << " = ";
-            PrintHitPoint( vHitList[i], bVerbose );
-        }
-        std::cout << std::endl;
-    }
-
-    // Implementation of the DDA algorithm.
-    // This function uses nCurMap as the index into the vMaps array to obtain the correct map.
-    // It then casts the ray from (fPx, fPy, nPz) in the direction of fRayAngle_deg:
-    // A "to point" is determined using + fRayAngle_deg and fMaxDistance. A ray is cast from the "from point" to the "to point".
-    // In this new version of the DDA function, all intersections with all grid lines are recorded. That implies that they need to
-    // be filtered afterwards. This is done to get better control on how to process the rendering with different types of map cells
-    // encountered along the way.
-    bool CastRayPerLevelAndAngle( int nCurMap, float fPx, float fPy, int nPz, float fRayAngle_deg, std::vector<IntersectInfo> &vHitList ) {
-
-        // get a reference to the map
-        RC_Map &pCurMap = vMaps[ nCurMap ];
-        // counter for nr of hit points found
-        int nHitPointsFound = 0;
-
-        // The player's position is the "from point"
-        float fFromX = fPx;
-        float fFromY = fPy;
-        // Calculate the "to point" using the player's angle and fMaxDistance
-        float fToX = fPx + fMaxDistance * lu_cos( fRayAngle_deg );
-        float fToY = fPy + fMaxDistance * lu_sin( fRayAngle_deg );
-        // work out normalized direction vector (fDX, fDY)
-        float fDX = fToX - fFromX;
-        float fDY = fToY - fFromY;
-        float fRayLen = sqrt( fDX * fDX + fDY * fDY );
-        fDX /= fRayLen;
-        fDY /= fRayLen;
-        // calculate the scaling factors for the ray increments per unit in x resp y direction
-        // this calculation takes division by 0.0f into account
-        float fSX = (fDX == 0.0f) ? FLT_MAX : sqrt( 1.0f + (fDY / fDX) * (fDY / fDX));
-        float fSY = (fDY == 0.0f) ? FLT_MAX : sqrt( 1.0f + (fDX / fDY) * (fDX / fDY));
-        // work out if line is going right or left resp. down or up
-        int nGridStepX = (fDX > 0.0f) ? +1 : -1;
-        int nGridStepY = (fDY > 0.0f) ? +1 : -1;
-
-        // init loop variables
-        float fLengthPartialRayX = 0.0f;
-        float fLengthPartialRayY = 0.0f;
-
-        int nCurX = int( fFromX );
-        int nCurY = int( fFromY );
-
-        // work out the first intersections with the grid
-        if (nGridStepX < 0) { // ray is going left - get scaled difference between start point and left cell border
-            fLengthPartialRayX = (fFromX - float( nCurX )) * fSX;
-        } else {              // ray is going right - get scaled difference between right cell border and start point
-            fLengthPartialRayX = (float( nCurX + 1.0f ) - fFromX) * fSX;
-        }
-        if (nGridStepY < 0) { // ray is going up - get scaled difference between start point and top cell border
-            fLengthPartialRayY = (fFromY - float( nCurY )) * fSY;
-        } else {              // ray is going down - get scaled difference between bottom cell border and start point
-            fLengthPartialRayY = (float( nCurY + 1.0f ) - fFromY) * fSY;
-        }
-
-        // check whether analysis got out of map boundaries
-        bool bOutOfBounds = !pCurMap.IsInBounds( nCurX, nCurY );
-        // did analysis reach the destination cell?
-        bool bDestCellReached = (nCurX == int( fToX ) && nCurY == int( fToY ));
-        // to keep track of what direction you are searching
-        bool bCheckHor;
-
-        // lambda to return index value of face that was hit
-        auto get_face_hit = [=]( bool bHorGridLine ) {
-            int nFaceValue = FACE_UNKNOWN;
-            if (bHorGridLine) {
-                nFaceValue = (nGridStepY < 0 ? FACE_SOUTH : FACE_NORTH);
-            } else {
-                nFaceValue = (nGridStepX < 0 ? FACE_EAST  : FACE_WEST );
-            }
-            return nFaceValue;
-        };
-
-        // convenience lambda to add hit point with one call
-        auto add_hit_point = [&]( std::vector<IntersectInfo> &vHList, float fDst, float fStrtX, float fStrtY, float fDeltaX, float fDeltaY, int nTileX, int nTileY, float fHght, int nLayer, bool bHorGrid ) {
-            IntersectInfo sInfo;
-
-            sInfo.fDistFrnt_raw = fDst;
-            sInfo.fHitX      = fStrtX + fDst * fDeltaX;
-            sInfo.fHitY      = fStrtY + fDst * fDeltaY;
-            sInfo.nHitX      = nTileX;
-            sInfo.nHitY      = nTileY;
-            sInfo.fHeight    = fHght;
-            sInfo.nLayer     = nLayer;
-            sInfo.nFaceHit   = get_face_hit( bHorGrid );
-            sInfo.bHorizHit  = bHorGrid;
-
-            vHList.push_back( sInfo );
-        };
-
-        float fDistIfFound = 0.0f;  // accumulates distance of analysed piece of ray
-        float fCurHeight   = 0.0f;  // to check on differences in height
-
-        // terminate the loop / algorithm if out of bounds or destinion found or maxdistance exceeded
-        // Note: the latter scenario shouldn't occur, since fDistIfFound == fMaxDistance in the destination point
-        while (!bOutOfBounds && !bDestCellReached && fDistIfFound < fMaxDistance) {
-
-            // advance to next map cell, depending on length of partial ray's
-            if (fLengthPartialRayX < fLengthPartialRayY) {
-                // continue analysis in x direction
-                nCurX += nGridStepX;
-                fDistIfFound = fLengthPartialRayX;
-                fLengthPartialRayX += fSX;
-                bCheckHor = false;
-            } else {
-                // continue analysis in y direction
-                nCurY += nGridStepY;
-                fDistIfFound = fLengthPartialRayY;
-                fLengthPartialRayY += fSY;
-                bCheckHor = true;
-            }
-
-            bOutOfBounds = !pCurMap.IsInBounds( nCurX, nCurY );
-            // check if destination cell is found already (for loop control)
-            bDestCellReached = (nCurX == int( fToX ) && nCurY == int( fToY ));
-
-            if (bOutOfBounds) {
-                // If out of bounds, finalize the list with one additional intersection with the map boundary and height 0.
-                // This additional intersection record is necessary for proper rendering at map boundaries.
-                    fCurHeight = 0.0f;  // since we're out of bounds
-                add_hit_point( vHitList, fDistIfFound, fFromX, fFromY, fDX, fDY, nCurX, nCurY, fCurHeight, nPz, bCheckHor );
-            } else {
-
-                nHitPointsFound += 1;
-                // set current height to new value
-                fCurHeight = pCurMap.CellHeightAt( nCurX, nCurY, nPz );
-                // put the collision info in a new IntersectInfo node and push it up the hit list
-                add_hit_point( vHitList, fDistIfFound, fFromX, fFromY, fDX, fDY, nCurX, nCurY, fCurHeight, nPz, bCheckHor );
-            }
-        }
-        // return whether any hitpoints were found on this layer
-        return (nHitPointsFound > 0);
-    }
-
-    void PostFilterHitList( int nCurMap, std::vector<IntersectInfo> &vHitList ) {
-
-        // get a reference to the map
-        RC_Map &pCurMap = vMaps[ nCurMap ];
-
-        float fCacheHeight = 0.0f;
-
-        // this flag is used to filter out all empty cells at the start of the list
-        bool bStartPhase = true;
-
-        for (int i = 0; i < (int)vHitList.size(); i++) {
-            // get a ref to current hit list point...
-            IntersectInfo &curHP = vHitList[i];
-
-            // ... check if the hit is inbound the map ...
-            if (pCurMap.IsInBounds( curHP.nHitX, curHP.nHitY, curHP.nLayer )) {
-                // ... get a pointer to the map cell from it ...
-                RC_MapCell *curMapCellPtr = pCurMap.MapCellPtrAt( curHP.nHitX, curHP.nHitY, curHP.nLayer );
-                if (curMapCellPtr != nullptr) {
-
-                    if (curMapCellPtr->IsEmpty()) {
-                        if (bStartPhase) {
-                            curHP.bRemoveFlag = true;     // all empty cells at the head of the list can be removed
-                        }
-                    } else {
-                        // if map cell is not empty, get a pointer to the face from the map cell ptr
-                        RC_Face *curFacePtr = curMapCellPtr->GetFacePtr( curHP.nFaceHit );
-
-                        // for filtering besides height the following characteristics are relevant
-                        float fHeight       = curMapCellPtr->GetHeight();
-                        bool bIsPortal      = (curFacePtr == nullptr ? false : curFacePtr->IsPortal());
-                        bool bIsTransparent = (curFacePtr == nullptr ? false : curFacePtr->IsTransparent());
-                        // flag all redundant nodes, that are characteristically identical to their predecessor
-                        if ( (fCacheHeight == fHeight) && !bIsPortal && !bIsTransparent ) {
-                            curHP.bRemoveFlag = true;
-                        }
-                        bStartPhase = false;
-                    }
-                }
-            }
-        }
-        // little lambda to act as filter function
-        auto filter_out_hitpoint = [=]( IntersectInfo &a ) {
-            return a.bRemoveFlag;
-        };
-        // actual filtering with erase-remove idiom
-        vHitList.erase(
-            std::remove_if(
-                vHitList.begin(),
-                vHitList.end(),
-                filter_out_hitpoint
-            ),
-           vHitList.end()
-        );
-    }
-
-    // Returns the on screen projected values (i.e. the y screen coordinates) for top and bottom of a map cell.
-    // The map cell is at fCorrDistToWall from eye point, fViewPointHeight is the player's height, nHorHight is the
-    // height of the horizon, nLayerHeight is the layer for this block and fWallHeight is the height of the map cell (in (0.0f, 1.0f] )
-    // according to the map
-    // The calculated results (on screen projections = OSP's) are passed in the two reference parameters.
-    void CalculateBlockProjections( float fCorrDistToWall, float fViewPointHeight, int nHorHeight, int nLayerHeight, float fWallHeight, int &nOspTop, int &nOspBottom ) {
-        // calculate projected slice height for a *unit height* wall (in screen space)
-        int nSliceHeight = int((1.0f / fCorrDistToWall) * fDistToProjPlane);
-        nOspTop    = round( nHorHeight - (nSliceHeight * (1.0f - fViewPointHeight)) - (nLayerHeight + fWallHeight - 1.0f) * nSliceHeight );
-        nOspBottom = round( nOspTop + nSliceHeight * fWallHeight );
-    }
-
-// ==============================/   Mini map rendering prototypes   /==============================
-
-    // function to render the mini map on the screen. If nRenderLevel == -1, all layers are taken into account.
-    // Otherwise only the specified level is renderd in the minimap
-    void RenderMap( int nRenderLevel = -1 );
-    void RenderMapPlayer();      // function to render the player in the mini map on the screen
-    void RenderMapRays( int nPlayerLevel );        // function to render the rays in the mini map on the screen
-    void RenderMapObjects();     // function to render all the objects in the mini map on the screen
-    void RenderPlayerInfo();      // function to render player info in a separate hud on the screen
-    void RenderProcessInfo();     // function to render process info in a separate hud on the screen
-
-    olc::Pixel ShadePixel( const olc::Pixel &p, float fDistance );	// Shade the pixel p using fDistance as a factor in the shade formula
-
-    /* Queue based sub slice renderer
-     * Takes the front element of dSliceQ and renders it, using the info from that element
-     * If any new subslices emerge, they are pushed at the back of the queue
-     * This approach enables careful analysis of the rendering over multiple maps
-     * the vector of floats is the precalced cos value for each screen pixel y coordinate
-     */
-    void RenderSubSlice(
-        SliceQueue &dSliceQ,
-        std::vector<float> &vDownAngleCos
-    ) {
-        // these variables are all populated from the slice queue record
-        float fViewAngle_deg, fCurAngle_deg, fVPAngle_deg;
-        int   nCurMap;
-        float fPx, fPy, fPh;
-        float fStrtDist;
-        int   nSlice;
-        int   nStrtY, nStopY;
-        int   nHorHght;
-
-        // stack for delayed rendering
-        PixelStack vRenderLater;
-
-        // Temporarily replaced the while by an if statement, to give control to the calling code.
-        // As a result, this function only does one sub slice at a time
-        if (!dSliceQ.empty()) {
-
-            // get slice describing info from the queue
-            SubSliceRec tmp = dSliceQ.pop();
-
-            fViewAngle_deg = tmp.fViewAngle_deg;
-            fCurAngle_deg  = tmp.fCurAngle_deg;
-            fVPAngle_deg   = tmp.fVPAngle_deg;
-
-            nCurMap   = tmp.nCurMap;
-            fPx       = tmp.fPx;
-            fPy       = tmp.fPy;
-            fPh       = tmp.fPh;
-            fStrtDist = tmp.fStrtDist;
-            nSlice    = tmp.nSlice;
-            nStrtY    = tmp.nStrtY;
-            nStopY    = tmp.nStopY;
-            nHorHght  = tmp.nHorHght;
-
-            // get a reference to the current map
-            RC_Map *pCurMap = &vMaps[ nCurMap ];
-
-            int   nOspTopFrnt, nOspTopBack;   // to store the top and bottom y coord of the cell projection per column (screen space)
-            int   nOspBotFrnt, nOspBotBack;
-
-            // create a local slice container to store any emerging sub slices (could be > 1)
-            // the reason to store these locally at first is because they have to be checked against the depth buffer after
-            // all "regular" (i.e. non-delayed and non-portal) parts of the slice have been rendered
-            std::vector<SubSliceRec> localSliceQueue;
-
-            /////////////////////   SAMPLE LAMBDA's    /////////////////////////////
-
-            // These lambdas calculate the sample coordinates for horizontal surfaces. They can be used for floors, roofs and ceilings.
-            // fProjDistance is the distance from the player to the hit point on the surface.
-            auto get_texel_u = [=]( float fProjDistance ) {
-                // calculate the world coordinates from the distance and the view angle + player angle
-                float fProjX = fPx + fProjDistance * lu_cos( fCurAngle_deg );
-                // calculate the sample coordinates for that world coordinate. Wrap around if the result < 0 or >= 1
-                float fSampleX = fProjX - int(fProjX);
-                if (fSampleX <  0.0f) fSampleX += 1.0f;
-                if (fSampleX >= 1.0f) fSampleX -= 1.0f;
-                return fSampleX;
-            };
-
-            auto get_texel_v = [=]( float fProjDistance ) {
-                // calculate the world coordinates from the distance and the view angle + player angle
-                float fProjY = fPy + fProjDistance * lu_sin( fCurAngle_deg );
-                // calculate the sample coordinates for that world coordinate. Wrap around if the result < 0 or >= 1
-                float fSampleY = fProjY - int(fProjY);
-                if (fSampleY <  0.0f) fSampleY += 1.0f;
-                if (fSampleY >= 1.0f) fSampleY -= 1.0f;
-                return fSampleY;
-            };
-
-            // this lambda returns a sample of the floor through the pixel at screen coord (px, py)
-            auto get_floor_sample = [=]( int px, int py, float fDistOffset ) -> olc::Pixel {
-                // work out the distance to the location on the floor you are looking at through this pixel
-                float fFloorProjDistance;
-                fFloorProjDistance = ((fPh / float( py - nHorHght )) * fDistToProjPlane );
-                // it turns out that for ray casting into another level, the distance must be corrected so that it
-                // reflects the distance from the portal into the other world
-                fFloorProjDistance -= fDistOffset;
-                fFloorProjDistance /= lu_cos( fViewAngle_deg );
-
-                // calculate the texels from this distance
-                float fSampleX = get_texel_u( fFloorProjDistance );
-                float fSampleY = get_texel_v( fFloorProjDistance );
-                // sample the pixel, shade it with the distance and return it
-                // NOTE: for the depth drawing the uncorrected distance is needed
-                return ShadePixel( pCurMap->GetFloorSpritePtr()->Sample( fSampleX, fSampleY ), fFloorProjDistance );
-            };
-
-            // This lambda performs much of the sampling proces of horizontal surfaces. It can be used for floors, roofs and ceilings etc.
-            // fProjDistance is the distance from the player to the hit point on the surface.
-            auto generic_sampling_cell = [=]( float fProjDistance, int nLevel, int nFaceID ) -> olc::Pixel {
-                // calculate the world coordinates from the distance and the view angle + player angle
-                float fProjX = fPx + fProjDistance * lu_cos( fCurAngle_deg );
-                float fProjY = fPy + fProjDistance * lu_sin( fCurAngle_deg );
-                // calculate the sample coordinates for that world coordinate, by subtracting the
-                // integer part and only keeping the fractional part. Wrap around if the result < 0 or > 1
-                float fSampleX = fProjX - int(fProjX); if (fSampleX < 0.0f) fSampleX += 1.0f; if (fSampleX >= 1.0f) fSampleX -= 1.0f;
-                float fSampleY = fProjY - int(fProjY); if (fSampleY < 0.0f) fSampleY += 1.0f; if (fSampleY >= 1.0f) fSampleY -= 1.0f;
-
-                // select the sprite to render the ceiling depending on the block that was hit
-                int nTileX = std::clamp( int( fProjX ), 0, pCurMap->GetWidth()  - 1);
-                int nTileY = std::clamp( int( fProjY ), 0, pCurMap->GetHeight() - 1);
-                // obtain a pointer to the block that was hit
-                RC_MapCell *auxMapCellPtr = pCurMap->MapCellPtrAt( nTileX, nTileY, nLevel );
-                // sample that block passing the face that was hit and the sample coordinates
-                olc::Pixel sampledPixel = (auxMapCellPtr == nullptr) ? olc::MAGENTA : auxMapCellPtr->Sample( nFaceID, fSampleX, fSampleY );
-                // shade and return the pixel
-                return ShadePixel( sampledPixel, fProjDistance );
-            };
-
-            // this lambda returns a sample of the roof through the pixel at screen coord (px, py)
-            // NOTE: fRoofHeightWithinLevel denotes the height of the hit point on the roof. This is typically the height of the block within the layer
-            auto get_roof_sample = [=]( int px, int py, int nLevel, float fDistOffset, float fRoofHeightWithinLevel, float &fRoofProjDistance ) -> olc::Pixel {
-                // work out the distance to the location on the roof you are looking at through this pixel
-                fRoofProjDistance = (( (fPh - (float( nLevel ) + fRoofHeightWithinLevel)) / float( py - nHorHght )) * fDistToProjPlane);
-                // for sampling into another map, we need to correct the distance with the distance to the portal face
-                float fRoofProjDistance_raw = (fRoofProjDistance - fDistOffset) / lu_cos( fViewAngle_deg );
-                // call the generic sampler to work out the rest
-                return generic_sampling_cell( fRoofProjDistance_raw, nLevel, FACE_TOP );
-            };
-
-            // this lambda returns a sample of the ceiling through the pixel at screen coord (px, py)
-            // NOTE: fHeightWithinLevel denotes the height of the hit point on the ceiling. This is typically 0.0f, since the ceilings are not (yet) fractionally positionable
-            auto get_ceil_sample = [=]( int px, int py, int nLevel, float fDistOffset, float fCeilHeightWithinLevel, float &fCeilProjDistance ) -> olc::Pixel {
-                // work out the distance to the location on the ceiling you are looking at through this pixel
-                    fCeilProjDistance = (( ((float( nLevel ) + fCeilHeightWithinLevel) - fPh) / float( nHorHght - py )) * fDistToProjPlane);
-                // for sampling into another map, we need to correct the distance with the distance to the portal face
-                    float fCeilProjDistance_raw = (fCeilProjDistance - fDistOffset) / lu_cos( fViewAngle_deg );
-                // call the generic sampler to work out the rest
-                return generic_sampling_cell( fCeilProjDistance_raw, nLevel, FACE_BOTTOM );
-            };
-
-            /////////////////////   OBTAIN HITPOINT INFO    /////////////////////////////
-
-            // prepare the rendering for this slice by calculating the list of intersections along this ray
-            // for each layer, get the list of hit points in that layer, filter it, work out front and back distances and
-            // on screen projections, and add to the global vHitPointList
-            std::vector<IntersectInfo> vHitPointList;
-            for (int k = 0; k < pCurMap->NrOfLayers(); k++) {
-
-                std::vector<IntersectInfo> vCurLevelList;
-                CastRayPerLevelAndAngle( nCurMap, fPx, fPy, k, fCurAngle_deg, vCurLevelList );
-                PostFilterHitList( nCurMap, vCurLevelList );
-
-                for (int i = 0; i < (int)vCurLevelList.size(); i++) {
-                    // make correction for the fish eye effect
-                    vCurLevelList[i].fDistFrnt_corr = vCurLevelList[i].fDistFrnt_raw * lu_cos( fViewAngle_deg );
-                    // add the start distance - this is needed since we're working with staged rendering through portals
-                    vCurLevelList[i].fDistFrnt_corr += fStrtDist;
-
-                    // calculate values for the on screen projections osp_top_frnt and top_bottom
-                    CalculateBlockProjections(
-                        vCurLevelList[i].fDistFrnt_corr,
-                        fPh,
-                        nHorHght,
-                        vCurLevelList[i].nLayer,
-                        vCurLevelList[i].fHeight,
-                        vCurLevelList[i].osp_top_frnt,
-                        vCurLevelList[i].osp_bot_frnt
-                    );
-                }
-                // Extend the hit list with projected ceiling info for the back of the block
-                for (int i = 0; i < (int)vCurLevelList.size(); i++) {
-                    if (i == (int)vCurLevelList.size() - 1) {
-                        // last element, has no successor
-                        vCurLevelList[i].fDistBack_raw  = vCurLevelList[i].fDistFrnt_raw;
-                        vCurLevelList[i].fDistBack_corr = vCurLevelList[i].fDistFrnt_corr;
-                        vCurLevelList[i].osp_top_back   = vCurLevelList[i].osp_top_frnt;
-                        vCurLevelList[i].osp_bot_back   = vCurLevelList[i].osp_bot_frnt;
-                    } else {
-                        // calculate values for the on screen projections top_front and top_bottom
-                        vCurLevelList[i].fDistBack_raw  = vCurLevelList[i + 1].fDistFrnt_raw;
-                        vCurLevelList[i].fDistBack_corr = vCurLevelList[i + 1].fDistFrnt_corr;
-                        CalculateBlockProjections(
-                            vCurLevelList[i].fDistBack_corr,
-                            fPh,
-                            nHorHght,
-                            vCurLevelList[i].nLayer,
-                            vCurLevelList[i].fHeight,
-                            vCurLevelList[i].osp_top_back,
-                            vCurLevelList[i].osp_bot_back
-                        );
-                    }
-                }
-
-                // NOTE - shouldn't vRayList be a reference parameter?
-
-                // populate ray list for rendering mini map
-                if (bMinimap && !vCurLevelList.empty()) {
-                    RayType curHitPoint = { { fPx, fPy }, { vCurLevelList[0].fHitX, vCurLevelList[0].fHitY }, vCurLevelList[0].nLayer };
-                    vRayList.push_back( curHitPoint );
-                }
-                // add the hit points for this layer list to the combined hit point list
-                vHitPointList.insert( vHitPointList.end(), vCurLevelList.begin(), vCurLevelList.end());
-            }
-
-            // if test mode is triggered, print the hit list along the test slice
-            if (bTestMode && nSlice == int( fTestSlice )) {
-                int nMap = -1;
-            for (int i = 0; i < (int)vMaps.size() && nMap == -1; i++) {
-                    if (pCurMap == &vMaps[i]) {
-                        nMap = i;
-                    }
-                }
-                std::cout << "Map: " << nMap << std::endl;
-                PrintHitList( vHitPointList, true );
-                bTestMode = false;
-            }
-
-            /////////////////////   RENDER BACKGROUND    /////////////////////////////
-
-            // start rendering this sub slice by putting sky and floor in it
-            float fWellAway = fMaxDistance + 1000.0f;
-            olc::Pixel skySample = pCurMap->GetSkyColour();
-            for (int y = nStrtY; y <= nStopY; y++) {
-                // draw floor and horizon
-                if (y < nHorHght) {
-                    cDDrawer.Draw( fWellAway, nSlice, y, skySample );
-                } else {
-                    olc::Pixel floorSample = get_floor_sample( nSlice, y, fStrtDist );   // distance needs to be corrected
-                    cDDrawer.Draw( fWellAway, nSlice, y, floorSample );
-                }
-            }
-
-            // now render all hit points (i.e. wall sub slices) back to front
-            for (auto &hitRec : vHitPointList) {
-                // For the distance calculations we needed also points where the height returns to 0.0f (the
-                // back faces of the block). For the rendering we must skip these "hit points"
-                if (hitRec.fHeight > 0.0f) {
-
-                    // make sure the screen y coordinate is within sub slice boundaries
-                    nOspTopFrnt = std::clamp( hitRec.osp_top_frnt, nStrtY, nStopY );
-                    nOspTopBack = std::clamp( hitRec.osp_top_back, nStrtY, nStopY );
-                    nOspBotFrnt = std::clamp( hitRec.osp_bot_frnt, nStrtY, nStopY );
-                    nOspBotBack = std::clamp( hitRec.osp_bot_back, nStrtY, nStopY );
-
-                    // get a pointer to the map cell that was hit
-                    RC_MapCell *auxMapCellPtr = pCurMap->MapCellPtrAt( hitRec.nHitX, hitRec.nHitY, hitRec.nLayer );
-                    // get a pointer to the top face for roof rendering
-                    RC_Face *auxFacePtr = auxMapCellPtr->GetFacePtr( FACE_TOP );
-                    // render roof segment if it's visible (if top back >= top front, roof is not visible and nothing will be rendered)
-                    for (int y = nOspTopBack; y <= nOspTopFrnt; y++) {
-                        // the distance to this point is calculated and passed from get_roof_sample
-                        float fRenderDistance;
-                        olc::Pixel roofSample = get_roof_sample( nSlice, y, hitRec.nLayer, fStrtDist, hitRec.fHeight, fRenderDistance );   // shading is done in get_roof_sample()
-
-                        // either render or store for later rendering, depending on face transparency
-                        if (auxFacePtr->IsTransparent()) {
-                            DelayedPixel aux = { fRenderDistance / vDownAngleCos[y], nSlice, y, roofSample };
-                            vRenderLater.push( aux );
-                        } else {
-                            cDDrawer.Draw( fRenderDistance / vDownAngleCos[y], nSlice, y, roofSample );
-                        }
-                    }
-
-                    // render wall segment - this could be a portal
-                    // if it is a portal cell, first work out and store the info to push up the sub slice queue for later rendering
-
-                    // get a pointer to the face that was hit
-                    auxFacePtr = auxMapCellPtr->GetFacePtr( hitRec.nFaceHit );
-                    if (auxFacePtr->IsPortal()) {
-
-                        // prevent infinite refinement - only create new sub slice if it is significant
-                        if (nStopY > nStrtY) {
-
-                            // make sure you have a pointer to a FacePortal object
-                            RC_FacePortal *auxPortalFacePtr = (RC_FacePortal *)auxFacePtr;
-
-                            float fExitAngle_deg = auxPortalFacePtr->GetExitAngleDeg();     // angle of exit direction vector
-                            float fToAngle_deg   = auxPortalFacePtr->GetToAngle();          // orientation of other map
-                            float fDiffAngle_deg = fToAngle_deg - fExitAngle_deg;           // difference between those
-                            // we already got fVPAngle_deg from the slice render info
-                            float fOtherVPA_deg = mod360( fVPAngle_deg + fDiffAngle_deg );
-
-                            float fOtherViewA_deg = fViewAngle_deg;
-                            float fOtherCurA_deg = mod360( fOtherVPA_deg + fOtherViewA_deg );
-
-                            int nOtherMap = auxPortalFacePtr->GetToMap();
-                            int nOtherL   = auxPortalFacePtr->GetToLevel();
-                            int nOtherX   = auxPortalFacePtr->GetToX();
-                            int nOtherY   = auxPortalFacePtr->GetToY();
-
-                            int nDeltaX = nOtherX - int( hitRec.fHitX );
-                            int nDeltaY = nOtherY - int( hitRec.fHitY );
-                            int nDeltaZ = nOtherL - auxPortalFacePtr->GetFromLevel();
-
-                            float fOtherX, fOtherY, fOtherZ;
-                            switch ( auxPortalFacePtr->GetExitDir() ) {
-                                // in cases where you need to add 1.0f, add slightly less, to prevent out of bounds conditions
-                                case FACE_EAST : fOtherX = nOtherX;                fOtherY = hitRec.fHitY + nDeltaY; fOtherZ = fPh + nDeltaZ;break;
-                                case FACE_WEST : fOtherX = nOtherX + 0.99999f;     fOtherY = hitRec.fHitY + nDeltaY; fOtherZ = fPh + nDeltaZ;break;
-                                case FACE_SOUTH: fOtherX = hitRec.fHitX + nDeltaX; fOtherY = nOtherY;                fOtherZ = fPh + nDeltaZ;break;
-                                case FACE_NORTH: fOtherX = hitRec.fHitX + nDeltaX; fOtherY = nOtherY + 0.99999f;     fOtherZ = fPh + nDeltaZ;break;
-                                default: std::cout << "ERROR: RenderSubSlice() --> this exit direction does not implement" << std::endl;
-                            }
-
-                            // add a sub slice to the queue if there is a sub slice left
-                            // NOTE: the upper and lower boundaries will be clipped against the depth buffer afterwards
-                            if (nOspTopFrnt +1 < nOspBotFrnt - 1) {
-                                SubSliceRec aux = {
-                                    fOtherViewA_deg, fOtherCurA_deg, fOtherVPA_deg,
-                                    nOtherMap,
-                                    fOtherX, fOtherY, fOtherZ,
-                                    hitRec.fDistFrnt_corr,
-                                    nSlice, nOspTopFrnt + 1, nOspBotFrnt - 1,
-                                    nHorHght,
-                                    true
-                                };
-                                localSliceQueue.push_back( aux );
-                            }
-                        }
-                    }
-
-                    // now also render the wall part, this enables for transparent portals
-                    float fSampleX = -1.0f;
-                    for (int y = nOspTopFrnt + 1; y < nOspBotFrnt; y++) {
-
-                        // first get x sample coordinate from face hit info
-                        if (fSampleX == -1.0f) {
-                            switch (hitRec.nFaceHit) {
-                                case FACE_SOUTH:
-                                case FACE_NORTH: fSampleX = hitRec.fHitX - (float)hitRec.nHitX; break;
-                                case FACE_EAST :
-                                case FACE_WEST : fSampleX = hitRec.fHitY - (float)hitRec.nHitY; break;
-                                default        : std::cout << "ERROR: RenderSubSlice() --> invalid face value: " << hitRec.nFaceHit << std::endl;
-                            }
-                        }
-
-                        // the y sample coordinate depends only on the pixel y coord on the screen in relation to the vertical space the wall is taking up
-                        float fSampleY = hitRec.fHeight * float(y - hitRec.osp_top_frnt) / float(hitRec.osp_bot_frnt - hitRec.osp_top_frnt);
-                        // sample that block passing the face that was hit and the sample coordinates
-                        olc::Pixel sampledPixel = (auxMapCellPtr == nullptr) ? olc::MAGENTA : auxMapCellPtr->Sample( hitRec.nFaceHit, fSampleX, fSampleY );
-                        // shade the pixel
-                        olc::Pixel wallSample =  ShadePixel( sampledPixel, hitRec.fDistFrnt_corr );
-
-                        // either render or store for later rendering, depending on face transparency
-                        if (auxFacePtr->IsTransparent()) {
-                            DelayedPixel aux = { hitRec.fDistFrnt_corr / vDownAngleCos[y], nSlice, y, wallSample };
-                            vRenderLater.push( aux );
-                        } else {
-                            cDDrawer.Draw( hitRec.fDistFrnt_corr / vDownAngleCos[y], nSlice, y, wallSample );
-                        }
-                    }
-
-                    // get a pointer to the bottom face for ceiling rendering
-                    auxFacePtr = auxMapCellPtr->GetFacePtr( FACE_BOTTOM );
-                    // render ceiling segment if it's visible (if bot back <= bot front, ceiling is not visible and nothing will be rendered)
-                    for (int y = nOspBotFrnt; y <= nOspBotBack; y++) {
-                        float fRenderDistance;
-                        // the constant 0.0f is there since ceilings are not yet fractionally positioned
-                        olc::Pixel ceilSample = get_ceil_sample( nSlice, y, hitRec.nLayer, fStrtDist, 0.0f, fRenderDistance );   // shading is done in get_ceil_sample()
-
-                        // either render or store for later rendering, depending on face transparency
-                        if (auxFacePtr->IsTransparent()) {
-                            DelayedPixel aux = { fRenderDistance / vDownAngleCos[y], nSlice, y, ceilSample };
-                            vRenderLater.push( aux );
-                        } else {
-                            cDDrawer.Draw( fRenderDistance / vDownAngleCos[y], nSlice, y, ceilSample );
-                        }
-                    }
-                }
-            }
-
-            for (auto &elt : localSliceQueue) {
-
-                // check on the depth buffer if (pieces of) this sub slice is masked or not
-                while (cDDrawer.IsMasked( elt.nSlice, elt.nStrtY, elt.fStrtDist ) && elt.nStrtY != elt.nStopY ) {
-                    elt.nStrtY += 1;
-                }
-                while (cDDrawer.IsMasked( elt.nSlice, elt.nStopY, elt.fStrtDist ) && nOspTopFrnt != elt.nStopY) {
-                    elt.nStopY -= 1;
-                }
-                // draw this piece in magenta and set depth buffer to prevent overdrawing by farther away walls
-                for (int y = elt.nStrtY; y <= elt.nStopY; y++) {
-                    cDDrawer.Draw( elt.fStrtDist / vDownAngleCos[y], elt.nSlice, y, olc::MAGENTA );
-                }
-                // put elements of local slice queue into global slice queue (if any)
-                dSliceQ.push( elt );
-            }
-            localSliceQueue.clear();
-
-        }   // if slice queue not empty
-
-        // DELAYED WALL RENDERING for this slice (with masking of blank pixels)
-        // ======================
-        while (!vRenderLater.empty()) {
-            DelayedPixel elt = vRenderLater.pop();
-            if (elt.p != olc::BLANK) {
-                cDDrawer.Draw( elt.depth, elt.x, elt.y, elt.p );
-            }
-        }
-    }
-
-    // this var is used to keep track of door opening or closing
-    int nTestAnimState = ANIM_STATE_CLOSED;
-
-    bool OnUserUpdate( float fElapsedTime ) override {
-
-        // step 1 - user input
-        // ===================
-
-        nFrameCntr += 1;
-
-        // update cached versions of player coordinates
-        fPlayerX_cached = fPlayerX;
-        fPlayerY_cached = fPlayerY;
-        fPlayerH_cached = fPlayerH;
-
-        // For all movements and rotation you can speed up by keeping SHIFT pressed
-        // or speed down by keeping CTRL pressed. This also affects shading/lighting
-        float fSpeedUp = 1.0f;
-        if (GetKey( olc::SHIFT ).bHeld) fSpeedUp = 3.0f;
-        if (GetKey( olc::CTRL  ).bHeld) fSpeedUp = 0.2f;
-
-        // set test mode and test slice values
-        bTestMode |= GetKey( olc::Key::T ).bPressed;
-        if (GetKey( olc::Key::F1 ).bHeld) fTestSlice = std::max( fTestSlice - 40.0f * fElapsedTime * fSpeedUp,                 0.0f );
-        if (GetKey( olc::Key::F2 ).bHeld) fTestSlice = std::min( fTestSlice + 40.0f * fElapsedTime * fSpeedUp, ScreenWidth() - 1.0f );
-
-        // set per slice rendering mode and nr of slices to render per frame
-        if (GetKey( olc::Y ).bPressed) bSlicedRendering = !bSlicedRendering;
-        // control the nr of slices that are rendered in 1 frame - note this is only for the test phase
-        if (GetKey( olc::Key::F4 ).bPressed) { nSlicesPerFrame += 1;                                                 }
-        if (GetKey( olc::Key::F3 ).bPressed) { nSlicesPerFrame -= 1; if (nSlicesPerFrame < -5) nSlicesPerFrame = -5; }
-        if (GetKey( olc::Key::F6 ).bHeld   ) { nSlicesPerFrame += 1;                                                 }
-        if (GetKey( olc::Key::F5 ).bHeld   ) { nSlicesPerFrame -= 1; if (nSlicesPerFrame < -5) nSlicesPerFrame = -5; }
-
-        // reset look up value and player height on pressing 'R'
-        if (GetKey( olc::R ).bReleased) { fPlayerH = 0.5f; fPlayerLU = 0.0f; }
-
-        // toggles for HUDs
-        if (GetKey( olc::U ).bPressed) bProcessInfo = !bProcessInfo;
-        if (GetKey( olc::I ).bPressed) bPlayerInfo  = !bPlayerInfo;
-        if (GetKey( olc::P ).bPressed) bMinimap     = !bMinimap;
-        if (GetKey( olc::O ).bPressed) bMapRays     = !bMapRays;
-        // toggles for on screen orientation lines
-        if (GetKey( olc::G ).bPressed) bTestSlice   = !bTestSlice;
-        if (GetKey( olc::H ).bPressed) bTestGrid    = !bTestGrid;
-
-        // Rotate - collision detection not necessary. Keep fPlayerA_deg between 0 and 360 degrees
-        if (GetKey( olc::D ).bHeld) { fPlayerA_deg += SPEED_ROTATE * fSpeedUp * fElapsedTime; if (fPlayerA_deg >= 360.0f) fPlayerA_deg -= 360.0f; }
-        if (GetKey( olc::A ).bHeld) { fPlayerA_deg -= SPEED_ROTATE * fSpeedUp * fElapsedTime; if (fPlayerA_deg <    0.0f) fPlayerA_deg += 360.0f; }
-        // Rotate to discrete angle
-        if (GetKey( olc::NP6 ).bPressed) { fPlayerA_deg =   0.0f; }
-        if (GetKey( olc::NP3 ).bPressed) { fPlayerA_deg =  45.0f; }
-        if (GetKey( olc::NP2 ).bPressed) { fPlayerA_deg =  90.0f; }
-        if (GetKey( olc::NP1 ).bPressed) { fPlayerA_deg = 135.0f; }
-        if (GetKey( olc::NP4 ).bPressed) { fPlayerA_deg = 180.0f; }
-        if (GetKey( olc::NP7 ).bPressed) { fPlayerA_deg = 225.0f; }
-        if (GetKey( olc::NP8 ).bPressed) { fPlayerA_deg = 270.0f; }
-        if (GetKey( olc::NP9 ).bPressed) { fPlayerA_deg = 315.0f; }
-
-        // variables used for collision detection - work out the new location in a separate coordinate pair, and only alter
-        // the players coordinate if there's no collision
-        float fNewX = fPlayerX;
-        float fNewY = fPlayerY;
-
-        // walking forward, backward and strafing left, right
-        if (GetKey( olc::W ).bHeld) { fNewX += lu_cos( fPlayerA_deg ) * SPEED_MOVE   * fSpeedUp * fElapsedTime; fNewY += lu_sin( fPlayerA_deg ) * SPEED_MOVE   * fSpeedUp * fElapsedTime; }   // walk forward
-        if (GetKey( olc::S ).bHeld) { fNewX -= lu_cos( fPlayerA_deg ) * SPEED_MOVE   * fSpeedUp * fElapsedTime; fNewY -= lu_sin( fPlayerA_deg ) * SPEED_MOVE   * fSpeedUp * fElapsedTime; }   // walk backwards
-
-        if (GetKey( olc::Q ).bHeld) { fNewX += lu_sin( fPlayerA_deg ) * SPEED_STRAFE * fSpeedUp * fElapsedTime; fNewY -= lu_cos( fPlayerA_deg ) * SPEED_STRAFE * fSpeedUp * fElapsedTime; }   // strafe left
-        if (GetKey( olc::E ).bHeld) { fNewX -= lu_sin( fPlayerA_deg ) * SPEED_STRAFE * fSpeedUp * fElapsedTime; fNewY += lu_cos( fPlayerA_deg ) * SPEED_STRAFE * fSpeedUp * fElapsedTime; }   // strafe right
-        // collision detection - only update position if no collision
-        if (!vMaps[ nActiveMap ].Collides( fNewX, fNewY, fPlayerH, RADIUS_PLAYER, 0.0f, 0.0f )) {
-            fPlayerX = fNewX;
-            fPlayerY = fNewY;
-        }
-
-        // looking up or down - collision detection not necessary
-        // NOTE - there's no clamping to extreme values (yet)
-        if (GetKey( olc::UP   ).bHeld) { fPlayerLU += SPEED_LOOKUP * fSpeedUp * fElapsedTime; }
-        if (GetKey( olc::DOWN ).bHeld) { fPlayerLU -= SPEED_LOOKUP * fSpeedUp * fElapsedTime; }
-
-        // flying or crouching
-        // NOTE - for multi layer rendering there's only clamping to keep fPlayerH > 0.0f, there's no upper limit.
-
-        // cache current height of horizon, so that you can compensate for changes in it via the look up value
-        float fCacheHorHeight = float( ScreenHeight() * fPlayerH ) + fPlayerLU;
-        if (MULTI_LAYERS) {
-            // if the player height is adapted, keep horizon height stable by compensating with look up value
-            if (GetKey( olc::PGUP ).bHeld) {
-                float fNewHeight = fPlayerH + SPEED_STRAFE_UP * fSpeedUp * fElapsedTime;
-                // do CD on the height map - player velocity is not relevant since movement is up/down
-                if (!vMaps[ nActiveMap ].Collides( fPlayerX, fPlayerY, fNewHeight, 0.1f, 0.0f, 0.0f )) {
-                    fPlayerH = fNewHeight;
-                    fPlayerLU = fCacheHorHeight - float( ScreenHeight() * fPlayerH );
-                }
-            }
-            if (GetKey( olc::PGDN ).bHeld) {
-                float fNewHeight = fPlayerH - SPEED_STRAFE_UP * fSpeedUp * fElapsedTime;
-                // prevent negative height, and do CD on the height map - player velocity is not relevant since movement is up/down
-                if (!vMaps[ nActiveMap ].Collides( fPlayerX, fPlayerY, fNewHeight, 0.1f, 0.0f, 0.0f )) {
-                    fPlayerH  = fNewHeight;
-                    fPlayerLU = fCacheHorHeight - float( ScreenHeight() * fPlayerH );
-                }
-            }
-        } else {
-            if (GetKey( olc::PGUP ).bHeld) {
-                float fNewHeight = fPlayerH + SPEED_STRAFE_UP * fSpeedUp * fElapsedTime;
-                if (fNewHeight < 1.0f) {
-                    fPlayerH = fNewHeight;
-                    // compensate look up value so that horizon remains stable
-                    fPlayerLU = fCacheHorHeight - float( ScreenHeight() * fPlayerH );
-                }
-            }
-            if (GetKey( olc::PGDN ).bHeld) {
-                float fNewHeight = fPlayerH - SPEED_STRAFE_UP * fSpeedUp * fElapsedTime;
-                if (fNewHeight > 0.0f) {
-                    fPlayerH = fNewHeight;
-                    // compensate look up value so that horizon remains stable
-                    fPlayerLU = fCacheHorHeight - float( ScreenHeight() * fPlayerH );
-                }
-            }
-        }
-
-        // alter object intensity and multiplier - for shading
-        if (GetKey( olc::INS  ).bHeld) fObjectIntensity     += INTENSITY_SPEED * fSpeedUp * fElapsedTime;
-        if (GetKey( olc::DEL  ).bHeld) fObjectIntensity     -= INTENSITY_SPEED * fSpeedUp * fElapsedTime;
-        if (GetKey( olc::HOME ).bHeld) fIntensityMultiplier += INTENSITY_SPEED * fSpeedUp * fElapsedTime;
-        if (GetKey( olc::END  ).bHeld) fIntensityMultiplier -= INTENSITY_SPEED * fSpeedUp * fElapsedTime;
-
-
-        // step 2 - game logic
-        // ===================
-
-        bool bStateChanged = false;
-        // directly setting to opened or closed is not useful. State can only become Opening if it was closed, and vice versa
-        if (GetKey( olc::F6 ).bPressed) { bStateChanged = true; nTestAnimState = ANIM_STATE_CLOSING; }
-        if (GetKey( olc::F5 ).bPressed) { bStateChanged = true; nTestAnimState = ANIM_STATE_OPENING; }
-
-        // little lambda returns whether distance between b and c is <= a (note - sqrt not needed here)
-        auto within_distance = [=]( int a, int b, int c ) {
-            return (b * b + c * c) <= (a * a);
-        };
-        // iterate over all the map cells in the map
-        // the break out bool is needed in case a portal transition occurs, which should
-        // abruptly stop the updating since the player stepped into another map and the player variables
-        // (and loop control variables) are not valid in the current map anymore
-        bool bBreakOut = false;
-        for (int h = 0; h < vMaps[ nActiveMap ].NrOfLayers() && !bBreakOut; h++) {
-            for (int y = 0; y < vMaps[ nActiveMap ].GetHeight() && !bBreakOut; y++) {
-                for (int x = 0; x < vMaps[ nActiveMap ].GetWidth() && !bBreakOut; x++) {
-
-                    // grab a pointer to the current map cell
-                    RC_MapCell *pMapCell = vMaps[ nActiveMap ].MapCellPtrAt( x, y, h );
-                    if (!pMapCell->IsEmpty()) {
-                        // update this map cell (this will update all it's faces)
-                        bool bTmp = pMapCell->IsPermeable();
-                        pMapCell->Update( fElapsedTime, bTmp );
-                        pMapCell->SetPermeable( bTmp );
-
-                        // test code for manually changing state of animated faces
-                        for (int i = 0; i < FACE_NR_OF && !bBreakOut; i++) {
-                            RC_Face *facePtr = pMapCell->GetFacePtr( i );
-                            if (facePtr->IsAnimated()) {
-                                // only trigger gate if close enough
-                                if (bStateChanged &&
-                                    within_distance( SENSE_RADIUS, x + 0.5f - fPlayerX, y + 0.5f - fPlayerY )) {
-                                    // You must cast to RC_FaceAnimated * to get the function working properly...
-                                    ((RC_FaceAnimated *)facePtr)->SetState( nTestAnimState );
-                                }
-                            } else if (facePtr->IsPortal()) {
-
-                                // check if player should cross over through the portal
-                                RC_FacePortal *portalFacePtr = (RC_FacePortal *)facePtr;
-                                if (
-                                    portalFacePtr->HasCrossedPortal(
-                                        fPlayerH_cached, fPlayerX_cached, fPlayerY_cached,
-                                        fPlayerH       , fPlayerX       , fPlayerY       ,
-                                        h              , x              , y
-                                    )
-                                ) {
-                                    // perform the cross over to the other side of the portal
-
-                                    // work out new view point angle (could be defected in portal)
-                                    float fExitAngle_deg = portalFacePtr->GetExitAngleDeg();     // angle of exit direction vector
-                                    float fToAngle_deg   = portalFacePtr->GetToAngle();          // orientation of other map
-                                    float fDiffAngle_deg = fToAngle_deg - fExitAngle_deg; // difference between those
-                                    float fVPAngle_deg   = fPlayerA_deg;                  // current view point angle
-
-                                    float fOtherVPA_deg = mod360( fVPAngle_deg + fDiffAngle_deg );
-
-                                    int nOtherMap = portalFacePtr->GetToMap();
-                                    int nOtherL   = portalFacePtr->GetToLevel();
-                                    int nOtherX   = portalFacePtr->GetToX();
-                                    int nOtherY   = portalFacePtr->GetToY();
-                                    float fOtherL = fPlayerH - int(fPlayerH) + nOtherL;
-                                    float fOtherX = fPlayerX - int(fPlayerX) + nOtherX;
-                                    float fOtherY = fPlayerY - int(fPlayerY) + nOtherY;
-
-                                    std::cout << "Map transition from map: " << nActiveMap
-                                                           << ", position (" << x
-                                                           << ", "           << y
-                                                           << ", "           << h
-                                                           << "), angle (deg): "   << fVPAngle_deg
-                                               << " to: " << nOtherMap
-                                                           << ", position (" << nOtherX
-                                                           << ", "           << nOtherY
-                                                           << ", "           << nOtherL
-                                                           << "), angle (deg): "   << fOtherVPA_deg
-                                               << std::endl;
-
-                                    int nCacheHorHght = ScreenHeight() * fPlayerH + (int)fPlayerLU;
-                                    if (int(fPlayerH) != nOtherL) {   // the transition implies a layer change
-                                        // player moves vertically, compensate the fPlayerLU to keep horizon stable
-                                        fPlayerLU = nCacheHorHght - float( ScreenHeight() * fOtherL );
-                                    }
-
-                                    nActiveMap   = nOtherMap;
-                                    fPlayerH     = fOtherL;
-                                    fPlayerX     = fOtherX;
-                                    fPlayerY     = fOtherY;
-                                    fPlayerA_deg = fOtherVPA_deg;
-
-                                    bBreakOut = true;
-                                }
-                            }
-                        } // iterate faces
-                    } // else - block is empty, skip it
-                } // iterate x
-            } // iterate y
-        } // iterate layers
-
-        // update all objects in active map
-        for (auto &elt : vMaps[nActiveMap].vListObjects) {
-            elt.Update( &vMaps[ nActiveMap ], fElapsedTime );
-        }
-
-        // step 3 - render
-        // ===============
-
-
-        // WALL RENDERING (aka BACK GROUND SCENE rendering)
-        // ==============
-
-        // typically, the horizon height is halfway the screen height. However, you have to offset with look up value,
-        // and the viewpoint of the player is variable too (since flying and crouching)
-        int nHorizonHeight = ScreenHeight() * fPlayerH + (int)fPlayerLU;
-
-        // having set the horizon height, determine the cos of all the angles through each of the pixels in this slice
-        std::vector<float> fHeightAngleCos( ScreenHeight() );
-        for (int y = 0; y < ScreenHeight(); y++) {
-            fHeightAngleCos[y] = std::abs( lu_cos( (y - nHorizonHeight) * fAnglePerPixel_deg ));
-        }
-
-        // this is temporary test code to make sliced rendering possible
-        if (dSliceQueue.empty()) {
-
-            // sub slice queue got empty, fill it
-        // iterate over all screen slices, processing the screen in columns
-        for (int x = 0; x < ScreenWidth(); x++) {
-                float fViewAngle_deg = float( x - (ScreenWidth() / 2)) * fAnglePerPixel_deg;
-            float fCurAngle_deg = fPlayerA_deg + fViewAngle_deg;
-
-                // enqueue the inital slices
-                SubSliceRec tmp = {
-                    fViewAngle_deg, fCurAngle_deg, fPlayerA_deg,
-                    nActiveMap, fPlayerX, fPlayerY, fPlayerH,
-                    0.0f,
-                    x, 0, ScreenHeight() - 1,
-                    nHorizonHeight,
-                    true
-                };
-                dSliceQueue.push( tmp );
-            }
-        }
-
-        if (nSlicesPerFrame >= 0 || !bSlicedRendering) {
-            // if bSlicedRendering is false, this loop will process until slice queue is empty
-            for (int i = 0; (i < nSlicesPerFrame || !bSlicedRendering) && !dSliceQueue.empty(); i++) {
-
-                SubSliceRec &curSubSlice = dSliceQueue.front();
-                // render a small nr of slices per frame
-                nActiveSlice = curSubSlice.nSlice;
-                if (curSubSlice.bResetSlice) {
-                    cDDrawer.Reset( nActiveSlice, curSubSlice.nStrtY, curSubSlice.nStopY );
-                }
-                RenderSubSlice( dSliceQueue, fHeightAngleCos );
-            }
-        } else {
-            if (nFrameCntr % -nSlicesPerFrame == 0) {
-
-                SubSliceRec &curSubSlice = dSliceQueue.front();
-                // render a small nr of slices per frame
-                nActiveSlice = curSubSlice.nSlice;
-                if (curSubSlice.bResetSlice) {
-                    cDDrawer.Reset( nActiveSlice, curSubSlice.nStrtY, curSubSlice.nStopY );
-                }
-                RenderSubSlice( dSliceQueue, fHeightAngleCos );
-            }
-        }
-
-
-        // OBJECT RENDERING
-        // ================
-
-        // display all objects after the background rendering and before displaying the minimap or debugging output
-        // split the rendering into two phase so that it can be sorted on distance (painters algo) before rendering
-
-        // phase 1 - just determine distance (and angle cause of convenience)
-        for (auto &object : vMaps[nActiveMap].vListObjects) {
-
-            // work out distance and angle between object and player, and
-            // store it in the object itself
-            object.PrepareRender( fPlayerX, fPlayerY, fPlayerA_deg );
-        }
-
-        // sort farthest object first (for painters algo)
-        vMaps[nActiveMap].vListObjects.sort(
-            [=]( RC_Object &a, RC_Object &b ) {
-                return a.GetDistToPlayer() > b.GetDistToPlayer();
-            }
-        );
-
-        // phase 2: render object
-        for (auto &object : vMaps[nActiveMap].vListObjects) {
-            object.Render( cDDrawer, fPlayerH, fPlayerFoV_rad, fMaxDistance, nHorizonHeight );
-        }
-
-        // TEST STUFF RENDERING
-        // ====================
-
-        // to aim the slice that is output on testmode
-        if (bTestSlice) {
-            DrawLine( int( fTestSlice ), 0, int( fTestSlice ), ScreenHeight() - 1, olc::MAGENTA );
-        }
-
-        // horizontal grid lines for testing
-        if (bTestGrid) {
-            for (int i = 0; i < ScreenHeight(); i+= 100) {
-                for (int j = 0; j < 100; j+= 10) {
-                    DrawLine( 0, i + j, ScreenWidth() - 1, i + j, olc::BLACK );
-                }
-                DrawLine( 0, i, ScreenWidth() - 1, i, olc::DARK_GREY );
-                DrawString( 0, i - 5, std::to_string( i ), olc::WHITE );
-            }
-        }
-
-        // MINIMAP & HUD RENDERING
-        // =======================
-
-        if (bMinimap) {
-            RenderMap( 0 );
-            if (bMapRays) {
-                RenderMapRays( int( fPlayerH ));
-            }
-            RenderMapPlayer();
-            RenderMapObjects();
-
-            vRayList.clear();
-        }
-
-        if (bPlayerInfo) {
-            RenderPlayerInfo();
-        }
-
-        if (bProcessInfo) {
-            RenderProcessInfo();
-        }
-
-        return true;
-    }
-
-    bool OnUserDestroy() {
-
-		for (int i = 0; i < (int)vMaps.size(); i++) {
-	        vMaps[i].FinalizeMap();
-		}
-
-        return true;
-    }
-};
-
-int main()
-{
-	MyRayCaster demo;
-	if (demo.Construct( SCREEN_X / PIXEL_SIZE, SCREEN_Y / PIXEL_SIZE, PIXEL_SIZE, PIXEL_SIZE ))
-		demo.Start();
-
-	return 0;
-}
-
-//////////////////////////////////   put bloat behind main()  /////////////////////////////////
-
-// ==============================/   Mini map rendering stuff   /==============================
-
-// function to render the mini map on the screen
-void MyRayCaster::RenderMap( int nRenderLevel ) {
-
-    auto local_map_cell_height = [=]( int nLayer, int x, int y ) {
-        if (nLayer < 0) return vMaps[ nActiveMap ].CellHeight( x, y );
-        if (nLayer > vMaps[ nActiveMap ].NrOfLayers()) return 0.0f;
-        return vMaps[ nActiveMap ].CellHeightAt( x, y, nRenderLevel );
-    };
-    // fill background for minimap
-    float fMMFactor = MINIMAP_SCALE_FACTOR * MINIMAP_TILE_SIZE;
-    FillRect( 0, 0, vMaps[ nActiveMap ].GetWidth() * fMMFactor, vMaps[ nActiveMap ].GetHeight() * fMMFactor, COL_HUD_BG );
-    // draw each tile
-    for (int y = 0; y < vMaps[ nActiveMap ].GetHeight(); y++) {
-        for (int x = 0; x < vMaps[ nActiveMap ].GetWidth(); x++) {
-            // colour different for different heights
-            olc::Pixel p;
-            bool bBorderFlag = true;
-            if (local_map_cell_height( nRenderLevel, x, y ) == 0.0f) {
-                p = COL_HUD_BG;   // don't visibly render
-                bBorderFlag = false;
-            } else if (local_map_cell_height( nRenderLevel, x, y )  <  1.0f) {
-                p = olc::PixelF( vMaps[ nActiveMap ].CellHeight( x, y ), 0.0f, 0.0f );    // height < 1.0f = shades of red
-            } else {
-                float fColFactor = std::min( vMaps[ nActiveMap ].CellHeight( x, y ) / 4.0f + 0.5f, 1.0f );    // heights > 1.0f = shades of blue
-                p = olc::PixelF( 0.0f, 0.0f, fColFactor );
-            }
-            // render this tile
-            FillRect( x * fMMFactor + 1, y * fMMFactor + 1, fMMFactor - 1, fMMFactor - 1, p );
-
-            if (bBorderFlag) {
-                p = olc::WHITE;
-                DrawRect( x * fMMFactor, y * fMMFactor, fMMFactor, fMMFactor, p);
-
-                RC_MapCell *pMapCellPtr = vMaps[ nActiveMap ].MapCellPtrAt( x, y, 0 );
-                for (int i = FACE_EAST; i < FACE_TOP; i++) {
-                    RC_Face *auxFptr = pMapCellPtr->GetFacePtr( i );
-                    if (auxFptr->IsPortal()) {
-                        switch (i) {
-                            case FACE_EAST:  DrawLine( (x + 1) * fMMFactor,  y      * fMMFactor, (x + 1) * fMMFactor, (y + 1) * fMMFactor, olc::RED ); break;
-                            case FACE_NORTH: DrawLine(  x      * fMMFactor,  y      * fMMFactor, (x + 1) * fMMFactor,  y      * fMMFactor, olc::RED ); break;
-                            case FACE_WEST:  DrawLine(  x      * fMMFactor,  y      * fMMFactor,  x      * fMMFactor, (y + 1) * fMMFactor, olc::RED ); break;
-                            case FACE_SOUTH: DrawLine(  x      * fMMFactor, (y + 1) * fMMFactor, (x + 1) * fMMFactor, (y + 1) * fMMFactor, olc::RED ); break;
-                        }
-                    }
-                }
-            }
-        }
-    }
-}
-
-// function to render the player in the mini map on the screen
-void MyRayCaster::RenderMapPlayer() {
-    float fMMFactor = MINIMAP_TILE_SIZE * MINIMAP_SCALE_FACTOR;
-    olc::Pixel p = olc::YELLOW;
-    float px = fPlayerX * fMMFactor;
-    float py = fPlayerY * fMMFactor;
-    float pr = 0.6f     * fMMFactor;
-
-    // draw sense radius around player - let it blend to get it semi-transparent
-    SetPixelBlend( SENSE_BLENDF );
-    SetPixelMode( olc::Pixel::ALPHA );
-    FillCircle( px, py, SENSE_RADIUS * fMMFactor, olc::DARK_GREY );
-    SetPixelMode( olc::Pixel::NORMAL );
-
-    // Draw player object itself
-    FillCircle( px, py, pr, p );
-    // Draw player direction pointer
-    float dx = lu_cos( fPlayerA_deg );
-    float dy = lu_sin( fPlayerA_deg );
-    float pdx = dx * 2.0f * fMMFactor;
-    float pdy = dy * 2.0f * fMMFactor;
-    DrawLine( px, py, px + pdx, py + pdy, p );
-}
-
-// function to render the rays in the mini map on the screen
-void MyRayCaster::RenderMapRays( int nPlayerLevel ) {
-    // choose different colour for each layer
-    auto get_layer_col = [=]( int nLvl ) {
-        olc::Pixel result = olc::WHITE;
-        switch (nLvl) {
-            case 0 : result = olc::GREEN;   break;
-            case 1 : result = olc::RED;     break;
-            case 2 : result = olc::BLUE;    break;
-            case 3 : result = olc::GREY;    break;
-            case 4 : result = olc::MAGENTA; break;
-            default: result = olc::YELLOW;  break;
-        }
-        return result;
-    };
-
-    float fMMFactor = MINIMAP_TILE_SIZE * MINIMAP_SCALE_FACTOR;
-    // draw an outline of the visible part of the world
-    // use a different colour per layer
-    olc::Pixel layerCol = get_layer_col( nPlayerLevel );
-    for (auto &elt : vRayList) {
-    if (elt.layer == nPlayerLevel) {
-            DrawLine(
-            elt.pointA.x * fMMFactor,
-            elt.pointA.y * fMMFactor,
-            elt.pointB.x * fMMFactor,
-            elt.pointB.y * fMMFactor,
-                layerCol
-            );
-        }
-    }
-}
-
-// function to render all the objects in the mini map on the screen
-void MyRayCaster::RenderMapObjects() {
-    float fMMFactor = MINIMAP_TILE_SIZE * MINIMAP_SCALE_FACTOR;
-    for (auto &elt : vMaps[nActiveMap].vListObjects) {
-
-        olc::Pixel p = (elt.bStationary ? olc::RED : olc::MAGENTA);
-
-        float px = elt.GetX() * fMMFactor;
-        float py = elt.GetY() * fMMFactor;
-        float pr = 0.4f  * fMMFactor;
-        FillCircle( px, py, pr, p );
-
-        if (!elt.bStationary) {
-            float dx = lu_cos( rad2deg( elt.GetAngle()));
-            float dy = lu_sin( rad2deg( elt.GetAngle()));
-            float pdx = dx * 0.3f * elt.GetSpeed() * fMMFactor;
-            float pdy = dy * 0.3f * elt.GetSpeed() * fMMFactor;
-            DrawLine( px, py, px + pdx, py + pdy, p );
-        }
-    }
-}
-
-// function to render player info in a separate hud on the screen
-void MyRayCaster::RenderPlayerInfo() {
-    int nStartX = ScreenWidth() - 200;
-    int nStartY =  10;
-    // render background pane for debug info
-    FillRect( nStartX, nStartY, 190, 65, COL_HUD_BG );
-    // output player and rendering values for debugging
-    DrawString( nStartX + 5, nStartY +   5, "X      = " + std::to_string( fPlayerX     ), COL_HUD_TXT );
-    DrawString( nStartX + 5, nStartY +  15, "Y      = " + std::to_string( fPlayerY     ), COL_HUD_TXT );
-    DrawString( nStartX + 5, nStartY +  25, "H      = " + std::to_string( fPlayerH     ), COL_HUD_TXT );
-    DrawString( nStartX + 5, nStartY +  35, "Angle  = " + std::to_string( fPlayerA_deg ), COL_HUD_TXT );
-    DrawString( nStartX + 5, nStartY +  55, "LookUp = " + std::to_string( fPlayerLU    ), COL_HUD_TXT );
-}
-
-// function to render performance info in a separate hud on the screen
-void MyRayCaster::RenderProcessInfo() {
-    int nStartX = ScreenWidth()  - 200;
-    int nStartY = ScreenHeight() - 200;
-    // render background pane for debug info
-    FillRect( nStartX, nStartY, 195, 160, COL_HUD_BG );
-    // output player and rendering values for debugging
-    DrawString( nStartX + 5, nStartY +  5, "Intensity  = " + std::to_string( fObjectIntensity        ), COL_HUD_TXT );
-    DrawString( nStartX + 5, nStartY + 15, "Multiplier = " + std::to_string( fIntensityMultiplier    ), COL_HUD_TXT );
-
-    DrawString( nStartX + 5, nStartY +  35, "Slice Q size = " + std::to_string( (int)dSliceQueue.size()), COL_HUD_TXT );
-    DrawString( nStartX + 5, nStartY +  45, "Active slice = " + std::to_string( nActiveSlice           ), COL_HUD_TXT );
-    DrawString( nStartX + 5, nStartY +  55, "Test slice   = " + std::to_string( int( fTestSlice )      ), COL_HUD_TXT );
-
-    DrawString( nStartX + 5, nStartY +  75, "Acive map    = " + std::to_string( nActiveMap                      ), COL_HUD_TXT );
-    DrawString( nStartX + 5, nStartY +  85, "Map size - X = " + std::to_string( vMaps[ nActiveMap ].GetWidth()  ), COL_HUD_TXT );
-    DrawString( nStartX + 5, nStartY +  95, "Map size - Y = " + std::to_string( vMaps[ nActiveMap ].GetHeight() ), COL_HUD_TXT );
-    DrawString( nStartX + 5, nStartY + 105, "Map size - Z = " + std::to_string( vMaps[ nActiveMap ].NrOfLayers()), COL_HUD_TXT );
-    DrawString( nStartX + 5, nStartY + 115, "# Objects    = " + std::to_string( (int)vMaps[nActiveMap].vListObjects.size()), COL_HUD_TXT );
-
-    DrawString( nStartX + 5, nStartY + 135, (bSlicedRendering ? "sliced rendering ON" : "sliced rendering OFF"), COL_HUD_TXT );
-    DrawString( nStartX + 5, nStartY + 145, "slices/frame = " + std::to_string( nSlicesPerFrame ), COL_HUD_TXT );
-
-}
-
-// Shade the pixel p using fDistance as a factor in the shade formula
-olc::Pixel MyRayCaster::ShadePixel( const olc::Pixel &p, float fDistance ) {
-    if (RENDER_SHADED) {
-        float fShadeFactor = std::max( SHADE_FACTOR_MIN, std::min( SHADE_FACTOR_MAX, fObjectIntensity * ( fIntensityMultiplier /  fDistance )));
-        return p * fShadeFactor;
-    } else
-        return p;
-}
-
-// ==============================/  end of file   /==============================
-
+// ELABORATING ON - Ray casting tutorial by Permadi
+// (starting with part 20 all code files are my own elaboration on the Permadi basis)
+//
+// Implementation of part 25 h - portal rendering with queued (instead of recursive) sub slice rendering
+//
+// Joseph21, july 5, 2023
+//
+// Dependencies:
+//   *  olcPixelGameEngine.h - (olc::PixelGameEngine header file) by JavidX9 (see: https://github.com/OneLoneCoder/olcPixelGameEngine)
+//   *  sprite files for texturing walls, roofs, floor and ceiling, as well as objects in the scene: use your own .png files and
+//      adapt the file names and paths in "map_16x16.h"
+//   *  include file "map_16x16.h" - contains the map definitions and the sprite file names
+
+/* Short description
+   -----------------
+   This implementation is a follow up of implementation part 25 g. See the description of that implementation as well (and check on
+   the differences between that cpp file and this one).
+
+   I rewrote the portal rendering code into a version that uses a queue instead of recursion. The idea being that it would give me more
+   control over the rendering order etc.
+
+   Summary of the changes I made:
+     * main.cpp
+         + Created two simple new modules t_queue.h and t_stack.h. These are templated
+         + I removed the recursion statistics and wrote some test code to render 1 sub slice per frame
+         + I also rewrote the DDA function to be as simple and straightforward as possible. The intelligence was put into a post filter function that is used to post process the output of the dda function. This design choice was made to give me more grip on the rendering process, and to split the DDA from the process of skipping or filtering irrelevant nodes.
+         + Made some improvements on the sampler lambda's for roofs and ceilings to improve wonky rendering bug.
+         + Got rid of the erase/remove_if idiom in OnUserUpdate(), since this is now put in the post filter function
+         + Experimented somewhat with the exact boundaries between roof and wall and between wall and ceiling. Either way there seem to be rounding errors...
+         + I added code in the slide renderer to clip the portal sub slice if it is masked by stuff that is closer by according to the depth buffer.
+     * RC_DepthDrawer
+         + Had to add two more functions, to reset only part of a depth buffer slice, and to check if a particular pixel is masking a given depth
+
+[ NOTE that I should use the same criteria for resetting subslice as I should for testing / rendering roofs, ceilings and walls ]
+
+   Have fun!
+ */
+
+#include <cfloat>       // needed for constant FLT_MAX in the DDA function
+#include <climits>      // needed for constant INT_MAX in the DDA functions
+#include <chrono>       // needed for timing in the benchmark functions
+#include <fstream>      // needed for the reference file of the fixed point DDA check
+#include <cstring>      // needed for memcpy() in the hashing of hit lists
+#include <atomic>       // needed for the work item counter of the parallel rendering
+#include <mutex>        // needed for the idle threads of the parallel rendering
+#include <condition_variable>
+
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+
+#include "t_queue.h"
+#include "t_wsdeque.h"
+
+// ==============================/  specific include files   /==============================
+
+#include "RC_Screen.h"
+#include "RC_Misc.h"
+#include "RC_Face.h"
+#include "RC_MapCell.h"
+#include "RC_Map.h"
+#include "RC_DepthDrawer.h"
+#include "RC_Object.h"
+#include "RC_RayQuery.h"
+#include "RC_ThreadPool.h"
+
+// ==============================/  constants   /==============================
+
+#define MULTI_LAYERS      true
+#define RENDER_CEILING       !MULTI_LAYERS    // render ceilings only for single layer world
+
+// DDA constants
+#define DDA_SINGLE_PASS      true    // traverse the grid once per ray for all layers, instead of once per layer
+#define DDA_SKIP_EMPTY       true    // use the distance fields of the map to skip across empty areas
+#define DDA_SKIP_BLOCKS      true    // use the occupancy pyramid of the map to skip across empty blocks
+#define DDA_FUSED_FILTER     true    // let the (single pass) DDA only emit boundary hit points, instead of post filtering the hit lists
+#define DDA_FIXED_POINT      false   // step the DDA in 16.16 fixed point instead of float (gives reproducible hit lists)
+#define DDA_TEMPORAL_REUSE   true    // keep the hit lists of the (first level) rays over frames, and reuse them if the player only rotates (single pass DDA only)
+#define DDA_OCCLUSION        true    // stop a ray once opaque walls cover its whole sub slice on screen (fused single pass DDA only)
+#define DDA_LAYER_CULLING    true    // don't cast and render the layers that project completely outside of a sub slice on screen
+#define DDA_ADAPTIVE_COLUMNS true    // cast the (first level) rays on a coarse column stride, and fill in the columns in between if the hit lists agree (fused filter only)
+
+#define RENDER_FLOOR_ROWS    true    // render the floor of the first level sub slices row by row after the walls, instead of per column (not in progressive mode)
+#define RENDER_FLATS_HALF_RATE false // sample floors, roofs and ceilings on a checkerboard pattern, and fill in the other pixels from their neighbours (trigger key C)
+#define RENDER_INTERLEAVED   false   // render the even and odd screen columns on alternating frames, and reproject the others from the previous frame (trigger key N)
+#define DYNAMIC_RESOLUTION   false   // scale the render resolution to keep the frame time within RESOLUTION_BUDGET_MS (trigger key X)
+#define RENDER_DEFERRED      false   // draw the walls and flats unshaded, and shade the whole frame in one pass afterwards (not in progressive mode) (trigger key M)
+
+#define INTERLEAVE_MAX_MOVE     0.5f    // the previous frame is only reprojected if the player moved less than this (in cells) ...
+#define INTERLEAVE_MAX_TURN    10.0f    // ... and turned less than this (in degrees)
+#define INTERLEAVE_SAME_SURFACE 0.05f   // reprojected pixels that are adjacent in a column are on the same surface if their depths differ less than this fraction
+
+#define RESOLUTION_BUDGET_MS   16.7f    // frame time that the dynamic resolution aims at
+#define RESOLUTION_MIN_SCALE    0.25f   // the render resolution is scaled between this fraction of the screen resolution and the full resolution
+#define RESOLUTION_MIN_STEP     0.05f   // smaller scale changes are not applied, to keep the resolution from oscillating
+#define RESOLUTION_SETTLE      10       // nr of frames after a resolution change before the frame time is evaluated again
+
+#define RENDER_THREADS         -1    // nr of threads to render the screen columns with (-1 means: the nr of hardware threads)
+#define RENDER_CHUNK_SIZE      16    // nr of adjacent screen columns a render thread takes at a time
+
+#define PROGRESSIVE_BUDGET_MS   8.0f    // default time budget per frame (in milliseconds) for the progressive rendering (trigger key Y)
+#define PROGRESSIVE_BUDGET_MIN  1.0f    // the budget can be altered using F3 and F4, but not below this value
+
+#define PIPELINE_STAGES      true    // render the snapshot of the previous frame while the next frame is updated (trigger key L)
+
+#define ADAPTIVE_COLUMN_STRIDE  8    // column stride of the coarse rays for the adaptive column subdivision
+#define ADAPTIVE_MAX_DIST_MARGIN 2.0f    // columns are only filled in if all their hit points are at least this far within the max ray length
+
+// fixed point constants for the DDA. The values have 16 fractional bits, but are stored in 64 bit integers to have a large range
+#define FIXED_SHIFT            16
+#define FIXED_ONE            (int64_t( 1 ) << FIXED_SHIFT)
+#define FIXED_MAX            (int64_t( 1 ) << 40)    // scaling factors are clamped to this (i.e. 2^24 cells), to prevent overflow
+
+// map editing constants
+#define EDIT_CELL_MAX_DIST     4.0f    // wall blocks can be removed (trigger key Z) or placed (trigger key F) up to this distance from the player
+
+// fog constants
+#define FOG_START_FACTOR     0.5f    // the fog starts at this fraction of the draw distance of a map, and is complete at the draw distance
+
+// benchmark constants
+#define BENCH_MIN_MAP_SIZE     16    // the scaling benchmark runs over maps of these sizes, with a factor 4 in between ...
+#define BENCH_MAX_MAP_SIZE   4096    // ... up to this size if it's run from the command line (--bench) ...
+#define BENCH_MAX_MAP_SIZE_UI 1024   // ... and up to this size if it's run using trigger key B. NOTE: it then runs within a frame, and the maps are built on the fly, so keep this moderate
+#define BENCH_NR_RAYS        2048    // nr of rays cast per map size and per variant
+#define BENCH_REFERENCE_FILE "dda_fixed_reference.txt"    // reference output of the fixed point DDA - is looked up next to the executable, see SetBenchReferencePath()
+#define BENCH_NR_QUERIES     8192    // nr of line of sight queries in the ray query benchmark (trigger key V)
+#define BENCH_PORTAL_FRAMES    20    // nr of frames rendered per nr of threads in the portal benchmark (trigger key K)
+#define CHECK_NR_FRAMES        48    // nr of frames along the camera path of the adaptive columns check (command line argument --check-adaptive)
+
+// shading constants
+#define RENDER_SHADED        true
+#define OBJECT_INTENSITY       5.0f   // for testing, reset to 1.5f afterwards!
+#define MULTIPLIER_INTENSITY   5.0f
+#define INTENSITY_SPEED        1.0f
+
+#define SHADE_FACTOR_MIN       0.1f   // the shade factor is clamped between these two values
+#define SHADE_FACTOR_MAX       1.0f
+
+// constants for speed movements - all movements are modulated with fElapsedTime
+#define SPEED_ROTATE          60.0f   //                            60 degrees per second
+#define SPEED_MOVE             5.0f   // forward and backward    -   5 units per second
+#define SPEED_STRAFE           5.0f   // left and right strafing -   5 units per second
+#define SPEED_LOOKUP         200.0f   // looking up or down      - 200 pixels per second
+#define SPEED_STRAFE_UP        1.0f   // flying or chrouching    -   1.0 unit per second
+
+// mini map constants
+#define MINIMAP_TILE_SIZE     (32 / PIXEL_SIZE)   // each minimap tile is ... pixels
+#define MINIMAP_SCALE_FACTOR   0.4    // should be 0.2
+
+#define SENSE_RADIUS    2.0f    // player must be this close to map cell center to be able to open doors etc
+#define SENSE_BLENDF    0.4f    // bland factor to render sense circle around player
+
+// colour constants
+#define COL_HUD_TXT     olc::YELLOW
+#define COL_HUD_BG      olc::VERY_DARK_GREEN
+
+// ==============================/  map definition here   /==============================
+
+#include "map_16x16.h"
+// ==============================/  queue type for sub slice info   /==============================
+
+// typedef for controlled sub slice rendering
+typedef struct sSubSliceRec {
+    float fViewAngle_deg;      // ranges over the field of view from - FOV / 2 to + FOV / 2
+    float fCurAngle_deg;       // angle of current slice in world space
+    float fVPAngle_deg;        // angle of the view point (typically identical to player angle) in world space
+    int   nCurMap;             // what map ...
+    float fPx, fPy, fPh;       // ... and location therein is the ray to be cast from?
+    float fStrtDist;           // precursor distance - to arrive at the portal of this map
+    int   nSlice;              // current slice to be rendered
+    int   nStrtY, nStopY;      // smallest (i.e. highest on screen) and largest (lowest on screen) y coordinate of sub slice
+    int   nHorHght;            // hight of horizon for this slice
+    bool  bResetSlice = false; // should depth buffer for this sub slice be cleared upfront?
+} SubSliceRec;
+
+typedef t_queue<SubSliceRec> SliceQueue;
+
+// ==============================/  fragment type for delayed pixel rendering   /==============================
+
+// a pixel of a transparent face. These are collected per screen column, and drawn after the opaque parts of the column
+typedef struct sFragmentRec {
+    float fDepth;       // for depth drawing
+    int   nY;           // screen row - the screen column is the same for all the fragments in the buffer
+    olc::Pixel p;       // pixel to draw
+    float fShadeDist;   // for the deferred shading (see MyRayCaster::ShadeFrame())
+} FragmentRec;
+
+// index of the render thread the code is running on (0 for the main thread), see MyRayCaster::GetScratch()
+static thread_local int nRenderThread = 0;
+
+// ==============================/  PGE derived ray caster engine   /==============================
+
+
+class MyRayCaster : public olc::PixelGameEngine {
+
+public:
+    MyRayCaster() {    // display the screen and pixel dimensions in the window caption
+        sAppName = "MyRayCaster - Permadi tutorial elaborations - S:(" + std::to_string( SCREEN_X / PIXEL_SIZE ) + ", " + std::to_string( SCREEN_Y / PIXEL_SIZE ) + ")" +
+                                                               ", P:(" + std::to_string(            PIXEL_SIZE ) + ", " + std::to_string(            PIXEL_SIZE ) + ")" ;
+    }
+
+private:
+    std::vector<RC_Map> vMaps;    // the list of all game map objects
+    int nActiveMap = 0;           // keeps track of which of the maps is currently active
+    float fMaxDistance;           // max visible distance in the active map - see RC_Map::GetDrawDistance()
+
+    float fPlayerX     =  4.5f;    // player: position - is reset in OnUserCreate() using map definition data file
+    float fPlayerY     =  4.5f;
+    float fPlayerH     =  0.5f;   // player: height of eye point and field of view
+    float fPlayerA_deg = 90.0f;   // player: looking angle is in degrees - NOTE: 0.0f is EAST
+    float fPlayerLU    =  0.0f;   // factor for looking up or down (in pixel space: float is for smooth movement)
+    // rationale: when fPlayerH == 0.5f, then lookup factor == 0. When fPlayerH == 1.5f, the lookup factor equals one screen height
+
+    float fPlayerX_cached;         // to be able to see delta in player movement
+    float fPlayerY_cached;
+    float fPlayerH_cached;
+
+    float fPlayerFoV_deg = 60.0f;   // in degrees !!
+    float fPlayerFoV_rad;
+
+    float fAnglePerPixel_deg;      // how many degrees are needed to rotate to next screen slice? - is calculated in SetRenderResolution()
+    float fDistToProjPlane;         // distance to projection plane - is calculated in SetRenderResolution()
+
+    // all sprites for texturing the scene and the objects, grouped in categories
+    std::vector<olc::Sprite *> vWallSprites;
+    std::vector<olc::Sprite *> vCeilSprites;
+    std::vector<olc::Sprite *> vRoofSprites;
+    std::vector<olc::Sprite *> vFlorSprites;
+    std::vector<olc::Sprite *> vObjtSprites;
+
+    // var's and initial values for shading - trigger keys INS and DEL
+    float fObjectIntensity     = MULTI_LAYERS ? OBJECT_INTENSITY     :  0.2f;
+    float fIntensityMultiplier = MULTI_LAYERS ? MULTIPLIER_INTENSITY : 10.0f;
+
+    // toggles for rendering
+    bool bMinimap     = false;    // toggle on mini map rendering (trigger key P)
+    bool bMapRays     = false;    //           rays in mini map   (trigger key O)
+    bool bPlayerInfo  = false;    //           player info hud    (trigger key I)
+    bool bProcessInfo = false;    //           process info hud   (trigger key U)
+    bool bTestSlice   = false;    //           visible test slice (trigger key G)
+    bool bTestGrid    = false;    //           visible test grid  (trigger key H)
+
+    typedef struct sRayStruct {
+        olc::vf2d pointA, pointB;
+        int layer;
+    } RayType;
+    std::vector<RayType> vRayList;    // needed for ray rendering in minimap
+
+    // which of the slices to output in test mode
+    float fTestSlice;
+    int nActiveSlice = -1;
+    bool bTestMode = false;           // to trigger test output
+
+    // create a queue to handle the sub slice rendering
+    SliceQueue dSliceQueue;
+    int nFrameCntr = 0;
+
+    // progressive rendering: the slice queue is processed until the time budget of the frame runs out, and the rendering continues
+    // in the next frame. The walls are rendered into pWorkSprite (with depth buffer cDDrawer), and each column that is complete is
+    // copied to pSceneSprite (and cSceneDDrawer). So the columns that are not finished yet show what they showed in the previous frame.
+    bool  bProgressive = false;                       // progressive or complete rendering (trigger key Y)
+    float fFrameBudget_ms = PROGRESSIVE_BUDGET_MS;
+    olc::Sprite *pWorkSprite  = nullptr;
+    olc::Sprite *pSceneSprite = nullptr;
+    std::vector<int> vColumnPending;                  // per column: the nr of sub slices that are not rendered yet
+    int nColumnsDone = 0;                             // nr of columns that are complete in the current pass over the screen
+
+    // pipelined stages: the render stage of frame N runs on another thread alongside the update stage of frame N + 1 (see RenderStage())
+    bool bPipelined = PIPELINE_STAGES;                // pipelined or sequential stages (trigger key L)
+
+    // empty space skipping and fixed point in the DDA - these are variables (instead of only the constants) so that the benchmark can compare them
+    bool bSkipEmptyCells  = DDA_SKIP_EMPTY;
+    bool bSkipEmptyBlocks = DDA_SKIP_BLOCKS;
+    bool bFixedPointDDA   = DDA_FIXED_POINT;
+    bool bAdaptiveColumns = DDA_ADAPTIVE_COLUMNS;
+    bool bHalfRateFlats   = RENDER_FLATS_HALF_RATE;
+
+    RC_DepthDrawer cDDrawer;              // depth drawing object
+    RC_DepthDrawer cSceneDDrawer;         // progressive rendering: the depth of the columns in pSceneSprite ...
+    RC_DepthDrawer cFrameDDrawer;         // ... and a copy of it for each frame, that the objects are drawn against
+    RC_RayQuery    cRayQuery;             // ray queries for the game logic (line of sight, hitscan)
+    RC_ThreadPool  cRenderPool;           // threads for rendering the screen columns
+    RC_ThreadPool  cStagePool;            // threads for running the update and render stage alongside each other
+
+public:
+
+    // create and fill the maps - these are defined in a separate file
+    // NOTES: 1) string arguments in AddLayer() must all have the same x and y dimensions
+    //        2) the z-dimension of the map is determined by the nr of layers added to it
+    //        3) the parameters vWallSprites, vCeilSprites and vRoofSprites must be initialised upfront
+    void InitMaps() {
+
+        // lambda expression to determine the sky clour per map
+        auto get_sky_colour = [=]( int mapID ) -> olc::Pixel {
+            if (mapID < (int)vSkyColours.size()) {
+                return vSkyColours[ mapID ];
+            } else {
+                return olc::CYAN;
+            }
+        };
+        // lambda expressions to determine the draw distance and fog colour per map
+        auto get_draw_distance = [=]( int mapID ) -> float {
+            return (mapID < (int)vDrawDistances.size()) ? vDrawDistances[ mapID ] : 0.0f;
+        };
+        auto get_fog_colour = [=]( int mapID ) -> olc::Pixel {
+            return (mapID < (int)vFogColours.size()) ? vFogColours[ mapID ] : olc::GREY;
+        };
+        // initialize all layers (counter n) for all maps (counter m) in the input data
+        for (int m = 0; m < (int)vMapLayouts.size(); m++) {
+            RC_Map tmp;
+            tmp.InitMap( m, vMapPortals[m], vFlorSprites[m], get_sky_colour( m ), get_draw_distance( m ), get_fog_colour( m ));
+            MapType &sMapLayout = vMapLayouts[m];
+            for (int n = 0; n < (int)sMapLayout.size(); n++) {
+                tmp.AddLayer( sMapLayout[n], vWallSprites, vCeilSprites, vRoofSprites );
+            }
+            vMaps.push_back( tmp );
+        }
+    }
+
+    // Four percentages are passed, for dynamic objects, stationary objects, bushes and trees.
+    void InitObjectsPerMap( RC_Map *pCurMapPtr, float fObjDynPerc, float fObjStatPerc, float fObjBushPerc, float fObjTreePerc ) {
+
+        // aux map to keep track of placed objects
+        // count nr of occupied cells at the same time
+        std::string sObjMap;
+        int nTilesOccupied = 0;
+        for (int y = 0; y < pCurMapPtr->GetHeight(); y++) {
+            for (int x = 0; x < pCurMapPtr->GetWidth(); x++) {
+                sObjMap.append( " " );
+                if (pCurMapPtr->CellHeight( x, y ) != 0.0f) {
+                    nTilesOccupied += 1;
+                }
+            }
+        }
+        // only place objects where there's nothing in the immediate (8 connected) neighbourhood
+        auto space_for_object = [=]( int x, int y ) -> bool {
+            int xMin = std::max( 0, x - 1 );
+            int yMin = std::max( 0, y - 1 );
+            int xMax = std::min( pCurMapPtr->GetWidth()  - 1, x + 1 );
+            int yMax = std::min( pCurMapPtr->GetHeight() - 1, y + 1 );
+            bool bOccupied = false;
+            for (int r = yMin; r <= yMax && !bOccupied; r++) {
+                for (int c = xMin; c <= xMax && !bOccupied; c++) {
+                    bOccupied = pCurMapPtr->CellHeight( c, r ) != 0.0f || sObjMap[ r * pCurMapPtr->GetWidth() + c ] != ' ';
+                }
+            }
+            return !bOccupied;
+        };
+
+        int nNrDynObjects  = int((pCurMapPtr->GetWidth() * pCurMapPtr->GetHeight() - nTilesOccupied) * fObjDynPerc);
+        int nNrStatObjects = int((pCurMapPtr->GetWidth() * pCurMapPtr->GetHeight() - nTilesOccupied) * fObjStatPerc);
+        int nNrBushObjects = int((pCurMapPtr->GetWidth() * pCurMapPtr->GetHeight() - nTilesOccupied) * fObjBushPerc);
+        int nNrTreeObjects = int((pCurMapPtr->GetWidth() * pCurMapPtr->GetHeight() - nTilesOccupied) * fObjTreePerc);
+        int nTotalNrObjects = nNrDynObjects + nNrStatObjects + nNrBushObjects + nNrTreeObjects;
+
+        int nDynChoices  =  1;    // these values are depending on the available object sprite files loaded via
+        int nStatChoices =  2;    // the user defined map
+        int nBushChoices = 10;
+        int nTreeChoices = 18;
+
+        // populate object list with randomly chosen, scaled and placed objects
+        for (int i = 0; i < nTotalNrObjects; i++) {
+            int nRandX, nRandY;
+            bool bFoundEmpty = false;
+            bool bMakeDynamic = false;
+            // find an empty spot in the map
+            do {
+                nRandX = rand() % pCurMapPtr->GetWidth();
+                nRandY = rand() % pCurMapPtr->GetHeight();
+
+                bFoundEmpty = space_for_object( nRandX, nRandY );
+            } while (!bFoundEmpty);
+
+            // determine object type - make sure that at least MIN_DYNAMIC_OBJS objects are dynamic
+            int nRandObj;
+            if (is_in_range( i,              0, nNrDynObjects  )) { nRandObj = rand() % nDynChoices;                                              } else
+            if (is_in_range( i,  nNrDynObjects, nNrStatObjects )) { nRandObj = rand() % nStatChoices + nDynChoices;                               } else
+            if (is_in_range( i, nNrStatObjects, nNrBushObjects )) { nRandObj = rand() % nBushChoices + nDynChoices + nStatChoices;                } else
+                                                                  { nRandObj = rand() % nTreeChoices + nDynChoices + nStatChoices + nBushChoices; }
+
+            // depending on object type, make dynamic or static and determine size
+            int nRandSize;
+            if (is_in_range( nRandObj, 0,  1 )) { bMakeDynamic = true ; nRandSize = rand() %  3 +  3; } else   // this is an elf girl, make dynamic
+            if (is_in_range( nRandObj, 1,  3 )) { bMakeDynamic = false; nRandSize =                6; } else   // these are stationary objects of fixed size
+            if (is_in_range( nRandObj, 3, 13 )) { bMakeDynamic = false; nRandSize = rand() %  8 +  2; } else   // these are bushes
+                                                { bMakeDynamic = false; nRandSize = rand() % 15 + 10; }        // trees
+
+            // create the object and put it in the list of objects
+            RC_Object tmpObj( float( nRandX ) + 0.5f, float( nRandY ) + 0.5f, float( nRandSize / 10.0f ), -1.0f, 0.0f, vObjtSprites[ nRandObj ] );
+            if (bMakeDynamic) {
+                tmpObj.bStationary = false;
+                tmpObj.SetVX( float_rand_between( -5.0f, 5.0f ));
+                tmpObj.SetVY( float_rand_between( -5.0f, 5.0f ));
+            } else {
+                tmpObj.bStationary = true;
+                tmpObj.SetVX( 0.0f );
+                tmpObj.SetVY( 0.0f );
+            }
+
+            pCurMapPtr->vListObjects.push_back( tmpObj );
+
+            // mark that an object is placed at this tile
+            sObjMap[ nRandY * pCurMapPtr->GetWidth() + nRandX ] = 'X';
+        }
+    }
+
+    bool OnUserCreate() override {
+
+        bool bSuccess = true;
+
+        // seed randomizer
+        srand( time( 0 ));
+        // initialize sine and cosine lookup arrays - these are meant for performance improvement
+        init_lu_sin_array();
+        init_lu_cos_array();
+
+        // lambda expression for loading sprite files with error checking
+        auto load_sprite_file = [=]( const std::string &sFileName ) {
+            olc::Sprite *tmp = new olc::Sprite( sFileName );
+            if (tmp->width == 0 || tmp->height == 0) {
+                std::cout << "ERROR: OnUserCreate() --> can't load file: " << sFileName << std::endl;
+                delete tmp;
+                tmp = nullptr;
+            }
+            return tmp;
+        };
+        // lambda expression for loading all sprites for one category (walls, ceilings, roofs, floors or objects) into the
+        // associated container
+        auto load_sprites_from_files = [=]( std::vector<std::string> &vFileNames, std::vector<olc::Sprite *> &vSpritePtrs, const std::string &sType ) {
+            bool bNoErrors = true;
+            for (auto &sf : vFileNames) {
+                olc::Sprite *tmpPtr = load_sprite_file( sf );
+                bNoErrors &= (tmpPtr != nullptr);
+                vSpritePtrs.push_back( tmpPtr );
+            }
+            std::cout << "Loaded: " << (int)vFileNames.size() << " files into " << (int)vSpritePtrs.size() << " " << sType << " sprites."    << std::endl;
+            return bNoErrors;
+        };
+        // load all sprites into their associated container
+        bSuccess &= load_sprites_from_files( vWallSpriteFiles, vWallSprites, "wall"    );
+        bSuccess &= load_sprites_from_files( vCeilSpriteFiles, vCeilSprites, "ceiling" );
+        bSuccess &= load_sprites_from_files( vRoofSpriteFiles, vRoofSprites, "roof"    );
+        bSuccess &= load_sprites_from_files( vFlorSpriteFiles, vFlorSprites, "floor"   );
+        bSuccess &= load_sprites_from_files( vObjtSpriteFiles, vObjtSprites, "object"  );
+
+        // fill the library of face blueprints
+        InitFaceBluePrints( vWallSprites, vCeilSprites, vRoofSprites );
+        // fill the library of map cell blueprints
+        InitMapCellBluePrints();
+        // initialise all layers of all maps using the vMapLayouts vector
+        // as a results the vMaps vector is populated
+        InitMaps();
+        // initialise objects per map
+        float fObjPercentage = 0.0f;
+        for (int i = 0; i < (int)vMaps.size(); i++) {
+            // comment this switch out if you don't want objects in the maps
+//            switch( i ) {
+//                case 0: fObjPercentage = 2.0f; break;
+//                case 1: fObjPercentage = 0.0f; break;
+//                case 2: fObjPercentage = 1.0f; break;
+//            }
+            InitObjectsPerMap(
+                &(vMaps[i]),
+                fObjPercentage * OBJ_PERC_DYN,
+                fObjPercentage * OBJ_PERC_STAT,
+                fObjPercentage * OBJ_PERC_BUSH,
+                fObjPercentage * OBJ_PERC_TREE
+            );
+        }
+        // set the active map according to map def. data file
+        nActiveMap = nStartMap;
+        // max visible distance is the draw distance of the map (the diagonal length of the map if it isn't set)
+        fMaxDistance = vMaps[ nActiveMap ].GetDrawDistance();
+
+        // set player initial position and orientation according to map def. data file
+        fPlayerX     = fStartPlayerX;
+        fPlayerY     = fStartPlayerY;
+        fPlayerH     = fStartPlayerZ;
+        fPlayerA_deg = fStartPlayerA;
+        fPlayerLU    = fStartPlayerLU;
+
+        // set cache player location variables
+        fPlayerX_cached = fPlayerX;
+        fPlayerY_cached = fPlayerY;
+        fPlayerH_cached = fPlayerH;
+
+        // set initial test slice value at middle of screen
+        fTestSlice = ScreenWidth() / 2.0f;
+        // determine the player field of view in radians as well
+        fPlayerFoV_rad = deg2rad( fPlayerFoV_deg );
+        // start rendering at the screen resolution - this allocates the depth drawers and sprites, and works out the projection
+        SetRenderResolution( ScreenWidth(), ScreenHeight());
+        // start the render threads, each of them needs its own scratch containers
+        cRenderPool.Init( RENDER_THREADS );
+        vThreadScratch.resize( cRenderPool.NrOfThreads());
+        // the batches of ray queries are cast on the render threads too
+        cRayQuery.Init( &vMaps, &cRenderPool );
+        // the update stage runs on the calling thread, the render stage on the other one
+        cStagePool.Init( 2 );
+        // the first frame renders the initial state
+        CaptureSnapshot( sSnapshot );
+
+        return bSuccess;
+    }
+
+    // Holds a hit point as it is emitted by the DDA: the distance to the grid crossing, the tile that was entered and the height of
+    // the map at that tile. This record is kept compact (16 bytes), since it's written for every hit point and the ray cache keeps
+    // lots of them. The world space hit point follows from the ray (origin + distance * direction), and the data that's only
+    // needed for rendering is worked out lazily for the hit points that are rendered (see RenderHitList).
+    // NOTE: the tile coordinates are 16 bit, so maps can't be larger than 32767 x 32767 cells
+    typedef struct sIntersectInfo {
+        float   fDistFrnt_raw;           // raw distance to the front face of the hit block
+        float   fHeight;                 // height within the layer
+        int16_t nHitX,                   // tile space hit point
+                nHitY;
+        int8_t  nLayer   = -1;           // nLayer == 0 --> ground layer
+        int8_t  nFaceHit = FACE_UNKNOWN; // which face was hit?
+        bool    bRemoveFlag = false;
+    } IntersectInfo;
+
+    // The data that RenderSubSlice() needs per rendered hit point (i.e. of a block with a height > 0), in structure of arrays layout.
+    // The hit points themselves stay in the (cached) layer hit lists, these arrays point to them.
+    typedef struct sRenderHitList {
+        std::vector<const IntersectInfo *> vHit;
+        std::vector<float> vDistFrnt_corr;           // corrected distance to the front face of the hit block
+        std::vector<float> vDistBack_corr;           // corrected distance to the back of the hit block (FLT_MAX if it's the last one)
+        // these are on screen projected (O.S.P.) values (y coordinate in pixel space)
+        std::vector<int>   vTopFrnt, vBotFrnt;       // on screen projected ceiling and bottom of the wall slice
+        std::vector<int>   vTopBack, vBotBack;       //                     ceiling and bottom of the wall at back
+
+        int  size() { return (int)vHit.size(); }
+        void clear() {
+            vHit.clear(); vDistFrnt_corr.clear(); vDistBack_corr.clear();
+            vTopFrnt.clear(); vBotFrnt.clear(); vTopBack.clear(); vBotBack.clear();
+        }
+        void push_back( const IntersectInfo *pHit, float fDistFrnt_corr, float fDistBack_corr, int nTopFrnt, int nBotFrnt, int nTopBack, int nBotBack ) {
+            vHit.push_back( pHit ); vDistFrnt_corr.push_back( fDistFrnt_corr ); vDistBack_corr.push_back( fDistBack_corr );
+            vTopFrnt.push_back( nTopFrnt ); vBotFrnt.push_back( nBotFrnt ); vTopBack.push_back( nTopBack ); vBotBack.push_back( nBotBack );
+        }
+    } RenderHitList;
+
+    // A work item for RenderSlicesParallel(): sub slices of the same portal depth for the screen columns nColumnLo .. nColumnHi.
+    // The first level items hold the sub slices of a chunk of RENDER_CHUNK_SIZE columns, the items that are spawned by portals
+    // hold the sub slices of a single column.
+    typedef struct sSliceWorkRec {
+        SliceQueue dSliceQ;
+        int nColumnLo, nColumnHi;
+        int nDepth;                  // nr of portals passed
+    } SliceWorkRec;
+    typedef t_wsdeque<SliceWorkRec> WorkDeque;
+
+    // the range of minimap rays a work item added to the ray list of the thread that rendered it
+    typedef struct sRayRangeRec {
+        int nDepth, nColumn;         // sort key: the work item it belongs to
+        int nThread;
+        int nFirstRay, nLastRay;
+    } RayRangeRec;
+
+    // The scratch containers and statistics of a render thread. Each thread of the render pool has its own (see RenderSlicesParallel()),
+    // so that the DDA and RenderSubSlice() can work on different screen columns at the same time. The main thread uses the first one.
+    typedef struct sThreadScratchRec {
+        std::vector<std::vector<IntersectInfo>> vLayerHitLists;    // for the multi layer DDA - one hit list per layer, reused for each ray
+        RenderHitList         sRenderHitList;     // the hit points RenderSubSlice() renders, reused for each sub slice
+        std::vector<uint64_t> vOccRows;           // bit set of the covered rows of the ray that is cast (see GetOccRows())
+        std::vector<int>      vFillIn;            // for FillInColumn()
+        std::vector<olc::Pixel> vSpanPixels;      // the pixels and depths of a span that RenderSubSlice() or RenderFloorRows() draws at once
+        std::vector<float>      vSpanDepths;
+        std::vector<float>      vSpanShades;      // the shade distances of that span, for the deferred shading (see ShadeFrame())
+        std::vector<FragmentRec> vFragments;      // the transparent fragments of the sub slice that RenderSubSlice() is rendering
+        std::vector<RayType>  vRayList;           // the rays for the minimap, until they are collected into vRayList
+        std::vector<RayRangeRec>  vRayRanges;     // the ranges in vRayList per work item
+        std::vector<SliceWorkRec> vSpawnedItems;  // for the work items that are spawned by portals
+        // the ray cache records of these screen columns are written by this thread only
+        int nColumnLo = 0, nColumnHi = INT_MAX;
+        // nr of first level rays that were cast resp. filled in from their neighbours, for the current fill of the slice queue
+        int nRaysCast     = 0;
+        int nRaysFilledIn = 0;
+        // nr of hit records RenderSubSlice() went through, resp. put in the render list, for the current fill of the slice queue
+        int nHitsProcessed = 0;
+        int nHitsRendered  = 0;
+        // nr of work items this thread took from the deques of other threads
+        int nItemsStolen  = 0;
+    } ThreadScratchRec;
+    std::vector<ThreadScratchRec> vThreadScratch = std::vector<ThreadScratchRec>( 1 );
+
+    // returns the scratch record of the thread this is called on
+    ThreadScratchRec &GetScratch() { return vThreadScratch[ nRenderThread ]; }
+
+    // Precalculated direction info for the ray of one screen column. The first level rays only depend on the player angle,
+    // the field of view and the screen width, so a table of these records is kept (see UpdateCameraRays()) and the rendering
+    // of a sub slice just indexes into it, instead of doing the (look up) trig per ray and per sampled pixel.
+    typedef struct sCameraRayRec {
+        float fViewAngle_deg;    // angle relative to the view direction
+        float fCurAngle_deg;     // angle in world space
+        float fDirX, fDirY;      // lu_cos() and lu_sin() of fCurAngle_deg - for the end point of the ray and for sampling
+        float fDX, fDY;          // normalized direction vector
+        float fSX, fSY;          // scaling factors for the ray increments per unit in x resp y direction
+        float fViewCos;          // lu_cos() of fViewAngle_deg - for the fish eye correction
+        float fFloorDX, fFloorDY;    // fDirX and fDirY divided by fViewCos - to find the floor point at an uncorrected distance (see RenderFloorRows())
+    } CameraRayRec;
+    std::vector<CameraRayRec> vCameraRays;    // one record per screen column
+    // the values the camera ray table was built for
+    float fCameraRaysA_deg   = 0.0f;
+    float fCameraRaysFoV_deg = 0.0f;
+    int   nCameraRaysWidth   = -1;
+
+    // fills ray record rRay for the view angle and world angle that are passed
+    void InitCameraRay( CameraRayRec &rRay, float fViewAngle_deg, float fCurAngle_deg ) {
+        rRay.fViewAngle_deg = fViewAngle_deg;
+        rRay.fCurAngle_deg  = fCurAngle_deg;
+        rRay.fDirX = lu_cos( fCurAngle_deg );
+        rRay.fDirY = lu_sin( fCurAngle_deg );
+        // work out normalized direction vector (fDX, fDY)
+        float fRayLen = sqrt( rRay.fDirX * rRay.fDirX + rRay.fDirY * rRay.fDirY );
+        rRay.fDX = rRay.fDirX / fRayLen;
+        rRay.fDY = rRay.fDirY / fRayLen;
+        // calculate the scaling factors for the ray increments per unit in x resp y direction
+        // this calculation takes division by 0.0f into account
+        rRay.fSX = (rRay.fDX == 0.0f) ? FLT_MAX : sqrt( 1.0f + (rRay.fDY / rRay.fDX) * (rRay.fDY / rRay.fDX));
+        rRay.fSY = (rRay.fDY == 0.0f) ? FLT_MAX : sqrt( 1.0f + (rRay.fDX / rRay.fDY) * (rRay.fDX / rRay.fDY));
+        rRay.fViewCos = lu_cos( fViewAngle_deg );
+        rRay.fFloorDX = rRay.fDirX / rRay.fViewCos;
+        rRay.fFloorDY = rRay.fDirY / rRay.fViewCos;
+    }
+
+    // (re)builds the camera ray table, but only if the player angle, field of view or screen width changed since the last build
+    void UpdateCameraRays( float fViewA_deg ) {
+        if (nCameraRaysWidth == RenderWidth() && fCameraRaysA_deg == fViewA_deg && fCameraRaysFoV_deg == fPlayerFoV_deg)
+            return;
+
+        vCameraRays.resize( RenderWidth() );
+        for (int x = 0; x < RenderWidth(); x++) {
+            // NOTE: this must be calculated exactly like the angles of the initial sub slices in OnUserUpdate()
+            float fViewAngle_deg = float( x - (RenderWidth() / 2)) * fAnglePerPixel_deg;
+            InitCameraRay( vCameraRays[x], fViewAngle_deg, fViewA_deg + fViewAngle_deg );
+        }
+        // the player rotated: the rays of the previous frame shifted over the columns
+        ShiftRayCache( nCameraRaysWidth == RenderWidth() && fCameraRaysFoV_deg == fPlayerFoV_deg,
+                       mod360( fViewA_deg - fCameraRaysA_deg, -180.0f ));
+        nCameraRaysWidth   = RenderWidth();
+        fCameraRaysA_deg   = fViewA_deg;
+        fCameraRaysFoV_deg = fPlayerFoV_deg;
+    }
+
+    // Returns the max length of a ray in map nMap, for a sub slice that starts at (corrected) distance fStrtDist. If the map has a draw
+    // distance set, the ray is long enough to reach the draw distance in all screen columns. Otherwise it's the diagonal length of the map.
+    float GetRayLength( int nMap, float fStrtDist ) {
+        RC_Map &rMap = vMaps[ nMap ];
+        if (!rMap.HasFog()) {
+            return rMap.GetDrawDistance();
+        }
+        // the draw distance is a corrected distance - the outer screen columns need the longest ray to reach it
+        return std::max( 0.0f, rMap.GetDrawDistance() - fStrtDist ) / lu_cos( fPlayerFoV_deg / 2.0f );
+    }
+
+    // Gets the ray record for screen column nSlice. If the table entry doesn't match the angles (a sub slice seen through a portal,
+    // or a sub slice that was queued before the player turned) the record is calculated instead.
+    void GetCameraRay( int nSlice, float fViewAngle_deg, float fCurAngle_deg, CameraRayRec &rRay ) {
+        if (nSlice >= 0 && nSlice < (int)vCameraRays.size() && vCameraRays[ nSlice ].fViewAngle_deg == fViewAngle_deg) {
+            rRay = vCameraRays[ nSlice ];
+            if (rRay.fCurAngle_deg != fCurAngle_deg) {
+                // the fish eye correction is still valid, only the world space direction must be worked out
+                float fViewCos = rRay.fViewCos;
+                InitCameraRay( rRay, fViewAngle_deg, fCurAngle_deg );
+                rRay.fViewCos = fViewCos;
+            }
+        } else {
+            InitCameraRay( rRay, fViewAngle_deg, fCurAngle_deg );
+        }
+    }
+
+    // works out the world space hit point of p, which was found along camera ray rRay cast from (fFromX, fFromY). This gives the same
+    // result as the DDA would have
+    void GetHitPoint( float fFromX, float fFromY, const CameraRayRec &rRay, const IntersectInfo &p, float &fHitX, float &fHitY ) {
+        fHitX = fFromX + p.fDistFrnt_raw * rRay.fDX;
+        fHitY = fFromY + p.fDistFrnt_raw * rRay.fDY;
+    }
+
+    // put info from hit point p (found along camera ray rRay cast from (fFromX, fFromY)) to screen
+    void PrintHitPoint( float fFromX, float fFromY, const CameraRayRec &rRay, const IntersectInfo &p, bool bVerbose ) {
+        float fHitX, fHitY;
+        GetHitPoint( fFromX, fFromY, rRay, p, fHitX, fHitY );
+        std::cout << "hit (world): ( " << fHitX << ", " << fHitY << " ) ";
+        std::cout << "hit (tile): ( " << p.nHitX << ", " << p.nHitY << " ) ";
+        std::cout << "raw dist.: "     << p.fDistFrnt_raw  << " ";
+        std::cout << "lvl: " << int( p.nLayer ) << " hght: " << p.fHeight << " ";
+        if (bVerbose) {
+            switch (p.nFaceHit) {
+                case FACE_EAST   : std::cout << "EAST";    break;
+                case FACE_NORTH  : std::cout << "NORTH";   break;
+                case FACE_WEST   : std::cout << "WEST";    break;
+                case FACE_SOUTH  : std::cout << "SOUTH";   break;
+                case FACE_TOP    : std::cout << "TOP";     break;
+                case FACE_BOTTOM : std::cout << "BOTTOM";  break;
+                case FACE_UNKNOWN: std::cout << "UNKNOWN"; break;
+                default          : std::cout << "ERROR: "   << int( p.nFaceHit );
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    // put info from render list rList (with hit points found along camera ray rRay cast from (fFromX, fFromY)) to screen
+    void PrintRenderHitList( float fFromX, float fFromY, const CameraRayRec &rRay, RenderHitList &rList, bool bVerbose = false ) {
+        for (int i = 0; i < rList.size(); i++) {
+            std::cout << "Elt: " << i << " = ";
+            std::cout << "corr. dist.: " << rList.vDistFrnt_corr[i] << " ";
+            if (bVerbose) {
+                std::cout << "bot frnt: " << rList.vBotFrnt[i] << " bot back: " << rList.vBotBack[i] << " ";
+                std::cout << "top frnt: " << rList.vTopFrnt[i] << " top back: " << rList.vTopBack[i] << " ";
+            }
+            PrintHitPoint( fFromX, fFromY, rRay, *rList.vHit[i], bVerbose );
+        }
+        std::cout << std::endl;
+    }
+
+    // The screen space of the sub slice a ray is cast for. The DDA uses it to stop the ray as soon as opaque walls cover
+    // the whole sub slice, see UpdateOcclusion()
+    typedef struct sOcclusionRec {
+        float fPh;                   // view point height
+        int   nHorHght;              // screen y coordinate of the horizon
+        int   nStrtY, nStopY;        // screen rows of the sub slice
+        float fStrtDist;             // (corrected) distance the sub slice starts at
+    } OcclusionRec;
+
+    // The state of a ray that is traversed by the DDA. It's put in a separate record, so that the DDA, the empty space skipping and the
+    // adaptive column fill in can share the same code (and produce identical output).
+    // NOTE: the partial ray lengths are always calculated as first crossing + nr of crossings * scaling factor, instead of by repeated
+    // addition. That way skipping n crossings at once gives exactly the same values as stepping n times.
+    typedef struct sRayState {
+        float fFromX, fFromY;            // start point of the ray
+        float fToX, fToY;                // end point of the ray (at fMaxDist)
+        float fMaxDist;                  // max length of the ray, see GetRayLength()
+        float fDX, fDY;                  // normalized direction vector
+        float fSX, fSY;                  // scaling factors for the ray increments per unit in x resp y direction
+        int   nGridStepX, nGridStepY;    // +1 or -1, depending on whether ray is going right or left resp. down or up
+        float fFirstPartialRayX,         // distances to the first grid crossing in x resp. y direction
+              fFirstPartialRayY;
+        int   nCrossingsX, nCrossingsY;  // nr of grid crossings passed in x resp. y direction
+        float fLengthPartialRayX,        // distances to the next grid crossing in x resp. y direction
+              fLengthPartialRayY;
+        int   nCurX, nCurY;              // the cell the ray is in
+        float fDistIfFound = 0.0f;       // accumulates distance of analysed piece of ray
+        bool  bCheckHor = false;         // was the last grid crossing on a horizontal grid line?
+        bool  bOutOfBounds;              // did the analysis get out of map boundaries?
+        bool  bDestCellReached;          // did the analysis reach the destination cell?
+        int   nHitPointsFound = 0;       // counter for nr of (in bound) hit points found
+        int   nLayerLo, nLayerHi;        // range of layers to emit hit points for (see GetVisibleLayers())
+
+        // fixed point (see FIXED_SHIFT) counterparts of the distances, only used if bFixedPointDDA is set. Then the float values of
+        // fDistIfFound is derived from these, and the partial ray lengths are not used
+        int64_t nSX, nSY;
+        int64_t nFirstPartialRayX, nFirstPartialRayY;
+        int64_t nLengthPartialRayX, nLengthPartialRayY;
+        int64_t nDistIfFound;
+        int64_t nMaxDist;
+
+        // occlusion driven termination, only used if pOccRows is set (see InitOcclusion())
+        OcclusionRec sOcc;
+        float     fViewCos;              // fish eye correction factor of the ray, to work out the on screen projections
+        uint64_t *pOccRows  = nullptr;   // bit set of the screen rows that are covered by opaque walls
+        bool      bOccluded = false;     // the ray was stopped since nothing beyond this point can be visible
+    } RayState;
+
+    // conversion functions between float and fixed point
+    int64_t to_fixed( float fValue ) { return std::min( FIXED_MAX, int64_t( floor( double( fValue ) * double( FIXED_ONE ) + 0.5 ))); }
+    float from_fixed( int64_t nValue ) { return float( double( nValue ) / double( FIXED_ONE )); }
+
+    // sets up the ray state for a ray from (fPx, fPy) in the direction of camera ray rRay, with a length of fMaxDist
+    void InitRayState( RC_Map &rMap, RayState &r, float fPx, float fPy, const CameraRayRec &rRay, float fMaxDist ) {
+        // The player's position is the "from point"
+        r.fFromX = fPx;
+        r.fFromY = fPy;
+        // Calculate the "to point" using the ray direction and fMaxDist
+        r.fMaxDist = fMaxDist;
+        r.fToX = fPx + fMaxDist * rRay.fDirX;
+        r.fToY = fPy + fMaxDist * rRay.fDirY;
+        // direction vector and scaling factors are precalculated
+        r.fDX = rRay.fDX;
+        r.fDY = rRay.fDY;
+        r.fSX = rRay.fSX;
+        r.fSY = rRay.fSY;
+        // work out if line is going right or left resp. down or up
+        r.nGridStepX = (r.fDX > 0.0f) ? +1 : -1;
+        r.nGridStepY = (r.fDY > 0.0f) ? +1 : -1;
+
+        r.nCurX = int( r.fFromX );
+        r.nCurY = int( r.fFromY );
+
+        // work out the first intersections with the grid
+        if (r.nGridStepX < 0) { // ray is going left - get scaled difference between start point and left cell border
+            r.fLengthPartialRayX = (r.fFromX - float( r.nCurX )) * r.fSX;
+        } else {                // ray is going right - get scaled difference between right cell border and start point
+            r.fLengthPartialRayX = (float( r.nCurX + 1.0f ) - r.fFromX) * r.fSX;
+        }
+        if (r.nGridStepY < 0) { // ray is going up - get scaled difference between start point and top cell border
+            r.fLengthPartialRayY = (r.fFromY - float( r.nCurY )) * r.fSY;
+        } else {                // ray is going down - get scaled difference between bottom cell border and start point
+            r.fLengthPartialRayY = (float( r.nCurY + 1.0f ) - r.fFromY) * r.fSY;
+        }
+
+        r.fFirstPartialRayX = r.fLengthPartialRayX;
+        r.fFirstPartialRayY = r.fLengthPartialRayY;
+        r.nCrossingsX       = 0;
+        r.nCrossingsY       = 0;
+
+        r.fDistIfFound     = 0.0f;
+        r.nHitPointsFound  = 0;
+        r.nLayerLo         = 0;
+        r.nLayerHi         = rMap.NrOfLayers() - 1;
+        r.bOutOfBounds     = !rMap.IsInBounds( r.nCurX, r.nCurY );
+
+        // the fixed point variant works out the first intersections from the fixed point start point, so that all
+        // stepping is done in integer arithmetic
+        if (bFixedPointDDA) {
+            // the scaling factors are 1 / |direction component|, worked out in integer arithmetic from the direction
+            // with 32 fractional bits (the look up table values are unit length within float precision)
+            int64_t nDirX = int64_t( floor( std::abs( double( rRay.fDirX )) * double( int64_t( 1 ) << 32 ) + 0.5 ));
+            int64_t nDirY = int64_t( floor( std::abs( double( rRay.fDirY )) * double( int64_t( 1 ) << 32 ) + 0.5 ));
+            r.nSX      = (nDirX == 0) ? FIXED_MAX : std::min( FIXED_MAX, (int64_t( 1 ) << (32 + FIXED_SHIFT)) / nDirX );
+            r.nSY      = (nDirY == 0) ? FIXED_MAX : std::min( FIXED_MAX, (int64_t( 1 ) << (32 + FIXED_SHIFT)) / nDirY );
+            r.nMaxDist = to_fixed( fMaxDist );
+            int64_t nFromX = to_fixed( r.fFromX );
+            int64_t nFromY = to_fixed( r.fFromY );
+            int64_t nPartX = (r.nGridStepX < 0) ? nFromX - int64_t( r.nCurX ) * FIXED_ONE : int64_t( r.nCurX + 1 ) * FIXED_ONE - nFromX;
+            int64_t nPartY = (r.nGridStepY < 0) ? nFromY - int64_t( r.nCurY ) * FIXED_ONE : int64_t( r.nCurY + 1 ) * FIXED_ONE - nFromY;
+            r.nFirstPartialRayX  = r.nLengthPartialRayX = (nPartX * r.nSX) >> FIXED_SHIFT;
+            r.nFirstPartialRayY  = r.nLengthPartialRayY = (nPartY * r.nSY) >> FIXED_SHIFT;
+            r.nDistIfFound       = 0;
+        }
+        r.bDestCellReached = (r.nCurX == int( r.fToX ) && r.nCurY == int( r.fToY ));
+        // no occlusion driven termination, unless InitOcclusion() is called
+        r.pOccRows  = nullptr;
+        r.bOccluded = false;
+    }
+
+    // terminate the analysis of a ray if out of bounds or destination found or maxdistance exceeded, or if the rest of it is occluded
+    bool RayActive( RayState &r ) {
+        return !r.bOutOfBounds && !r.bDestCellReached && !r.bOccluded && (bFixedPointDDA ? r.nDistIfFound < r.nMaxDist : r.fDistIfFound < r.fMaxDist);
+    }
+
+    // advance ray r to the next map cell, depending on length of partial ray's
+    void StepRay( RayState &r ) {
+        if (bFixedPointDDA) {
+            // same as below, in fixed point
+            if (r.nLengthPartialRayX < r.nLengthPartialRayY) {
+                r.nCurX += r.nGridStepX;
+                r.nDistIfFound = r.nLengthPartialRayX;
+                r.nCrossingsX += 1;
+                r.nLengthPartialRayX = r.nFirstPartialRayX + r.nCrossingsX * r.nSX;
+                r.bCheckHor = false;
+            } else {
+                r.nCurY += r.nGridStepY;
+                r.nDistIfFound = r.nLengthPartialRayY;
+                r.nCrossingsY += 1;
+                r.nLengthPartialRayY = r.nFirstPartialRayY + r.nCrossingsY * r.nSY;
+                r.bCheckHor = true;
+            }
+            r.fDistIfFound = from_fixed( r.nDistIfFound );
+        } else if (r.fLengthPartialRayX < r.fLengthPartialRayY) {
+            // continue analysis in x direction
+            r.nCurX += r.nGridStepX;
+            r.fDistIfFound = r.fLengthPartialRayX;
+            r.nCrossingsX += 1;
+            r.fLengthPartialRayX = r.fFirstPartialRayX + r.nCrossingsX * r.fSX;
+            r.bCheckHor = false;
+        } else {
+            // continue analysis in y direction
+            r.nCurY += r.nGridStepY;
+            r.fDistIfFound = r.fLengthPartialRayY;
+            r.nCrossingsY += 1;
+            r.fLengthPartialRayY = r.fFirstPartialRayY + r.nCrossingsY * r.fSY;
+            r.bCheckHor = true;
+        }
+    }
+
+    // Skips the next nCrossX grid crossings in x direction and nCrossY grid crossings in y direction of ray r, as far as these crossings
+    // come before the ray leaves the rectangle of cells spanned by them. The caller must make sure that all cells in that rectangle are
+    // empty: the crossings within it would only produce empty (redundant) hit points, so they are skipped by advancing the crossing
+    // counters and the cell coordinates directly. The result is exactly the state that StepRay() would have reached.
+    void SkipCrossings( RayState &r, int nCrossX, int nCrossY ) {
+        if (nCrossX > 0 || nCrossY > 0) {
+            // The lengths of the partial rays after i crossings, exactly as StepRay() calculates them. They are returned as double, which
+            // can represent both the float and the fixed point values exactly, so that the comparisons below give the same results.
+            auto length_x = [&]( int i ) -> double { return bFixedPointDDA ? double( r.nFirstPartialRayX + i * r.nSX ) : double( r.fFirstPartialRayX + i * r.fSX ); };
+            auto length_y = [&]( int i ) -> double { return bFixedPointDDA ? double( r.nFirstPartialRayY + i * r.nSY ) : double( r.fFirstPartialRayY + i * r.fSY ); };
+            double fMaxDist = bFixedPointDDA ? double( r.nMaxDist ) : double( r.fMaxDist );
+            double fSX      = bFixedPointDDA ? double( r.nSX      ) : double( r.fSX      );
+            double fSY      = bFixedPointDDA ? double( r.nSY      ) : double( r.fSY      );
+
+            // distances at which the ray crosses the border of the empty rectangle in x resp. y direction
+            double fExitX = length_x( r.nCrossingsX + nCrossX );
+            double fExitY = length_y( r.nCrossingsY + nCrossY );
+            // the ray leaves the rectangle at the smallest of these two, but don't skip beyond the max distance
+            double fExit  = std::min( std::min( fExitX, fExitY ), fMaxDist );
+            // estimate the nr of x and y grid crossings that are before the exit distance
+            int nSkipX = (fExitX <= fExit) ? nCrossX : std::clamp( int( ceil( (fExit - length_x( r.nCrossingsX )) / fSX )), 0, nCrossX );
+            int nSkipY = (fExitY <= fExit) ? nCrossY : std::clamp( int( ceil( (fExit - length_y( r.nCrossingsY )) / fSY )), 0, nCrossY );
+
+            // Due to rounding the estimate can be off by one. Correct it, so that the skipped crossings are exactly the ones StepRay()
+            // would have passed first: the last skipped crossing in either direction must come before the first non skipped crossing
+            // in the other direction (on a tie StepRay() takes the y crossing first), and all skipped crossings must be within max distance
+            bool bCorrected = true;
+            while (bCorrected) {
+                int nNextX = r.nCrossingsX + nSkipX;
+                int nNextY = r.nCrossingsY + nSkipY;
+                bCorrected = false;
+                if (nSkipX > 0 && !(length_x( nNextX - 1 ) < length_y( nNextY ) && length_x( nNextX - 1 ) < fMaxDist)) {
+                    nSkipX -= 1;
+                    bCorrected = true;
+                } else if (nSkipY > 0 && ((length_x( nNextX ) < length_y( nNextY - 1 )) || !(length_y( nNextY - 1 ) < fMaxDist))) {
+                    nSkipY -= 1;
+                    bCorrected = true;
+                }
+            }
+            // and skip them
+            if (nSkipX > 0) {
+                r.nCurX += nSkipX * r.nGridStepX;
+                r.nCrossingsX += nSkipX;
+                if (bFixedPointDDA) {
+                    r.nLengthPartialRayX = r.nFirstPartialRayX + r.nCrossingsX * r.nSX;
+                } else {
+                    r.fLengthPartialRayX = r.fFirstPartialRayX + r.nCrossingsX * r.fSX;
+                }
+            }
+            if (nSkipY > 0) {
+                r.nCurY += nSkipY * r.nGridStepY;
+                r.nCrossingsY += nSkipY;
+                if (bFixedPointDDA) {
+                    r.nLengthPartialRayY = r.nFirstPartialRayY + r.nCrossingsY * r.nSY;
+                } else {
+                    r.fLengthPartialRayY = r.fFirstPartialRayY + r.nCrossingsY * r.fSY;
+                }
+            }
+        }
+    }
+
+    // Empty space skipping for the DDA functions, for layer nLayer (or all layers combined if nLayer == -1) of map rMap:
+    //   1. if the ray is in a cell with distance field value d, all cells within a square of radius (d - 1) around it are empty,
+    //      so it can skip to the border of that square
+    //   2. if the ray is in an empty block of the occupancy pyramid, it can skip to the last cell of that block on its path. Since the
+    //      distance field already covers the small empty areas, this is only tried if the distance field value was saturated.
+    // The destination cell might be passed while skipping, so the caller must check that afterwards.
+    void SkipEmptySpace( RC_Map &rMap, int nLayer, RayState &r ) {
+        bool bSaturated = true;
+        if (bSkipEmptyCells) {
+            int nDist = (nLayer >= 0 ? rMap.DistFieldAt( r.nCurX, r.nCurY, nLayer ) : rMap.DistFieldAllAt( r.nCurX, r.nCurY ));
+            SkipCrossings( r, nDist - 1, nDist - 1 );
+            bSaturated = (nDist >= DIST_FIELD_MAX);
+        }
+        if (bSkipEmptyBlocks && bSaturated) {
+            int nLevel = rMap.EmptyBlockLevel( r.nCurX, r.nCurY, nLayer );
+            if (nLevel > 0) {
+                // work out the bounds of the block, clipped to the map
+                int nShift = OCC_BLOCK_SHIFT( nLevel );
+                int nMinX = (r.nCurX >> nShift) << nShift, nMaxX = std::min( nMinX + (1 << nShift), rMap.GetWidth()  ) - 1;
+                int nMinY = (r.nCurY >> nShift) << nShift, nMaxY = std::min( nMinY + (1 << nShift), rMap.GetHeight() ) - 1;
+                SkipCrossings( r, (r.nGridStepX > 0) ? nMaxX - r.nCurX : r.nCurX - nMinX,
+                                  (r.nGridStepY > 0) ? nMaxY - r.nCurY : r.nCurY - nMinY );
+            }
+        }
+        r.bDestCellReached = (r.nCurX == int( r.fToX ) && r.nCurY == int( r.fToY ));
+    }
+
+    // Implementation of the DDA algorithm.
+    // This function uses nCurMap as the index into the vMaps array to obtain the correct map.
+    // It then casts the ray from (fPx, fPy, nPz) in the direction of camera ray rRay:
+    // A "to point" is determined using the ray direction and fMaxDist. A ray is cast from the "from point" to the "to point".
+    // In this new version of the DDA function, all intersections with all grid lines are recorded. That implies that they need to
+    // be filtered afterwards. This is done to get better control on how to process the rendering with different types of map cells
+    // encountered along the way.
+    bool CastRayPerLevelAndAngle( int nCurMap, float fPx, float fPy, int nPz, const CameraRayRec &rRay, float fMaxDist, std::vector<IntersectInfo> &vHitList ) {
+
+        // get a reference to the map
+        RC_Map &pCurMap = vMaps[ nCurMap ];
+        // counter for nr of hit points found
+        int nHitPointsFound = 0;
+
+        // set up the ray from the "from point" (the player's position) to the "to point" (using the ray angle and fMaxDist)
+        RayState sRay;
+        InitRayState( pCurMap, sRay, fPx, fPy, rRay, fMaxDist );
+
+        // lambda to return index value of face that was hit
+        auto get_face_hit = [=]( bool bHorGridLine ) {
+            int nFaceValue = FACE_UNKNOWN;
+            if (bHorGridLine) {
+                nFaceValue = (sRay.nGridStepY < 0 ? FACE_SOUTH : FACE_NORTH);
+            } else {
+                nFaceValue = (sRay.nGridStepX < 0 ? FACE_EAST  : FACE_WEST );
+            }
+            return nFaceValue;
+        };
+
+        // convenience lambda to add hit point with one call
+        auto add_hit_point = [&]( std::vector<IntersectInfo> &vHList, float fDst, int nTileX, int nTileY, float fHght, int nLayer, bool bHorGrid ) {
+            IntersectInfo sInfo;
+
+            sInfo.fDistFrnt_raw = fDst;
+            sInfo.nHitX      = nTileX;
+            sInfo.nHitY      = nTileY;
+            sInfo.fHeight    = fHght;
+            sInfo.nLayer     = nLayer;
+            sInfo.nFaceHit   = get_face_hit( bHorGrid );
+
+            vHList.push_back( sInfo );
+        };
+
+        float fCurHeight   = 0.0f;  // to check on differences in height
+
+        // terminate the loop / algorithm if out of bounds or destinion found or maxdistance exceeded
+        // Note: the latter scenario shouldn't occur, since fDistIfFound == fMaxDist in the destination point
+        while (RayActive( sRay )) {
+
+            // jump across empty areas using the occupancy pyramid and distance field for this layer
+            if (bSkipEmptyCells || bSkipEmptyBlocks) {
+                SkipEmptySpace( pCurMap, nPz, sRay );
+                if (sRay.bDestCellReached) break;
+            }
+
+            // advance to next map cell, depending on length of partial ray's
+            StepRay( sRay );
+
+            sRay.bOutOfBounds = !pCurMap.IsInBounds( sRay.nCurX, sRay.nCurY );
+            // check if destination cell is found already (for loop control)
+            sRay.bDestCellReached = (sRay.nCurX == int( sRay.fToX ) && sRay.nCurY == int( sRay.fToY ));
+
+            if (sRay.bOutOfBounds) {
+                // If out of bounds, finalize the list with one additional intersection with the map boundary and height 0.
+                // This additional intersection record is necessary for proper rendering at map boundaries.
+                    fCurHeight = 0.0f;  // since we're out of bounds
+                add_hit_point( vHitList, sRay.fDistIfFound, sRay.nCurX, sRay.nCurY, fCurHeight, nPz, sRay.bCheckHor );
+            } else {
+
+                nHitPointsFound += 1;
+                // set current height to new value
+                fCurHeight = pCurMap.CellHeightAt( sRay.nCurX, sRay.nCurY, nPz );
+                // put the collision info in a new IntersectInfo node and push it up the hit list
+                add_hit_point( vHitList, sRay.fDistIfFound, sRay.nCurX, sRay.nCurY, fCurHeight, nPz, sRay.bCheckHor );
+            }
+        }
+        // return whether any hitpoints were found on this layer
+        return (nHitPointsFound > 0);
+    }
+
+// ==============================/   occlusion driven ray termination   /==============================
+
+    // The DDA can stop a ray as soon as nothing beyond the current point can become visible in the sub slice it is cast for. For this, the
+    // rows of the sub slice that are covered by opaque walls (of all layers) are kept in a bit set per ray. Geometry beyond distance d can
+    // only project between the top of the highest layer and the bottom of the lowest layer at distance d, so once all rows in that range
+    // are covered, the rest of the ray is occluded. The ray is only stopped at a grid crossing where none of the layers is inside a block,
+    // so that the back faces of the blocks that were hit are still found (these are needed for the roofs and ceilings).
+    // NOTE: this only works with the fused filtering, since the hit points emitted by it are exactly the walls that will be rendered
+
+    // returns a pointer to the bit set of the current thread, which has room for all screen rows
+    uint64_t *GetOccRows() {
+        std::vector<uint64_t> &vOccRows = GetScratch().vOccRows;
+        int nWords = (RenderHeight() + 63) / 64;
+        if ((int)vOccRows.size() < nWords) {
+            vOccRows.resize( nWords );
+        }
+        return vOccRows.data();
+    }
+
+    // sets up ray r for occlusion driven termination in the sub slice described by pOcc (nullptr switches it off). pRows is the bit set
+    // to use for this ray, see GetOccRows()
+    void InitOcclusion( RayState &r, const OcclusionRec *pOcc, float fViewCos, uint64_t *pRows ) {
+        r.bOccluded = false;
+        r.pOccRows  = (pOcc == nullptr) ? nullptr : pRows;
+        if (pOcc != nullptr) {
+            r.sOcc        = *pOcc;
+            r.sOcc.nStrtY = std::max( r.sOcc.nStrtY, 0 );
+            r.sOcc.nStopY = std::min( r.sOcc.nStopY, RenderHeight() - 1 );
+            r.fViewCos    = fViewCos;
+            memset( pRows, 0, ((RenderHeight() + 63) / 64) * sizeof( uint64_t ));
+        }
+    }
+
+    // returns whether ray r was set up for the same sub slice and fish eye correction
+    bool SameOcclusion( RayState &r, const OcclusionRec &rOcc, float fViewCos ) {
+        return r.sOcc.fPh    == rOcc.fPh    && r.sOcc.nHorHght == rOcc.nHorHght && r.sOcc.fStrtDist == rOcc.fStrtDist &&
+               r.sOcc.nStrtY == rOcc.nStrtY && r.sOcc.nStopY   == rOcc.nStopY   && r.fViewCos       == fViewCos;
+    }
+
+    // Applies fAction to each part of the bit set of ray r that holds rows nFrom .. nTo (clipped to the rows of the sub slice),
+    // passing the word index and the mask of the bits for these rows within that word. Stops if fAction returns false.
+    template<typename T>
+    bool ForEachRowMask( RayState &r, int nFrom, int nTo, T fAction ) {
+        nFrom = std::max( nFrom, r.sOcc.nStrtY );
+        nTo   = std::min( nTo  , r.sOcc.nStopY );
+        for (int y = nFrom; y <= nTo; ) {
+            int nBit  = y & 63;
+            int nBits = std::min( 64 - nBit, nTo - y + 1 );
+            uint64_t nMask = ((nBits == 64) ? ~uint64_t( 0 ) : ((uint64_t( 1 ) << nBits) - 1)) << nBit;
+            if (!fAction( y >> 6, nMask ))
+                return false;
+            y += nBits;
+        }
+        return true;
+    }
+
+    // returns whether the wall of hit point rHit is opaque: a non empty block of which the face that was hit, the top and the bottom face
+    // are not transparent
+    bool IsOpaqueHit( RC_Map &rMap, const IntersectInfo &rHit ) {
+        if (rHit.fHeight <= 0.0f)
+            return false;
+        RC_MapCell *pCell = rMap.MapCellPtrAt( rHit.nHitX, rHit.nHitY, rHit.nLayer );
+        return !pCell->GetFacePtr( rHit.nFaceHit )->IsTransparent() &&
+               !pCell->GetFacePtr( FACE_TOP      )->IsTransparent() &&
+               !pCell->GetFacePtr( FACE_BOTTOM   )->IsTransparent();
+    }
+
+    // If the wall of hit point rHit is opaque, the rows it covers on screen are marked in the bit set of ray r. The projections are worked
+    // out exactly like RenderSubSlice() does. pAbove is the hit point of the layer above at the same grid crossing (or nullptr). If both
+    // are opaque and rHit is full height, the row between the two walls is covered as well (by the roof or ceiling that's rendered there)
+    void AddOccluder( RC_Map &rMap, RayState &r, const IntersectInfo &rHit, const IntersectInfo *pAbove ) {
+        if (!IsOpaqueHit( rMap, rHit ))
+            return;
+        float fDistCorr = rHit.fDistFrnt_raw * r.fViewCos;
+        fDistCorr += r.sOcc.fStrtDist;
+        if (fDistCorr <= 0.0f)
+            return;
+        int nTop, nBot;
+        CalculateBlockProjections( CalculateSliceHeight( fDistCorr ), r.sOcc.fPh, r.sOcc.nHorHght, rHit.nLayer, rHit.fHeight, nTop, nBot );
+        if (pAbove != nullptr && rHit.fHeight >= 1.0f && IsOpaqueHit( rMap, *pAbove )) {
+            nTop -= 1;
+        }
+        ForEachRowMask( r, nTop + 1, nBot - 1, [&]( int nWord, uint64_t nMask ) { r.pOccRows[ nWord ] |= nMask; return true; } );
+    }
+
+    // returns whether all rows of the sub slice that geometry at or beyond distance fDist (raw) can project on are covered for ray r
+    bool IsOccluded( RayState &r, float fDist ) {
+        float fDistCorr = fDist * r.fViewCos;
+        fDistCorr += r.sOcc.fStrtDist;
+        if (fDistCorr <= 0.0f)
+            return false;
+        // a farther wall has a smaller (or equal) projected slice height, so the top of the highest layer and the bottom of the lowest
+        // layer (of the ones that are cast) at this distance bound what can still become visible. If the view point is above the highest
+        // layer, roofs can be visible up to the horizon
+        int nSliceHeight = CalculateSliceHeight( fDistCorr );
+        int nTop, nBot, nDummy;
+        CalculateBlockProjections( nSliceHeight, r.sOcc.fPh, r.sOcc.nHorHght, r.nLayerHi, 1.0f, nTop, nDummy );
+        CalculateBlockProjections( nSliceHeight, r.sOcc.fPh, r.sOcc.nHorHght, r.nLayerLo, 1.0f, nDummy, nBot );
+        if (r.sOcc.fPh > float( r.nLayerHi + 1 )) {
+            nTop = r.sOcc.nHorHght;
+        }
+        return ForEachRowMask( r, nTop, nBot, [&]( int nWord, uint64_t nMask ) { return (r.pOccRows[ nWord ] & nMask) == nMask; } );
+    }
+
+    // Called after the hit points of a grid crossing were emitted into vHitLists: marks the rows covered by the walls at this crossing, and
+    // stops ray r if the rest of it is occluded. The latter is only done if none of the layers is inside a block.
+    void UpdateOcclusion( RC_Map &rMap, RayState &r, std::vector<std::vector<IntersectInfo>> &vHitLists ) {
+        // returns the hit point that layer k got at this crossing, or nullptr if there's none
+        auto get_crossing_hit = [&]( int k ) -> IntersectInfo * {
+            if (k >= (int)vHitLists.size() || vHitLists[k].empty()) return nullptr;
+            IntersectInfo &rLast = vHitLists[k].back();
+            return (rLast.fDistFrnt_raw == r.fDistIfFound && rLast.nHitX == r.nCurX && rLast.nHitY == r.nCurY) ? &rLast : nullptr;
+        };
+        bool bInsideBlock = false;
+        for (int k = 0; k < (int)vHitLists.size(); k++) {
+            IntersectInfo *pHit = get_crossing_hit( k );
+            if (pHit != nullptr) {
+                AddOccluder( rMap, r, *pHit, get_crossing_hit( k + 1 ));
+            }
+            bInsideBlock |= (!vHitLists[k].empty() && vHitLists[k].back().fHeight > 0.0f);
+        }
+        r.bOccluded = !bInsideBlock && IsOccluded( r, r.fDistIfFound );
+    }
+
+    // Continues ray r from the point where it was stopped by the occlusion test, if it's not occluded for sub slice pOcc and fish eye
+    // correction fViewCos (e.g. the cached ray is reused for another screen column, or the player looks up or down).
+    // vHitLists must hold the hit points that were found for r so far.
+    void ResumeOccludedRay( RC_Map &rMap, RayState &r, const OcclusionRec *pOcc, float fViewCos, std::vector<std::vector<IntersectInfo>> &vHitLists ) {
+        InitOcclusion( r, pOcc, fViewCos, GetOccRows());
+        if (pOcc != nullptr) {
+            // redo the occlusion test over the hit points so far. The hit points of a grid crossing have the same distance and tile
+            // coordinates in all layers, and each list is sorted on distance
+            for (int k = 0; k < (int)vHitLists.size(); k++) {
+                int j = 0;
+                for (auto &elt : vHitLists[k]) {
+                    IntersectInfo *pAbove = nullptr;
+                    if (k + 1 < (int)vHitLists.size()) {
+                        std::vector<IntersectInfo> &vAbove = vHitLists[k + 1];
+                        while (j < (int)vAbove.size() && vAbove[j].fDistFrnt_raw < elt.fDistFrnt_raw) j++;
+                        for (int i = j; i < (int)vAbove.size() && vAbove[i].fDistFrnt_raw == elt.fDistFrnt_raw && pAbove == nullptr; i++) {
+                            if (vAbove[i].nHitX == elt.nHitX && vAbove[i].nHitY == elt.nHitY) pAbove = &vAbove[i];
+                        }
+                    }
+                    AddOccluder( rMap, r, elt, pAbove );
+                }
+            }
+            r.bOccluded = IsOccluded( r, r.fDistIfFound );
+        }
+        TraverseRay( rMap, r, vHitLists );
+    }
+
+    // Having stepped ray r to its next grid crossing, this function does the bounds checks and emits the hit points for all layers
+    // at that crossing (only the layers in the range of r, the other hit lists stay empty). pPrevHeightColumn points to the heights of
+    // the cell the ray came from
+    void EmitLayerHits( RC_Map &rMap, RayState &r, float *pPrevHeightColumn, std::vector<std::vector<IntersectInfo>> &vHitLists ) {
+
+        r.bOutOfBounds = !rMap.IsInBounds( r.nCurX, r.nCurY );
+        // check if destination cell is found already (for loop control)
+        r.bDestCellReached = (r.nCurX == int( r.fToX ) && r.nCurY == int( r.fToY ));
+
+        // the hit info is identical for all layers, except for the layer and the height
+        IntersectInfo sInfo;
+        sInfo.fDistFrnt_raw = r.fDistIfFound;
+        sInfo.nHitX         = r.nCurX;
+        sInfo.nHitY         = r.nCurY;
+        if (r.bCheckHor) {
+            sInfo.nFaceHit = (r.nGridStepY < 0 ? FACE_SOUTH : FACE_NORTH);
+        } else {
+            sInfo.nFaceHit = (r.nGridStepX < 0 ? FACE_EAST  : FACE_WEST );
+        }
+
+        if (r.bOutOfBounds) {
+            // If out of bounds, finalize the lists with one additional intersection with the map boundary and height 0.
+            // This additional intersection record is necessary for proper rendering at map boundaries.
+            sInfo.fHeight = 0.0f;
+            for (int k = r.nLayerLo; k <= r.nLayerHi; k++) {
+                sInfo.nLayer = k;
+                vHitLists[k].push_back( sInfo );
+            }
+        } else {
+            r.nHitPointsFound += 1;
+            bool bEmitted = false;
+            // grab the heights and boundary masks for all layers of this map cell at once
+            float   *pHeightColumn   = rMap.HeightColumnAt(   r.nCurX, r.nCurY );
+            uint8_t *pBoundaryColumn = rMap.BoundaryColumnAt( r.nCurX, r.nCurY );
+            // if the ray reaches its max. length at this crossing, the runs of equal blocks it's in are closed with a hit point here,
+            // otherwise the last run of a layer has no back (and its roof or ceiling isn't rendered)
+            bool bRayEnds = !RayActive( r );
+            for (int k = r.nLayerLo; k <= r.nLayerHi; k++) {
+                // fused filtering: only emit hit points at real boundaries (height changes, portal faces and transparent faces).
+                // This replaces PostFilterHitList() for this DDA variant. Like the post filter, empty cells at the start of the list
+                // are skipped, and the first non-empty cell is always emitted (the ray may start inside a run of equal blocks)
+                if (DDA_FUSED_FILTER && !(bRayEnds && pHeightColumn[k] > 0.0f)) {
+                    bool bBoundary;
+                    if (vHitLists[k].empty()) {
+                        bBoundary = pHeightColumn[k] > 0.0f;
+                    } else {
+                        bBoundary = (pBoundaryColumn[k] & BOUNDARY_STATIC( sInfo.nFaceHit )) ||
+                                   ((pBoundaryColumn[k] & BOUNDARY_DYNAMIC( sInfo.nFaceHit )) && pHeightColumn[k] != pPrevHeightColumn[k]);
+                    }
+                    if (!bBoundary) continue;
+                }
+                sInfo.fHeight = pHeightColumn[k];
+                sInfo.nLayer  = k;
+                vHitLists[k].push_back( sInfo );
+                bEmitted = true;
+            }
+            // the occlusion is only checked at crossings where something was emitted (i.e. mostly walls)
+            if (r.pOccRows != nullptr && bEmitted) {
+                UpdateOcclusion( rMap, r, vHitLists );
+            }
+        }
+    }
+
+    // traverses ray r (from its current state) until it gets inactive, emitting the hit points into vHitLists
+    void TraverseRay( RC_Map &rMap, RayState &r, std::vector<std::vector<IntersectInfo>> &vHitLists ) {
+
+        while (RayActive( r )) {
+
+            // jump across areas that are empty in all layers using the combined occupancy pyramid and distance field
+            if (bSkipEmptyCells || bSkipEmptyBlocks) {
+                SkipEmptySpace( rMap, -1, r );
+                if (r.bDestCellReached) break;
+            }
+            // keep track of the cell the ray comes from, to compare heights against for the fused filtering
+            float *pPrevHeightColumn = rMap.HeightColumnAt( r.nCurX, r.nCurY );
+
+            // advance to next map cell, depending on length of partial ray's
+            StepRay( r );
+
+            EmitLayerHits( rMap, r, pPrevHeightColumn, vHitLists );
+        }
+    }
+
+    // makes sure there's an (empty) hit list per layer in vHitLists
+    void ClearLayerHitLists( int nLayers, std::vector<std::vector<IntersectInfo>> &vHitLists ) {
+        vHitLists.resize( nLayers );
+        for (auto &elt : vHitLists) {
+            elt.clear();
+        }
+    }
+
+    // Multi layer variant of the DDA algorithm.
+    // Instead of casting one ray per layer, the grid is traversed only once. At each grid crossing a hit point is recorded
+    // for every layer of the map, using the column of layer heights that RC_Map keeps per (x, y). This way the cost of a ray
+    // depends on the grid distance covered, and much less on the number of layers.
+    // The result is one hit list per layer in vHitLists, identical to calling CastRayPerLevelAndAngle() for each layer separately.
+    // If pOcc is passed, the ray is stopped as soon as the rest of it is occluded in that sub slice (see UpdateOcclusion()). The hit lists
+    // are then the first part of the full hit lists.
+    // Only the layers nLayerLo .. nLayerHi are cast, the hit lists of the other layers are left empty.
+    bool CastRayAllLevelsAndAngle( int nCurMap, float fPx, float fPy, const CameraRayRec &rRay, float fMaxDist, std::vector<std::vector<IntersectInfo>> &vHitLists, const OcclusionRec *pOcc = nullptr, int nLayerLo = 0, int nLayerHi = INT_MAX ) {
+
+        // get a reference to the map
+        RC_Map &rCurMap = vMaps[ nCurMap ];
+        ClearLayerHitLists( rCurMap.NrOfLayers(), vHitLists );
+
+        RayState sRay;
+        InitRayState( rCurMap, sRay, fPx, fPy, rRay, fMaxDist );
+        sRay.nLayerLo = std::max( sRay.nLayerLo, nLayerLo );
+        sRay.nLayerHi = std::min( sRay.nLayerHi, nLayerHi );
+        InitOcclusion( sRay, pOcc, rRay.fViewCos, GetOccRows());
+        TraverseRay( rCurMap, sRay, vHitLists );
+
+        // return whether any hitpoints were found
+        return (sRay.nHitPointsFound > 0);
+    }
+
+    // cache record for the hit lists of a first level ray, see GetCachedHitLists()
+    // NOTE: the hit lists only depend on the direction vector of the ray, and that only depends on the index into the trig look up
+    // tables. So rays with the same look up index give identical hit lists.
+    typedef struct sRayCacheRec {
+        bool  bValid = false;
+        int   nMap;                  // map, position and angle (as look up index) the ray was cast for
+        float fPx, fPy;
+        int   nAngleIndex;
+        int   nChangeCount;          // change count of the map when the ray was cast
+        RayState sState;             // final state of the ray, to resume it if it was stopped by the occlusion test
+        std::vector<std::vector<IntersectInfo>> vHitLists;    // one hit list per layer
+    } RayCacheRec;
+    std::vector<RayCacheRec> vRayCache;          // one cache record per screen column
+    std::vector<RayCacheRec> vRayCacheScratch;   // scratch container for shifting the cache records over the columns
+    std::vector<int>         vChangedCells;      // scratch container for validating the cache records
+
+    // After a rotation of fDeltaA_deg degrees, moves the ray cache records to the column that now has the same ray angle (look up index).
+    // Records that don't fit any column anymore are invalidated, so only the newly exposed columns at the edges need casting.
+    // If bCanShift is false (e.g. the screen width changed) the whole cache is invalidated.
+    void ShiftRayCache( bool bCanShift, float fDeltaA_deg ) {
+        vRayCacheScratch.resize( RenderWidth() );
+        // the nr of columns the rays have shifted - the look up index may deviate one column either way
+        int nShift = int( roundf( fDeltaA_deg / fAnglePerPixel_deg ));
+        for (int x = 0; x < RenderWidth(); x++) {
+            vRayCacheScratch[x].bValid = false;
+            if (DDA_TEMPORAL_REUSE && bCanShift) {
+                int nAngleIndex = lu_index( vCameraRays[x].fCurAngle_deg );
+                for (int nOld = x + nShift - 1; nOld <= x + nShift + 1; nOld++) {
+                    if (nOld >= 0 && nOld < (int)vRayCache.size() && vRayCache[ nOld ].bValid && vRayCache[ nOld ].nAngleIndex == nAngleIndex) {
+                        std::swap( vRayCacheScratch[x], vRayCache[ nOld ] );
+                        vRayCache[ nOld ].bValid = false;
+                        break;
+                    }
+                }
+            }
+        }
+        vRayCache.swap( vRayCacheScratch );
+    }
+
+    // Invalidates the ray cache records of rays that pass through a map cell that changed height after the ray was cast.
+    void ValidateRayCache() {
+        // the ray can be considered as a line segment from (fPx, fPy) with length GetRayLength()
+        auto ray_touches_cell = [=]( RayCacheRec &rec, CameraRayRec &ray, int nCellX, int nCellY ) {
+            // slab test: clip the segment against the x and y slabs of the cell (slightly enlarged to be on the safe side)
+            float fMin = 0.0f, fMax = GetRayLength( rec.nMap, 0.0f );
+            float vOrg[2] = { rec.fPx, rec.fPy };
+            float vDir[2] = { ray.fDX, ray.fDY };
+            float vLo[2]  = { nCellX - 0.01f, nCellY - 0.01f };
+            float vHi[2]  = { nCellX + 1.01f, nCellY + 1.01f };
+            for (int i = 0; i < 2; i++) {
+                if (vDir[i] == 0.0f) {
+                    if (vOrg[i] < vLo[i] || vOrg[i] > vHi[i]) return false;
+                } else {
+                    float fT1 = (vLo[i] - vOrg[i]) / vDir[i];
+                    float fT2 = (vHi[i] - vOrg[i]) / vDir[i];
+                    fMin = std::max( fMin, std::min( fT1, fT2 ));
+                    fMax = std::min( fMax, std::max( fT1, fT2 ));
+                }
+            }
+            return fMin <= fMax;
+        };
+
+        for (int x = 0; x < (int)vRayCache.size(); x++) {
+            RayCacheRec &rec = vRayCache[x];
+            if (!DDA_TEMPORAL_REUSE) {
+                rec.bValid = false;
+            }
+            if (!rec.bValid || rec.nMap >= (int)vMaps.size()) {
+                rec.bValid = false;
+                continue;
+            }
+            RC_Map &rMap = vMaps[ rec.nMap ];
+            if (rec.nChangeCount != rMap.GetChangeCount()) {
+                if (!rMap.GetChangedCells( rec.nChangeCount, vChangedCells )) {
+                    rec.bValid = false;
+                } else {
+                    for (int i = 0; i < (int)vChangedCells.size() && rec.bValid; i++) {
+                        rec.bValid = !ray_touches_cell( rec, vCameraRays[x], vChangedCells[i] % rMap.GetWidth(), vChangedCells[i] / rMap.GetWidth() );
+                    }
+                }
+                rec.nChangeCount = rMap.GetChangeCount();
+            }
+        }
+    }
+
+    // returns whether the ray cache record of column x holds the hit lists for camera ray rRay from (fPx, fPy) in map nCurMap
+    bool IsColumnCached( int x, int nCurMap, float fPx, float fPy, const CameraRayRec &rRay ) {
+        RayCacheRec &rec = vRayCache[x];
+        return rec.bValid && rec.nMap == nCurMap && rec.fPx == fPx && rec.fPy == fPy && rec.nAngleIndex == lu_index( rRay.fCurAngle_deg );
+    }
+
+    // sets the identification of ray cache record rec after its hit lists were cast for camera ray rRay from (fPx, fPy) in map nCurMap
+    void SetColumnCached( RayCacheRec &rec, int nCurMap, float fPx, float fPy, const CameraRayRec &rRay ) {
+        rec.bValid       = true;
+        rec.nMap         = nCurMap;
+        rec.fPx          = fPx;
+        rec.fPy          = fPy;
+        rec.nAngleIndex  = lu_index( rRay.fCurAngle_deg );
+        rec.nChangeCount = vMaps[ nCurMap ].GetChangeCount();
+    }
+
+    // gets the camera ray of (first level) screen column x, for view angle fVPAngle_deg
+    void GetColumnRay( int x, float fVPAngle_deg, CameraRayRec &rRay ) {
+        // NOTE: this must be calculated exactly like the angles of the initial sub slices in OnUserUpdate()
+        float fViewAngle_deg = float( x - (RenderWidth() / 2)) * fAnglePerPixel_deg;
+        GetCameraRay( x, fViewAngle_deg, fVPAngle_deg + fViewAngle_deg, rRay );
+    }
+
+    // Obtains the hit lists for a first level sub slice (i.e. not seen through a portal) from the ray cache. On a cache miss the ray of this
+    // sub slice is cast into the cache, or (if bAdaptiveColumns is set) the next ADAPTIVE_COLUMN_STRIDE columns are filled in by adaptive
+    // subdivision, see RefineColumns(). This stays within the columns of the current thread. When the columns are interleaved, only every
+    // other column is rendered, so then only the columns of the same parity as nSlice are cast and filled in (see nColumnStep).
+    // A cache entry is only used if it was cast for exactly the same map, position and angle (look up index).
+    // The cached hit lists are kept over frames (see ShiftRayCache() and ValidateRayCache()), so a reference to them is returned.
+    // A cached ray that was stopped by the occlusion test for another sub slice or screen column (its fish eye correction differs) is
+    // resumed if it's not occluded for sub slice pOcc.
+    std::vector<std::vector<IntersectInfo>> &GetCachedHitLists( int nSlice, int nCurMap, float fPx, float fPy, const CameraRayRec &rRay, float fVPAngle_deg, const OcclusionRec *pOcc ) {
+
+        // only the columns of the current thread may be cast into the cache
+        int nColumnLo = std::max( GetScratch().nColumnLo, 0 );
+        int nColumnHi = std::min( GetScratch().nColumnHi, RenderWidth() - 1 );
+
+        if (IsColumnCached( nSlice, nCurMap, fPx, fPy, rRay )) {
+            // cache hit - nothing to cast
+        } else if (bAdaptiveColumns && DDA_FUSED_FILTER) {
+            // cache miss - cast the rays at the ends of the next stride of columns, and fill in the columns in between. If the column
+            // before this one is cached already, it's used as the first end, so that adjacent strides share their end column
+            int nA = nSlice;
+            int nB = nSlice + ((std::min( nSlice + ADAPTIVE_COLUMN_STRIDE * nColumnStep, nColumnHi ) - nSlice) / nColumnStep) * nColumnStep;
+            CameraRayRec sRayA = rRay, sRayB;
+            if (nSlice - nColumnStep >= nColumnLo) {
+                CameraRayRec sRayPrev;
+                GetColumnRay( nSlice - nColumnStep, fVPAngle_deg, sRayPrev );
+                if (IsColumnCached( nSlice - nColumnStep, nCurMap, fPx, fPy, sRayPrev )) {
+                    nA    = nSlice - nColumnStep;
+                    sRayA = sRayPrev;
+                }
+            }
+            GetColumnRay( nB, fVPAngle_deg, sRayB );
+            if (!IsColumnCached( nA, nCurMap, fPx, fPy, sRayA )) CastColumnIntoCache( nA, nCurMap, fPx, fPy, sRayA, pOcc );
+            if (!IsColumnCached( nB, nCurMap, fPx, fPy, sRayB )) CastColumnIntoCache( nB, nCurMap, fPx, fPy, sRayB, pOcc );
+            RefineColumns( nA, nB, nColumnStep, nCurMap, fPx, fPy, fVPAngle_deg, pOcc );
+        } else {
+            // cache miss - cast the ray of this column
+            CastColumnIntoCache( nSlice, nCurMap, fPx, fPy, rRay, pOcc );
+            // without the fused filter, the lists are filtered before they go into the cache
+            if (!DDA_FUSED_FILTER) {
+                for (auto &elt : vRayCache[ nSlice ].vHitLists) {
+                    PostFilterHitList( nCurMap, elt );
+                }
+            }
+        }
+        RayCacheRec &rec = vRayCache[ nSlice ];
+        if (rec.sState.bOccluded && (pOcc == nullptr || !SameOcclusion( rec.sState, *pOcc, rRay.fViewCos ))) {
+            ResumeOccludedRay( vMaps[ nCurMap ], rec.sState, pOcc, rRay.fViewCos, rec.vHitLists );
+        }
+        return rec.vHitLists;
+    }
+
+// ==============================/  adaptive column subdivision  /==============================
+
+    // Adjacent screen columns mostly hit the same faces of the same map cells. If the rays of two columns hit the same cells and faces in
+    // the same order, the rays of the columns in between do so too: a map cell they could hit, but the outer rays don't, would have to fit
+    // completely in between the outer rays, and the outer rays are less than a cell apart at the last face they hit. So for these columns
+    // the grid doesn't need to be traversed. Their hit points are copied from the outer ray, and only the distances are worked out, in the
+    // same way as the DDA does (first crossing + nr of crossings * scaling factor), so the hit lists are identical to the cast ones.
+    // Where the outer rays don't agree, the column range is split in two (recursively).
+    // NOTE: this relies on the fused filtering, since the hit lists then only hold the boundaries
+
+    // casts the ray of column x (scalar) into its ray cache record
+    void CastColumnIntoCache( int x, int nCurMap, float fPx, float fPy, const CameraRayRec &rRay, const OcclusionRec *pOcc ) {
+        RC_Map &rCurMap = vMaps[ nCurMap ];
+        RayCacheRec &rec = vRayCache[x];
+        ClearLayerHitLists( rCurMap.NrOfLayers(), rec.vHitLists );
+        InitRayState( rCurMap, rec.sState, fPx, fPy, rRay, GetRayLength( nCurMap, 0.0f ));
+        InitOcclusion( rec.sState, pOcc, rRay.fViewCos, GetOccRows());
+        TraverseRay( rCurMap, rec.sState, rec.vHitLists );
+        SetColumnCached( rec, nCurMap, fPx, fPy, rRay );
+        GetScratch().nRaysCast += 1;
+    }
+
+    // returns whether the cached rays rA and rB hit the same map cells and faces in the same order (in all layers), and both ended at a
+    // hit point (at the map boundary, or since the rest was occluded), so that the columns in between can be filled in from them
+    bool SameColumnHits( RayCacheRec &rA, RayCacheRec &rB ) {
+        if (!(rA.sState.bOutOfBounds || rA.sState.bOccluded) || !(rB.sState.bOutOfBounds || rB.sState.bOccluded))
+            return false;
+        if (rA.vHitLists.size() != rB.vHitLists.size())
+            return false;
+        for (int k = 0; k < (int)rA.vHitLists.size(); k++) {
+            std::vector<IntersectInfo> &vA = rA.vHitLists[k];
+            std::vector<IntersectInfo> &vB = rB.vHitLists[k];
+            if (vA.size() != vB.size())
+                return false;
+            for (int i = 0; i < (int)vA.size(); i++) {
+                if (vA[i].nHitX != vB[i].nHitX || vA[i].nHitY != vB[i].nHitY || vA[i].nFaceHit != vB[i].nFaceHit || vA[i].fHeight != vB[i].fHeight)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    // Fills in the ray cache record of column x from the hit lists of cached ray rFrom, which hits the same cells and faces (see
+    // SameColumnHits()). The grid crossings are replayed in order along the ray of column x, including the occlusion test, so that the ray
+    // is stopped at the same point as when it was cast. If it isn't occluded at the last hit point of rFrom, it's traversed further.
+    // Returns false (and leaves the record invalid) if the ray would get near its max length, the caller must cast it then.
+    bool FillInColumn( int x, RayCacheRec &rFrom, int nCurMap, float fPx, float fPy, const CameraRayRec &rRay, const OcclusionRec *pOcc ) {
+        RC_Map &rCurMap = vMaps[ nCurMap ];
+        RayCacheRec &rec = vRayCache[x];
+        RayState &r = rec.sState;
+        rec.bValid = false;
+        ClearLayerHitLists( rCurMap.NrOfLayers(), rec.vHitLists );
+        InitRayState( rCurMap, r, fPx, fPy, rRay, GetRayLength( nCurMap, 0.0f ));
+        InitOcclusion( r, pOcc, rRay.fViewCos, GetOccRows());
+        int nStartX = r.nCurX;
+        int nStartY = r.nCurY;
+
+        // lambda to get the distance at which this ray crosses face nFace into cell (nCellX, nCellY), exactly as StepRay() works it out
+        auto get_crossing_dist = [&]( int nCellX, int nCellY, int nFace ) {
+            bool bHor = (nFace == FACE_NORTH || nFace == FACE_SOUTH);
+            int nCross = bHor ? std::abs( nCellY - nStartY ) : std::abs( nCellX - nStartX );
+            if (bFixedPointDDA) {
+                return from_fixed( bHor ? r.nFirstPartialRayY + (nCross - 1) * r.nSY : r.nFirstPartialRayX + (nCross - 1) * r.nSX );
+            } else {
+                return bHor ? r.fFirstPartialRayY + (nCross - 1) * r.fSY : r.fFirstPartialRayX + (nCross - 1) * r.fSX;
+            }
+        };
+        // lambda to set ray r to the state StepRay() leaves it in after crossing face nFace into cell (nCellX, nCellY)
+        auto set_crossing = [&]( int nCellX, int nCellY, int nFace ) {
+            r.bCheckHor   = (nFace == FACE_NORTH || nFace == FACE_SOUTH);
+            r.nCurX       = nCellX;
+            r.nCurY       = nCellY;
+            r.nCrossingsX = std::abs( nCellX - nStartX );
+            r.nCrossingsY = std::abs( nCellY - nStartY );
+            if (bFixedPointDDA) {
+                r.nLengthPartialRayX = r.nFirstPartialRayX + r.nCrossingsX * r.nSX;
+                r.nLengthPartialRayY = r.nFirstPartialRayY + r.nCrossingsY * r.nSY;
+                r.nDistIfFound = r.bCheckHor ? r.nFirstPartialRayY + (r.nCrossingsY - 1) * r.nSY : r.nFirstPartialRayX + (r.nCrossingsX - 1) * r.nSX;
+            } else {
+                r.fLengthPartialRayX = r.fFirstPartialRayX + r.nCrossingsX * r.fSX;
+                r.fLengthPartialRayY = r.fFirstPartialRayY + r.nCrossingsY * r.fSY;
+            }
+            r.fDistIfFound = get_crossing_dist( nCellX, nCellY, nFace );
+        };
+        // the hit points of a grid crossing have the same cell and face in all layers. The next crossing is the one with the
+        // smallest distance along this ray (on a tie StepRay() takes the y crossing first). The replay stops where the DDA would stop
+        int nLayers = (int)rFrom.vHitLists.size();
+        std::vector<int> &vNext = GetScratch().vFillIn;
+        vNext.assign( nLayers, 0 );
+        bool bDone = false;
+        while (!bDone && RayActive( r )) {
+            int   nBest = -1;
+            float fBestDist = 0.0f;
+            bool  bBestHor  = false;
+            for (int k = 0; k < nLayers; k++) {
+                if (vNext[k] < (int)rFrom.vHitLists[k].size()) {
+                    IntersectInfo &rHit = rFrom.vHitLists[k][ vNext[k] ];
+                    float fDist = get_crossing_dist( rHit.nHitX, rHit.nHitY, rHit.nFaceHit );
+                    bool  bHor  = (rHit.nFaceHit == FACE_NORTH || rHit.nFaceHit == FACE_SOUTH);
+                    if (nBest < 0 || fDist < fBestDist || (fDist == fBestDist && bHor && !bBestHor)) {
+                        nBest     = k;
+                        fBestDist = fDist;
+                        bBestHor  = bHor;
+                    }
+                }
+            }
+            if (nBest < 0) {
+                bDone = true;
+            } else {
+                IntersectInfo sInfo = rFrom.vHitLists[ nBest ][ vNext[ nBest ]];
+                set_crossing( sInfo.nHitX, sInfo.nHitY, sInfo.nFaceHit );
+                if (r.fDistIfFound >= r.fMaxDist - ADAPTIVE_MAX_DIST_MARGIN)
+                    return false;
+                sInfo.fDistFrnt_raw = r.fDistIfFound;
+                // emit the hit points of this crossing, and do the checks that EmitLayerHits() does
+                for (int k = 0; k < nLayers; k++) {
+                    if (vNext[k] < (int)rFrom.vHitLists[k].size()) {
+                        IntersectInfo &rHit = rFrom.vHitLists[k][ vNext[k] ];
+                        if (rHit.nHitX == sInfo.nHitX && rHit.nHitY == sInfo.nHitY && rHit.nFaceHit == sInfo.nFaceHit) {
+                            sInfo.fHeight = rHit.fHeight;
+                            sInfo.nLayer  = rHit.nLayer;
+                            rec.vHitLists[k].push_back( sInfo );
+                            vNext[k] += 1;
+                        }
+                    }
+                }
+                r.bOutOfBounds     = !rCurMap.IsInBounds( r.nCurX, r.nCurY );
+                r.bDestCellReached = (r.nCurX == int( r.fToX ) && r.nCurY == int( r.fToY ));
+                if (!r.bOutOfBounds) {
+                    r.nHitPointsFound += 1;
+                    if (r.pOccRows != nullptr) {
+                        UpdateOcclusion( rCurMap, r, rec.vHitLists );
+                    }
+                }
+            }
+        }
+        // not stopped yet (e.g. the outer rays were occluded, but this one isn't) - continue with the DDA
+        TraverseRay( rCurMap, r, rec.vHitLists );
+        SetColumnCached( rec, nCurMap, fPx, fPy, rRay );
+        GetScratch().nRaysFilledIn += 1;
+        return true;
+    }
+
+    // Makes sure the ray cache holds the hit lists of every nStep-th column between columns nA and nB, which must be cached already (and
+    // nB - nA must be a multiple of nStep). If the rays of nA and nB hit the same cells and faces, these columns are filled in, otherwise
+    // the range is split in two
+    void RefineColumns( int nA, int nB, int nStep, int nCurMap, float fPx, float fPy, float fVPAngle_deg, const OcclusionRec *pOcc ) {
+        if (nB - nA < 2 * nStep)
+            return;
+
+        if (SameColumnHits( vRayCache[ nA ], vRayCache[ nB ] )) {
+            for (int x = nA + nStep; x < nB; x += nStep) {
+                CameraRayRec sRay;
+                GetColumnRay( x, fVPAngle_deg, sRay );
+                if (!IsColumnCached( x, nCurMap, fPx, fPy, sRay ) && !FillInColumn( x, vRayCache[ nA ], nCurMap, fPx, fPy, sRay, pOcc )) {
+                    CastColumnIntoCache( x, nCurMap, fPx, fPy, sRay, pOcc );
+                }
+            }
+        } else {
+            int nM = nA + ((nB - nA) / nStep / 2) * nStep;
+            CameraRayRec sRay;
+            GetColumnRay( nM, fVPAngle_deg, sRay );
+            if (!IsColumnCached( nM, nCurMap, fPx, fPy, sRay )) {
+                CastColumnIntoCache( nM, nCurMap, fPx, fPy, sRay, pOcc );
+            }
+            RefineColumns( nA, nM, nStep, nCurMap, fPx, fPy, fVPAngle_deg, pOcc );
+            RefineColumns( nM, nB, nStep, nCurMap, fPx, fPy, fVPAngle_deg, pOcc );
+        }
+    }
+
+    void PostFilterHitList( int nCurMap, std::vector<IntersectInfo> &vHitList ) {
+
+        // get a reference to the map
+        RC_Map &pCurMap = vMaps[ nCurMap ];
+
+        float fCacheHeight = 0.0f;
+
+        // this flag is used to filter out all empty cells at the start of the list
+        bool bStartPhase = true;
+
+        for (int i = 0; i < (int)vHitList.size(); i++) {
+            // get a ref to current hit list point...
+            IntersectInfo &curHP = vHitList[i];
+
+            // ... check if the hit is inbound the map ...
+            if (pCurMap.IsInBounds( curHP.nHitX, curHP.nHitY, curHP.nLayer )) {
+                // ... get a pointer to the map cell from it ...
+                RC_MapCell *curMapCellPtr = pCurMap.MapCellPtrAt( curHP.nHitX, curHP.nHitY, curHP.nLayer );
+                if (curMapCellPtr != nullptr) {
+
+                    if (curMapCellPtr->IsEmpty()) {
+                        if (bStartPhase) {
+                            curHP.bRemoveFlag = true;     // all empty cells at the head of the list can be removed
+                        }
+                    } else {
+                        // if map cell is not empty, get a pointer to the face from the map cell ptr
+                        RC_Face *curFacePtr = curMapCellPtr->GetFacePtr( curHP.nFaceHit );
+
+                        // for filtering besides height the following characteristics are relevant
+                        float fHeight       = curMapCellPtr->GetHeight();
+                        bool bIsPortal      = (curFacePtr == nullptr ? false : curFacePtr->IsPortal());
+                        bool bIsTransparent = (curFacePtr == nullptr ? false : curFacePtr->IsTransparent());
+                        // flag all redundant nodes, that are characteristically identical to their predecessor
+                        if ( (fCacheHeight == fHeight) && !bIsPortal && !bIsTransparent ) {
+                            curHP.bRemoveFlag = true;
+                        }
+                        bStartPhase = false;
+                    }
+                }
+            }
+        }
+        // little lambda to act as filter function
+        auto filter_out_hitpoint = [=]( IntersectInfo &a ) {
+            return a.bRemoveFlag;
+        };
+        // actual filtering with erase-remove idiom
+        vHitList.erase(
+            std::remove_if(
+                vHitList.begin(),
+                vHitList.end(),
+                filter_out_hitpoint
+            ),
+           vHitList.end()
+        );
+    }
+
+    // Returns the on screen projected values (i.e. the y screen coordinates) for top and bottom of a map cell.
+    // The map cell is at fCorrDistToWall from eye point, fViewPointHeight is the player's height, nHorHight is the
+    // height of the horizon, nLayerHeight is the layer for this block and fWallHeight is the height of the map cell (in (0.0f, 1.0f] )
+    // according to the map
+    // The calculated results (on screen projections = OSP's) are passed in the two reference parameters.
+    void CalculateBlockProjections( float fCorrDistToWall, float fViewPointHeight, int nHorHeight, int nLayerHeight, float fWallHeight, int &nOspTop, int &nOspBottom ) {
+        CalculateBlockProjections( CalculateSliceHeight( fCorrDistToWall ), fViewPointHeight, nHorHeight, nLayerHeight, fWallHeight, nOspTop, nOspBottom );
+    }
+
+    // calculate projected slice height for a *unit height* wall (in screen space)
+    int CalculateSliceHeight( float fCorrDistToWall ) {
+        return int((1.0f / fCorrDistToWall) * fDistToProjPlane);
+    }
+
+    // Variant of the above that takes the projected unit height slice height instead of the distance. Since the slice height only depends
+    // on the distance, it can be reused for the projections of the front of a block and the back of the block before it.
+    void CalculateBlockProjections( int nSliceHeight, float fViewPointHeight, int nHorHeight, int nLayerHeight, float fWallHeight, int &nOspTop, int &nOspBottom ) {
+        nOspTop    = round( nHorHeight - (nSliceHeight * (1.0f - fViewPointHeight)) - (nLayerHeight + fWallHeight - 1.0f) * nSliceHeight );
+        nOspBottom = round( nOspTop + nSliceHeight * fWallHeight );
+    }
+
+    // Works out the range of layers nLayerLo .. nLayerHi of map rMap that can have pixels within screen rows nStrtY .. nStopY. fMinDist
+    // is the smallest (corrected) distance a hit point can have. Layer k is between heights k and k + 1, so at distances >= fMinDist it
+    // projects between the top at fMinDist (or the horizon) and the bottom at fMinDist (or the horizon). Since the layers are stacked,
+    // the layers that overlap the sub slice are a contiguous range. If that range is empty, nLayerLo > nLayerHi.
+    void GetVisibleLayers( RC_Map &rMap, float fPh, int nHorHght, int nStrtY, int nStopY, float fMinDist, int &nLayerLo, int &nLayerHi ) {
+        nLayerLo = 0;
+        nLayerHi = rMap.NrOfLayers() - 1;
+        if (!DDA_LAYER_CULLING)
+            return;
+        // use the float slice height (that's >= the rounded down one), and 1 row of margin for the rounding of the projections
+        float fSliceHeight = (fMinDist > 0.0f) ? fDistToProjPlane / fMinDist : FLT_MAX;
+        auto layer_top = [&]( int k ) { float fAbove = float( k + 1 ) - fPh; return (fAbove > 0.0f) ? float( nHorHght ) - fAbove * fSliceHeight - 1.0f : float( nHorHght ) - 1.0f; };
+        auto layer_bot = [&]( int k ) { float fBelow = fPh - float( k );     return (fBelow > 0.0f) ? float( nHorHght ) + fBelow * fSliceHeight + 1.0f : float( nHorHght ) + 1.0f; };
+        // the higher the layer, the higher it is on screen
+        while (nLayerLo <= nLayerHi && layer_top( nLayerLo ) > float( nStopY )) nLayerLo += 1;
+        while (nLayerLo <= nLayerHi && layer_bot( nLayerHi ) < float( nStrtY )) nLayerHi -= 1;
+    }
+
+// ==============================/   Mini map rendering prototypes   /==============================
+
+    // function to render the mini map on the screen. If nRenderLevel == -1, all layers are taken into account.
+    // Otherwise only the specified level is renderd in the minimap
+    void RenderMap( int nRenderLevel = -1 );
+    void RenderMapPlayer();      // function to render the player in the mini map on the screen
+    void RenderMapRays( int nPlayerLevel );        // function to render the rays in the mini map on the screen
+    void RenderMapObjects();     // function to render all the objects in the mini map on the screen
+    void RenderPlayerInfo();      // function to render player info in a separate hud on the screen
+    void RenderProcessInfo();     // function to render process info in a separate hud on the screen
+
+    olc::Pixel ShadePixel( const olc::Pixel &p, float fDistance );	// Shade the pixel p using fDistance as a factor in the shade formula
+    olc::Pixel FogPixel( const olc::Pixel &p, float fFogFactor, const olc::Pixel &fogCol );	// Blend the pixel p into fogCol by fFogFactor
+
+    // With bHalfRateFlats, the horizontal surfaces are sampled on a checkerboard pattern, and the other pixels are filled in afterwards.
+    // Returns the index of the first pixel that is skipped in a span of nLen pixels that starts at screen position (x, y) - every
+    // other pixel from there is skipped too. nLen is returned if all of them must be sampled.
+    int FirstSkippedPixel( int x, int y, int nLen ) {
+        return (!bHalfRateFlats || nLen < 2) ? nLen : 1 - ((x + y) & 1);
+    }
+    bool IsSkippedPixel( int i, int nFirstSkip ) {
+        return i >= nFirstSkip && ((i - nFirstSkip) & 1) == 0;
+    }
+    // Fills in the skipped pixels of a span by averaging their neighbours. A span covers a single surface, and it ends where the
+    // depth jumps (at the edge of a wall, or where something is in front of it), so this never blends across an edge. Pixels with
+    // a different alpha (the holes in a transparent face) aren't blended either, but copied.
+    // The shade distances in pShadeDists (if passed) are filled in the same way. Where one of the neighbours is shaded already (at the
+    // start of the fog) and the other one is left to the deferred shading, the pixel and its shade distance are copied from one neighbour,
+    // since an unshaded and a shaded colour can't be averaged.
+    void FillInSpan( olc::Pixel *pPixels, int nLen, int nFirstSkip, float *pShadeDists = nullptr ) {
+        for (int i = nFirstSkip; i < nLen; i += 2) {
+            int nFrom = -1;
+            if (i == 0) {
+                nFrom = i + 1;
+            } else if (i + 1 == nLen || pPixels[i - 1].a != pPixels[i + 1].a ||
+                       (pShadeDists != nullptr && (pShadeDists[i - 1] > 0.0f) != (pShadeDists[i + 1] > 0.0f))) {
+                nFrom = i - 1;
+            } else {
+                const olc::Pixel &a = pPixels[i - 1], &b = pPixels[i + 1];
+                pPixels[i] = olc::Pixel( (a.r + b.r) / 2, (a.g + b.g) / 2, (a.b + b.b) / 2, a.a );
+                if (pShadeDists != nullptr) {
+                    pShadeDists[i] = 0.5f * (pShadeDists[i - 1] + pShadeDists[i + 1]);
+                }
+            }
+            if (nFrom >= 0) {
+                pPixels[i] = pPixels[nFrom];
+                if (pShadeDists != nullptr) {
+                    pShadeDists[i] = pShadeDists[nFrom];
+                }
+            }
+        }
+    }
+
+    // Draws the span y0 - y1 of screen column x, or if it's part of a transparent face, stores its pixels in vFragments for the
+    // delayed rendering. Fully transparent pixels and pixels that are behind the depth buffer already are not stored.
+    // pShadeDists are the shade distances of the pixels for the deferred shading (see ShadeFrame())
+    void RenderOrDelaySpan( bool bTransparent, int x, int y0, int y1, float *pDepths, olc::Pixel *pPixels, float *pShadeDists, std::vector<FragmentRec> &vFragments ) {
+        if (bTransparent) {
+            for (int y = y0; y <= y1; y++) {
+                const olc::Pixel &p = pPixels[ y - y0 ];
+                if (p.a != 0 && !cDDrawer.IsMasked( x, y, pDepths[ y - y0 ] )) {
+                    vFragments.push_back( { pDepths[ y - y0 ], y, p, pShadeDists[ y - y0 ] } );
+                }
+            }
+        } else {
+            cDDrawer.DrawColumnSpan( x, y0, y1, pDepths, pPixels, pShadeDists );
+        }
+    }
+
+    // Draws the transparent fragments of screen column x, and clears vFragments. Per screen row only the nearest fragment
+    // is visible, so the fragments are sorted on row and depth, and only the first one of each row is drawn.
+    // NOTE: the sort is stable, so if fragments are equally near, the one that was stored first wins
+    void ResolveFragments( int x, std::vector<FragmentRec> &vFragments ) {
+        std::stable_sort(
+            vFragments.begin(), vFragments.end(),
+            []( const FragmentRec &a, const FragmentRec &b ) {
+                return a.nY < b.nY || (a.nY == b.nY && a.fDepth < b.fDepth);
+            }
+        );
+        for (int i = 0; i < (int)vFragments.size(); i++) {
+            if (i == 0 || vFragments[i].nY != vFragments[i - 1].nY) {
+                cDDrawer.Draw( vFragments[i].fDepth, x, vFragments[i].nY, vFragments[i].p, vFragments[i].fShadeDist );
+            }
+        }
+        vFragments.clear();
+    }
+
+    /* Queue based sub slice renderer
+     * Takes the front element of dSliceQ and renders it, using the info from that element
+     * If any new subslices emerge, they are pushed at the back of the queue (or at the back of pSpawnQ if that is passed)
+     * This approach enables careful analysis of the rendering over multiple maps
+     * the vector of floats is the precalced cos value for each screen pixel y coordinate
+     */
+    void RenderSubSlice(
+        SliceQueue &dSliceQ,
+        std::vector<float> &vDownAngleCos,
+        SliceQueue *pSpawnQ = nullptr
+    ) {
+        // these variables are all populated from the slice queue record
+        float fViewAngle_deg, fCurAngle_deg, fVPAngle_deg;
+        int   nCurMap;
+        float fPx, fPy, fPh;
+        float fStrtDist;
+        int   nSlice;
+        int   nStrtY, nStopY;
+        int   nHorHght;
+
+        // Temporarily replaced the while by an if statement, to give control to the calling code.
+        // As a result, this function only does one sub slice at a time
+        if (!dSliceQ.empty()) {
+
+            // get slice describing info from the queue
+            SubSliceRec tmp = dSliceQ.pop();
+
+            fViewAngle_deg = tmp.fViewAngle_deg;
+            fCurAngle_deg  = tmp.fCurAngle_deg;
+            fVPAngle_deg   = tmp.fVPAngle_deg;
+
+            nCurMap   = tmp.nCurMap;
+            fPx       = tmp.fPx;
+            fPy       = tmp.fPy;
+            fPh       = tmp.fPh;
+            fStrtDist = tmp.fStrtDist;
+            nSlice    = tmp.nSlice;
+            nStrtY    = tmp.nStrtY;
+            nStopY    = tmp.nStopY;
+            nHorHght  = tmp.nHorHght;
+
+            // get a reference to the current map
+            RC_Map *pCurMap = &vMaps[ nCurMap ];
+
+            // get the direction info of the ray for this sub slice
+            CameraRayRec sRay;
+            GetCameraRay( nSlice, fViewAngle_deg, fCurAngle_deg, sRay );
+            float fDirX    = sRay.fDirX;
+            float fDirY    = sRay.fDirY;
+            float fViewCos = sRay.fViewCos;
+
+            // fog parameters of the current map
+            bool       bFog     = pCurMap->HasFog();
+            float      fFogStop = pCurMap->GetDrawDistance();
+            float      fFogStrt = fFogStop * FOG_START_FACTOR;
+            olc::Pixel fogCol   = pCurMap->GetFogColour();
+
+            int   nOspTopFrnt, nOspBotFrnt;   // to store the top and bottom y coord of the cell projection per column (screen space)
+
+            // create a local slice container to store any emerging sub slices (could be > 1)
+            // the reason to store these locally at first is because they have to be checked against the depth buffer after
+            // all "regular" (i.e. non-delayed and non-portal) parts of the slice have been rendered
+            std::vector<SubSliceRec> localSliceQueue;
+
+            /////////////////////   SAMPLE LAMBDA's    /////////////////////////////
+
+            // this lambda blends pixel p into the fog colour, depending on (corrected) distance fDistance
+            auto apply_fog = [=]( const olc::Pixel &p, float fDistance ) -> olc::Pixel {
+                // blank pixels must stay blank (these are masked in the delayed rendering)
+                if (!bFog || fDistance <= fFogStrt || p.a == 0) return p;
+                return FogPixel( p, std::min( 1.0f, (fDistance - fFogStrt) / (fFogStop - fFogStrt)), fogCol );
+            };
+
+            // this lambda shades pixel p using fShadeDist, and blends it into the fog using fFogDist. With deferred shading the pixel
+            // is returned as it is, and fShadeDist is put in fDeferDist for ShadeFrame(). Since the fog is blended in after the shading,
+            // pixels in the fog are shaded here anyway (fDeferDist is 0.0f for these)
+            bool bDefer = bDeferFrame;
+            auto shade_pixel = [=]( const olc::Pixel &p, float fShadeDist, float fFogDist, float &fDeferDist ) -> olc::Pixel {
+                if (bDefer && (!bFog || fFogDist <= fFogStrt)) {
+                    fDeferDist = fShadeDist;
+                    return p;
+                }
+                fDeferDist = 0.0f;
+                return apply_fog( ShadePixel( p, fShadeDist ), fFogDist );
+            };
+
+            // These lambdas calculate the sample coordinates for horizontal surfaces. They can be used for floors, roofs and ceilings.
+            // fProjDistance is the distance from the player to the hit point on the surface.
+            auto get_texel_u = [=]( float fProjDistance ) {
+                // calculate the world coordinates from the distance and the view angle + player angle
+                float fProjX = fPx + fProjDistance * fDirX;
+                // calculate the sample coordinates for that world coordinate. Wrap around if the result < 0 or >= 1
+                float fSampleX = fProjX - int(fProjX);
+                if (fSampleX <  0.0f) fSampleX += 1.0f;
+                if (fSampleX >= 1.0f) fSampleX -= 1.0f;
+                return fSampleX;
+            };
+
+            auto get_texel_v = [=]( float fProjDistance ) {
+                // calculate the world coordinates from the distance and the view angle + player angle
+                float fProjY = fPy + fProjDistance * fDirY;
+                // calculate the sample coordinates for that world coordinate. Wrap around if the result < 0 or >= 1
+                float fSampleY = fProjY - int(fProjY);
+                if (fSampleY <  0.0f) fSampleY += 1.0f;
+                if (fSampleY >= 1.0f) fSampleY -= 1.0f;
+                return fSampleY;
+            };
+
+            // this lambda returns a sample of the floor through the pixel at screen coord (px, py)
+            auto get_floor_sample = [=]( int px, int py, float fDistOffset, float &fDeferDist ) -> olc::Pixel {
+                // work out the distance to the location on the floor you are looking at through this pixel
+                float fFloorProjDistance;
+                fFloorProjDistance = ((fPh / float( py - nHorHght )) * fDistToProjPlane );
+                // beyond the draw distance there's only fog - sampling is not needed
+                float fFogDistance = fFloorProjDistance;
+                if (bFog && fFogDistance >= fFogStop) {
+                    fDeferDist = 0.0f;
+                    return fogCol;
+                }
+                // it turns out that for ray casting into another level, the distance must be corrected so that it
+                // reflects the distance from the portal into the other world
+                fFloorProjDistance -= fDistOffset;
+                fFloorProjDistance /= fViewCos;
+
+                // calculate the texels from this distance
+                float fSampleX = get_texel_u( fFloorProjDistance );
+                float fSampleY = get_texel_v( fFloorProjDistance );
+                // sample the pixel, shade it with the distance and return it
+                // NOTE: for the depth drawing the uncorrected distance is needed
+                return shade_pixel( pCurMap->GetFloorSpritePtr()->Sample( fSampleX, fSampleY ), fFloorProjDistance, fFogDistance, fDeferDist );
+            };
+
+            // This lambda performs much of the sampling proces of horizontal surfaces. It can be used for floors, roofs and ceilings etc.
+            // fProjDistance is the distance from the player to the hit point on the surface.
+            auto generic_sampling_cell = [=]( float fProjDistance, int nLevel, int nFaceID ) -> olc::Pixel {
+                // calculate the world coordinates from the distance and the view angle + player angle
+                float fProjX = fPx + fProjDistance * fDirX;
+                float fProjY = fPy + fProjDistance * fDirY;
+                // calculate the sample coordinates for that world coordinate, by subtracting the
+                // integer part and only keeping the fractional part. Wrap around if the result < 0 or > 1
+                float fSampleX = fProjX - int(fProjX); if (fSampleX < 0.0f) fSampleX += 1.0f; if (fSampleX >= 1.0f) fSampleX -= 1.0f;
+                float fSampleY = fProjY - int(fProjY); if (fSampleY < 0.0f) fSampleY += 1.0f; if (fSampleY >= 1.0f) fSampleY -= 1.0f;
+
+                // select the sprite to render the ceiling depending on the block that was hit
+                int nTileX = std::clamp( int( fProjX ), 0, pCurMap->GetWidth()  - 1);
+                int nTileY = std::clamp( int( fProjY ), 0, pCurMap->GetHeight() - 1);
+                // obtain a pointer to the block that was hit
+                RC_MapCell *auxMapCellPtr = pCurMap->MapCellPtrAt( nTileX, nTileY, nLevel );
+                // sample that block passing the face that was hit and the sample coordinates - the shading is done by the caller
+                return (auxMapCellPtr == nullptr) ? olc::MAGENTA : auxMapCellPtr->Sample( nFaceID, fSampleX, fSampleY );
+            };
+
+            // this lambda returns a sample of the roof through the pixel at screen coord (px, py)
+            // NOTE: fRoofHeightWithinLevel denotes the height of the hit point on the roof. This is typically the height of the block within the layer
+            // these lambdas return the distance to the location on the roof resp. ceiling you are looking at through the pixel at screen row py
+            auto get_roof_distance = [=]( int py, int nLevel, float fRoofHeightWithinLevel ) {
+                return (( (fPh - (float( nLevel ) + fRoofHeightWithinLevel)) / float( py - nHorHght )) * fDistToProjPlane);
+            };
+            auto get_ceil_distance = [=]( int py, int nLevel, float fCeilHeightWithinLevel ) {
+                return (( ((float( nLevel ) + fCeilHeightWithinLevel) - fPh) / float( nHorHght - py )) * fDistToProjPlane);
+            };
+
+            auto get_roof_sample = [=]( int px, int py, int nLevel, float fDistOffset, float fRoofHeightWithinLevel, float &fRoofProjDistance, float &fDeferDist ) -> olc::Pixel {
+                // work out the distance to the location on the roof you are looking at through this pixel
+                fRoofProjDistance = get_roof_distance( py, nLevel, fRoofHeightWithinLevel );
+                // for sampling into another map, we need to correct the distance with the distance to the portal face
+                float fRoofProjDistance_raw = (fRoofProjDistance - fDistOffset) / fViewCos;
+                // call the generic sampler to work out the rest
+                return shade_pixel( generic_sampling_cell( fRoofProjDistance_raw, nLevel, FACE_TOP ), fRoofProjDistance_raw, fRoofProjDistance, fDeferDist );
+            };
+
+            // this lambda returns a sample of the ceiling through the pixel at screen coord (px, py)
+            // NOTE: fHeightWithinLevel denotes the height of the hit point on the ceiling. This is typically 0.0f, since the ceilings are not (yet) fractionally positionable
+            auto get_ceil_sample = [=]( int px, int py, int nLevel, float fDistOffset, float fCeilHeightWithinLevel, float &fCeilProjDistance, float &fDeferDist ) -> olc::Pixel {
+                // work out the distance to the location on the ceiling you are looking at through this pixel
+                    fCeilProjDistance = get_ceil_distance( py, nLevel, fCeilHeightWithinLevel );
+                // for sampling into another map, we need to correct the distance with the distance to the portal face
+                    float fCeilProjDistance_raw = (fCeilProjDistance - fDistOffset) / fViewCos;
+                // call the generic sampler to work out the rest
+                return shade_pixel( generic_sampling_cell( fCeilProjDistance_raw, nLevel, FACE_BOTTOM ), fCeilProjDistance_raw, fCeilProjDistance, fDeferDist );
+            };
+
+            /////////////////////   OBTAIN HITPOINT INFO    /////////////////////////////
+
+            // prepare the rendering for this slice by calculating the list of intersections along this ray
+            // for each layer, get the list of hit points in that layer, filter it, and add the hit points that must be rendered
+            // to the render list, with their distances and on screen projections
+            // Layers that project completely outside this sub slice are skipped. The nearest possible hit point is at the first grid
+            // crossing of the ray
+            float fFirstCrossX = ((sRay.fDX > 0.0f) ? float( int( fPx ) + 1 ) - fPx : fPx - float( int( fPx ))) * sRay.fSX;
+            float fFirstCrossY = ((sRay.fDY > 0.0f) ? float( int( fPy ) + 1 ) - fPy : fPy - float( int( fPy ))) * sRay.fSY;
+            int nLayerLo, nLayerHi;
+            GetVisibleLayers( *pCurMap, fPh, nHorHght, nStrtY, nStopY, fStrtDist + std::min( fFirstCrossX, fFirstCrossY ) * fViewCos, nLayerLo, nLayerHi );
+
+            ThreadScratchRec &rScratch = GetScratch();
+            std::vector<std::vector<IntersectInfo>> &vLayerHitLists = rScratch.vLayerHitLists;
+            RenderHitList &rRenderList = rScratch.sRenderHitList;
+            rRenderList.clear();
+            std::vector<std::vector<IntersectInfo>> *pLayerHitLists = &vLayerHitLists;
+            bool bCachedLists = false;
+            // in single pass mode, the grid is traversed only once for all layers. The rays can be stopped as soon as the rest
+            // of the ray is occluded in this sub slice
+            OcclusionRec sOcc = { fPh, nHorHght, nStrtY, nStopY, fStrtDist };
+            OcclusionRec *pOcc = (DDA_OCCLUSION && DDA_FUSED_FILTER) ? &sOcc : nullptr;
+            if (DDA_SINGLE_PASS && nLayerLo <= nLayerHi) {
+                // first level sub slices (not seen through a portal) are cached. These are cast for all layers, since the cached
+                // rays are shared between sub slices
+                if (fStrtDist == 0.0f) {
+                    pLayerHitLists = &GetCachedHitLists( nSlice, nCurMap, fPx, fPy, sRay, fVPAngle_deg, pOcc );
+                    bCachedLists = true;
+                } else {
+                    CastRayAllLevelsAndAngle( nCurMap, fPx, fPy, sRay, GetRayLength( nCurMap, fStrtDist ), vLayerHitLists, pOcc, nLayerLo, nLayerHi );
+                }
+            }
+            for (int k = nLayerLo; k <= nLayerHi; k++) {
+
+                if (!DDA_SINGLE_PASS) {
+                    // the render list points into the hit lists, so these must stay alive while this sub slice is rendered
+                    if ((int)vLayerHitLists.size() <= k) {
+                        vLayerHitLists.resize( k + 1 );
+                    }
+                    vLayerHitLists[k].clear();
+                    CastRayPerLevelAndAngle( nCurMap, fPx, fPy, k, sRay, GetRayLength( nCurMap, fStrtDist ), vLayerHitLists[k] );
+                }
+                std::vector<IntersectInfo> &vCurLevelList = (DDA_SINGLE_PASS ? (*pLayerHitLists)[k] : vLayerHitLists[k]);
+                // the fused DDA variant already filtered the hit list, and so did the ray cache
+                if (!bCachedLists && (!DDA_SINGLE_PASS || !DDA_FUSED_FILTER)) {
+                    PostFilterHitList( nCurMap, vCurLevelList );
+                }
+
+                // lambda to get the distance of a hit point, corrected for the fish eye effect. The start distance is added, since we're
+                // working with staged rendering through portals
+                auto get_dist_corr = [=]( const IntersectInfo &rHit ) {
+                    float fDistCorr = rHit.fDistFrnt_raw * fViewCos;
+                    fDistCorr += fStrtDist;
+                    return fDistCorr;
+                };
+                // Only the hit points of blocks with a height > 0 are rendered, the others are only needed as the back of the block
+                // before them. The back of a block is at the front distance of the next hit point, and the back of the last one is at its front
+                int nCurLevelSize = (int)vCurLevelList.size();
+                float fDistCorr    = (nCurLevelSize > 0) ? get_dist_corr( vCurLevelList[0] ) : 0.0f;
+                int   nSliceHeight = (nCurLevelSize > 0) ? CalculateSliceHeight( fDistCorr ) : 0;
+                for (int i = 0; i < nCurLevelSize; i++) {
+                    IntersectInfo &rHit = vCurLevelList[i];
+                    float fNextDistCorr    = fDistCorr;
+                    int   nNextSliceHeight = nSliceHeight;
+                    if (i + 1 < nCurLevelSize) {
+                        fNextDistCorr    = get_dist_corr( vCurLevelList[i + 1] );
+                        nNextSliceHeight = CalculateSliceHeight( fNextDistCorr );
+                    }
+                    if (rHit.fHeight > 0.0f) {
+                        int nTopFrnt, nBotFrnt, nTopBack, nBotBack;
+                        CalculateBlockProjections( nSliceHeight    , fPh, nHorHght, rHit.nLayer, rHit.fHeight, nTopFrnt, nBotFrnt );
+                        CalculateBlockProjections( nNextSliceHeight, fPh, nHorHght, rHit.nLayer, rHit.fHeight, nTopBack, nBotBack );
+                        rRenderList.push_back( &rHit, fDistCorr, (i + 1 < nCurLevelSize) ? fNextDistCorr : FLT_MAX, nTopFrnt, nBotFrnt, nTopBack, nBotBack );
+                    }
+                    fDistCorr    = fNextDistCorr;
+                    nSliceHeight = nNextSliceHeight;
+                }
+                rScratch.nHitsProcessed += nCurLevelSize;
+
+                // populate ray list for rendering mini map
+                if (bMinimap && !vCurLevelList.empty()) {
+                    float fHitX, fHitY;
+                    GetHitPoint( fPx, fPy, sRay, vCurLevelList[0], fHitX, fHitY );
+                    RayType curHitPoint = { { fPx, fPy }, { fHitX, fHitY }, vCurLevelList[0].nLayer };
+                    rScratch.vRayList.push_back( curHitPoint );
+                }
+            }
+
+            rScratch.nHitsRendered += rRenderList.size();
+
+            // if test mode is triggered, print the hit list along the test slice
+            // NOTE: bTestMode is only accessed by the thread that renders the test slice
+            if (nSlice == int( fTestSlice * float( RenderWidth()) / float( ScreenWidth())) && bTestMode) {
+                int nMap = -1;
+            for (int i = 0; i < (int)vMaps.size() && nMap == -1; i++) {
+                    if (pCurMap == &vMaps[i]) {
+                        nMap = i;
+                    }
+                }
+                std::cout << "Map: " << nMap << std::endl;
+                PrintRenderHitList( fPx, fPy, sRay, rRenderList, true );
+                bTestMode = false;
+            }
+
+            /////////////////////   RENDER BACKGROUND    /////////////////////////////
+
+            // the parts of this sub slice are sampled into these arrays, and then drawn as a span
+            ThreadScratchRec &rSpanScratch = GetScratch();
+            if ((int)rSpanScratch.vSpanPixels.size() < RenderHeight()) {
+                rSpanScratch.vSpanPixels.resize( std::max( RenderWidth(), RenderHeight()));
+                rSpanScratch.vSpanDepths.resize( std::max( RenderWidth(), RenderHeight()));
+                rSpanScratch.vSpanShades.resize( std::max( RenderWidth(), RenderHeight()));
+                rSpanScratch.vFragments.reserve( 4 * RenderHeight());
+            }
+            std::vector<FragmentRec> &vFragments = rSpanScratch.vFragments;
+            olc::Pixel *pSpanPixels = rSpanScratch.vSpanPixels.data();
+            float      *pSpanDepths = rSpanScratch.vSpanDepths.data();
+            float      *pSpanShades = rSpanScratch.vSpanShades.data();
+
+            // start rendering this sub slice by putting sky and floor in it
+            float fWellAway = fMaxDistance + 1000.0f;
+            cDDrawer.FillColumnSpan( nSlice, nStrtY, std::min( nHorHght - 1, nStopY ), fWellAway, pCurMap->GetSkyColour());
+            // the floor of the first level sub slices is rendered afterwards, row by row (see RenderFloorRows())
+            if (!bFloorRowPass || fStrtDist != 0.0f) {
+                int nFloorStrtY = std::max( nHorHght, nStrtY );
+                int nFirstSkip  = FirstSkippedPixel( nSlice, nFloorStrtY, nStopY - nFloorStrtY + 1 );
+                for (int y = nFloorStrtY; y <= nStopY; y++) {
+                    if (!IsSkippedPixel( y - nFloorStrtY, nFirstSkip )) {
+                        pSpanPixels[ y - nFloorStrtY ] = get_floor_sample( nSlice, y, fStrtDist, pSpanShades[ y - nFloorStrtY ] );   // distance needs to be corrected
+                    }
+                }
+                FillInSpan( pSpanPixels, nStopY - nFloorStrtY + 1, nFirstSkip, pSpanShades );
+                cDDrawer.DrawColumnSpan( nSlice, nFloorStrtY, nStopY, fWellAway, pSpanPixels, pSpanShades );
+            }
+
+            // now render all hit points (i.e. wall sub slices) back to front
+            for (int nHit = 0; nHit < rRenderList.size(); nHit++) {
+                const IntersectInfo &hitRec = *rRenderList.vHit[nHit];
+                float fHitDist = rRenderList.vDistFrnt_corr[nHit];
+                float fBackDist = rRenderList.vDistBack_corr[nHit];
+                // The roof and ceiling spans follow from the rounded projections of the front and the back of the block, but their depths
+                // from the exact distance per row. So in the row at the back the exact distance can be beyond the back of the block. That
+                // row is the first (resp. last) row of the wall of the block behind it, which would then show through. This lambda keeps the
+                // depth of such a row just before the back of the block, so that the span covers all of its rows.
+                auto get_flat_depth = [=]( float fRenderDistance, int y ) {
+                    float fDepth = fRenderDistance / vDownAngleCos[y];
+                    return (fBackDist == FLT_MAX) ? fDepth : std::min( fDepth, std::nextafter( fBackDist / vDownAngleCos[y], 0.0f ));
+                };
+                int   nTopFrnt = rRenderList.vTopFrnt[nHit], nBotFrnt = rRenderList.vBotFrnt[nHit];
+                int   nTopBack = rRenderList.vTopBack[nHit], nBotBack = rRenderList.vBotBack[nHit];
+                // the world space hit point is only needed for the portals and the texture sampling of the wall faces
+                float fHitX, fHitY;
+                GetHitPoint( fPx, fPy, sRay, hitRec, fHitX, fHitY );
+
+
+                // make sure the screen y coordinate is within sub slice boundaries
+                nOspTopFrnt = std::clamp( nTopFrnt, nStrtY, nStopY );
+                nOspBotFrnt = std::clamp( nBotFrnt, nStrtY, nStopY );
+
+                // get a pointer to the map cell that was hit
+                RC_MapCell *auxMapCellPtr = pCurMap->MapCellPtrAt( hitRec.nHitX, hitRec.nHitY, hitRec.nLayer );
+                // get a pointer to the top face for roof rendering
+                RC_Face *auxFacePtr = auxMapCellPtr->GetFacePtr( FACE_TOP );
+                // render roof segment if it's visible (if top back >= top front, roof is not visible and nothing will be rendered)
+                // NOTE: the unclamped projections are used for the loop bounds, otherwise a segment that is completely outside the sub slice
+                //       would still render one row on its boundary
+                int nSpanStrtY = std::max( nTopBack, nStrtY );
+                int nSpanStopY = std::min( nTopFrnt, nStopY );
+                // the roof can only be visible from above - otherwise one row would still be rendered where top back == top front
+                if (fPh <= float( hitRec.nLayer ) + hitRec.fHeight) {
+                    nSpanStopY = nSpanStrtY - 1;
+                }
+                int nFirstSkip = FirstSkippedPixel( nSlice, nSpanStrtY, nSpanStopY - nSpanStrtY + 1 );
+                for (int y = nSpanStrtY; y <= nSpanStopY; y++) {
+                    // the distance to this point is calculated and passed from get_roof_sample
+                    float fRenderDistance;
+                    if (IsSkippedPixel( y - nSpanStrtY, nFirstSkip )) {
+                        fRenderDistance = get_roof_distance( y, hitRec.nLayer, hitRec.fHeight );
+                    } else {
+                        pSpanPixels[ y - nSpanStrtY ] = get_roof_sample( nSlice, y, hitRec.nLayer, fStrtDist, hitRec.fHeight, fRenderDistance, pSpanShades[ y - nSpanStrtY ] );   // shading is done in get_roof_sample()
+                    }
+                    pSpanDepths[ y - nSpanStrtY ] = get_flat_depth( fRenderDistance, y );
+                }
+                FillInSpan( pSpanPixels, nSpanStopY - nSpanStrtY + 1, nFirstSkip, pSpanShades );
+                // either render or store for later rendering, depending on face transparency
+                RenderOrDelaySpan( auxFacePtr->IsTransparent(), nSlice, nSpanStrtY, nSpanStopY, pSpanDepths, pSpanPixels, pSpanShades, vFragments );
+
+                // render wall segment - this could be a portal
+                // if it is a portal cell, first work out and store the info to push up the sub slice queue for later rendering
+
+                // get a pointer to the face that was hit
+                auxFacePtr = auxMapCellPtr->GetFacePtr( hitRec.nFaceHit );
+                if (auxFacePtr->IsPortal()) {
+
+                    // prevent infinite refinement - only create new sub slice if it is significant
+                    if (nStopY > nStrtY) {
+
+                        // make sure you have a pointer to a FacePortal object
+                        RC_FacePortal *auxPortalFacePtr = (RC_FacePortal *)auxFacePtr;
+
+                        float fExitAngle_deg = auxPortalFacePtr->GetExitAngleDeg();     // angle of exit direction vector
+                        float fToAngle_deg   = auxPortalFacePtr->GetToAngle();          // orientation of other map
+                        float fDiffAngle_deg = fToAngle_deg - fExitAngle_deg;           // difference between those
+                        // we already got fVPAngle_deg from the slice render info
+                        float fOtherVPA_deg = mod360( fVPAngle_deg + fDiffAngle_deg );
+
+                        float fOtherViewA_deg = fViewAngle_deg;
+                        float fOtherCurA_deg = mod360( fOtherVPA_deg + fOtherViewA_deg );
+
+                        int nOtherMap = auxPortalFacePtr->GetToMap();
+                        int nOtherL   = auxPortalFacePtr->GetToLevel();
+                        int nOtherX   = auxPortalFacePtr->GetToX();
+                        int nOtherY   = auxPortalFacePtr->GetToY();
+
+                        int nDeltaX = nOtherX - int( fHitX );
+                        int nDeltaY = nOtherY - int( fHitY );
+                        int nDeltaZ = nOtherL - auxPortalFacePtr->GetFromLevel();
+
+                        float fOtherX, fOtherY, fOtherZ;
+                        switch ( auxPortalFacePtr->GetExitDir() ) {
+                            // in cases where you need to add 1.0f, add slightly less, to prevent out of bounds conditions
+                            case FACE_EAST : fOtherX = nOtherX;                fOtherY = fHitY + nDeltaY; fOtherZ = fPh + nDeltaZ;break;
+                            case FACE_WEST : fOtherX = nOtherX + 0.99999f;     fOtherY = fHitY + nDeltaY; fOtherZ = fPh + nDeltaZ;break;
+                            case FACE_SOUTH: fOtherX = fHitX + nDeltaX; fOtherY = nOtherY;                fOtherZ = fPh + nDeltaZ;break;
+                            case FACE_NORTH: fOtherX = fHitX + nDeltaX; fOtherY = nOtherY + 0.99999f;     fOtherZ = fPh + nDeltaZ;break;
+                            default: std::cout << "ERROR: RenderSubSlice() --> this exit direction does not implement" << std::endl;
+                        }
+
+                        // add a sub slice to the queue if there is a sub slice left
+                        // NOTE: the upper and lower boundaries will be clipped against the depth buffer afterwards
+                        if (nOspTopFrnt +1 < nOspBotFrnt - 1) {
+                            SubSliceRec aux = {
+                                fOtherViewA_deg, fOtherCurA_deg, fOtherVPA_deg,
+                                nOtherMap,
+                                fOtherX, fOtherY, fOtherZ,
+                                fHitDist,
+                                nSlice, nOspTopFrnt + 1, nOspBotFrnt - 1,
+                                nHorHght,
+                                true
+                            };
+                            localSliceQueue.push_back( aux );
+                        }
+                    }
+                }
+
+                // now also render the wall part, this enables for transparent portals
+                float fSampleX = -1.0f;
+                nSpanStrtY = std::max( nTopFrnt + 1, nStrtY );
+                nSpanStopY = std::min( nBotFrnt - 1, nStopY );
+                for (int y = nSpanStrtY; y <= nSpanStopY; y++) {
+
+                    // first get x sample coordinate from face hit info
+                    if (fSampleX == -1.0f) {
+                        switch (hitRec.nFaceHit) {
+                            case FACE_SOUTH:
+                            case FACE_NORTH: fSampleX = fHitX - (float)hitRec.nHitX; break;
+                            case FACE_EAST :
+                            case FACE_WEST : fSampleX = fHitY - (float)hitRec.nHitY; break;
+                            default        : std::cout << "ERROR: RenderSubSlice() --> invalid face value: " << hitRec.nFaceHit << std::endl;
+                        }
+                    }
+
+                    // the y sample coordinate depends only on the pixel y coord on the screen in relation to the vertical space the wall is taking up
+                    float fSampleY = hitRec.fHeight * float(y - nTopFrnt) / float(nBotFrnt - nTopFrnt);
+                    // sample that block passing the face that was hit and the sample coordinates
+                    olc::Pixel sampledPixel = (auxMapCellPtr == nullptr) ? olc::MAGENTA : auxMapCellPtr->Sample( hitRec.nFaceHit, fSampleX, fSampleY );
+                    // shade the pixel
+                    pSpanPixels[ y - nSpanStrtY ] = shade_pixel( sampledPixel, fHitDist, fHitDist, pSpanShades[ y - nSpanStrtY ] );
+                    pSpanDepths[ y - nSpanStrtY ] = fHitDist / vDownAngleCos[y];
+                }
+                RenderOrDelaySpan( auxFacePtr->IsTransparent(), nSlice, nSpanStrtY, nSpanStopY, pSpanDepths, pSpanPixels, pSpanShades, vFragments );
+
+                // get a pointer to the bottom face for ceiling rendering
+                auxFacePtr = auxMapCellPtr->GetFacePtr( FACE_BOTTOM );
+                // render ceiling segment if it's visible (if bot back <= bot front, ceiling is not visible and nothing will be rendered)
+                nSpanStrtY = std::max( nBotFrnt, nStrtY );
+                nSpanStopY = std::min( nBotBack, nStopY );
+                // likewise, the ceiling can only be visible from below
+                if (fPh >= float( hitRec.nLayer )) {
+                    nSpanStopY = nSpanStrtY - 1;
+                }
+                nFirstSkip = FirstSkippedPixel( nSlice, nSpanStrtY, nSpanStopY - nSpanStrtY + 1 );
+                for (int y = nSpanStrtY; y <= nSpanStopY; y++) {
+                    float fRenderDistance;
+                    // the constant 0.0f is there since ceilings are not yet fractionally positioned
+                    if (IsSkippedPixel( y - nSpanStrtY, nFirstSkip )) {
+                        fRenderDistance = get_ceil_distance( y, hitRec.nLayer, 0.0f );
+                    } else {
+                        pSpanPixels[ y - nSpanStrtY ] = get_ceil_sample( nSlice, y, hitRec.nLayer, fStrtDist, 0.0f, fRenderDistance, pSpanShades[ y - nSpanStrtY ] );   // shading is done in get_ceil_sample()
+                    }
+                    pSpanDepths[ y - nSpanStrtY ] = get_flat_depth( fRenderDistance, y );
+                }
+                FillInSpan( pSpanPixels, nSpanStopY - nSpanStrtY + 1, nFirstSkip, pSpanShades );
+                RenderOrDelaySpan( auxFacePtr->IsTransparent(), nSlice, nSpanStrtY, nSpanStopY, pSpanDepths, pSpanPixels, pSpanShades, vFragments );
+            }
+
+            for (auto &elt : localSliceQueue) {
+
+                // check on the depth buffer if (pieces of) this sub slice is masked or not
+                while (cDDrawer.IsMasked( elt.nSlice, elt.nStrtY, elt.fStrtDist ) && elt.nStrtY != elt.nStopY ) {
+                    elt.nStrtY += 1;
+                }
+                while (cDDrawer.IsMasked( elt.nSlice, elt.nStopY, elt.fStrtDist ) && nOspTopFrnt != elt.nStopY) {
+                    elt.nStopY -= 1;
+                }
+                // draw this piece in magenta and set depth buffer to prevent overdrawing by farther away walls
+                for (int y = elt.nStrtY; y <= elt.nStopY; y++) {
+                    cDDrawer.Draw( elt.fStrtDist / vDownAngleCos[y], elt.nSlice, y, olc::MAGENTA );
+                }
+                // put elements of local slice queue into global slice queue (if any)
+                if (pSpawnQ == nullptr) {
+                    dSliceQ.push( elt );
+                } else {
+                    pSpawnQ->push( elt );
+                }
+            }
+            localSliceQueue.clear();
+
+            // DELAYED WALL RENDERING for this slice
+            // ======================
+            ResolveFragments( nSlice, vFragments );
+
+        }   // if slice queue not empty
+    }
+
+// ==============================/  parallel rendering  /==============================
+
+    std::vector<RayRangeRec> vRayRanges;    // for merging the minimap rays of all threads
+
+    // Renders all sub slices in slice queue dSliceQ (and the sub slices these spawn) using the render pool. The screen columns are divided
+    // in chunks of RENDER_CHUNK_SIZE columns, and the chunks are divided over the deques of the threads. Each thread renders the work items
+    // from its own deque, and if that's empty it steals from the other ones. The sub slices that a work item spawns through portals are
+    // pushed as new work items (one per column) onto the deque of the thread that rendered it, so that the columns that look through many
+    // portals are spread over the threads as well.
+    // The sub slices of different columns only share the ray cache (which has a record per column) and the depth drawer (which works
+    // per pixel). A column has at most one work item at any time, and its sub slices are rendered in the same order as with a single
+    // queue (per portal depth, in the order they were spawned). So the output doesn't depend on the nr of threads or on which thread
+    // steals what. The minimap rays are collected per thread, and are added to vRayList in the order of the work items.
+    void RenderSlicesParallel( SliceQueue &dSliceQ, std::vector<float> &vDownAngleCos ) {
+        int nThreads = cRenderPool.NrOfThreads();
+        std::vector<WorkDeque> vDeques( nThreads );
+        // divide the sub slices over the chunks, keeping their order
+        int nChunks = (RenderWidth() + RENDER_CHUNK_SIZE - 1) / RENDER_CHUNK_SIZE;
+        std::vector<SliceWorkRec> vChunkItems( nChunks );
+        for (int c = 0; c < nChunks; c++) {
+            vChunkItems[c].nColumnLo = c * RENDER_CHUNK_SIZE;
+            vChunkItems[c].nColumnHi = std::min( vChunkItems[c].nColumnLo + RENDER_CHUNK_SIZE, RenderWidth()) - 1;
+            vChunkItems[c].nDepth    = 0;
+        }
+        while (!dSliceQ.empty()) {
+            SubSliceRec tmp = dSliceQ.pop();
+            vChunkItems[ tmp.nSlice / RENDER_CHUNK_SIZE ].dSliceQ.push( tmp );
+        }
+        // each thread gets a contiguous range of chunks. They are pushed from right to left, so that the owner works its way from left
+        // to right, and the other threads steal from the far end
+        for (int c = nChunks - 1; c >= 0; c--) {
+            vDeques[ c * nThreads / nChunks ].push( std::move( vChunkItems[c] ));
+        }
+        // nr of work items that are not completely rendered yet
+        std::atomic<int> nPending( nChunks );
+        // threads that find no work wait on cvWork until new work items are pushed (nWorkVersion is incremented) or all work is done
+        std::mutex              mtxWork;
+        std::condition_variable cvWork;
+        std::atomic<int>        nWorkVersion( 0 );
+
+        cRenderPool.Run( [&]( int nThread ) {
+            nRenderThread = nThread;
+            ThreadScratchRec &rScratch = vThreadScratch[ nThread ];
+            SliceWorkRec curItem;
+            SliceQueue   dSpawnQ;
+            while (nPending > 0) {
+                // the version must be read before the deques are tried, so that items pushed after that are not missed
+                int nSeenVersion = nWorkVersion;
+                bool bGotItem = vDeques[ nThread ].pop( curItem );
+                for (int i = 1; i < nThreads && !bGotItem; i++) {
+                    bGotItem = vDeques[ (nThread + i) % nThreads ].steal( curItem );
+                    if (bGotItem) {
+                        rScratch.nItemsStolen += 1;
+                    }
+                }
+                if (!bGotItem) {
+                    // the remaining items are being rendered by other threads, and may still spawn new ones
+                    std::unique_lock<std::mutex> lock( mtxWork );
+                    cvWork.wait( lock, [&]() { return nPending == 0 || nWorkVersion != nSeenVersion; } );
+                    continue;
+                }
+
+                RayRangeRec sRange = { curItem.nDepth, curItem.nColumnLo, nThread, (int)rScratch.vRayList.size(), 0 };
+                rScratch.nColumnLo = curItem.nColumnLo;
+                rScratch.nColumnHi = curItem.nColumnHi;
+                while (!curItem.dSliceQ.empty()) {
+                    SubSliceRec &curSubSlice = curItem.dSliceQ.front();
+                    if (curSubSlice.bResetSlice) {
+                        cDDrawer.Reset( curSubSlice.nSlice, curSubSlice.nStrtY, curSubSlice.nStopY );
+                    }
+                    RenderSubSlice( curItem.dSliceQ, vDownAngleCos, &dSpawnQ );
+                }
+                sRange.nLastRay = (int)rScratch.vRayList.size();
+                rScratch.vRayRanges.push_back( sRange );
+
+                // split the spawned sub slices in one work item per column. The sub slices of a column are adjacent in the spawn queue,
+                // since the sub slices of the item are rendered column by column
+                std::vector<SliceWorkRec> &vSpawned = rScratch.vSpawnedItems;
+                vSpawned.clear();
+                while (!dSpawnQ.empty()) {
+                    SubSliceRec tmp = dSpawnQ.pop();
+                    if (vSpawned.empty() || vSpawned.back().nColumnLo != tmp.nSlice) {
+                        vSpawned.push_back( SliceWorkRec() );
+                        vSpawned.back().nColumnLo = tmp.nSlice;
+                        vSpawned.back().nColumnHi = tmp.nSlice;
+                        vSpawned.back().nDepth    = curItem.nDepth + 1;
+                    }
+                    vSpawned.back().dSliceQ.push( tmp );
+                }
+                // the new items must be counted before this one is finished, otherwise the other threads could stop too early
+                nPending += (int)vSpawned.size();
+                for (int i = (int)vSpawned.size() - 1; i >= 0; i--) {
+                    vDeques[ nThread ].push( std::move( vSpawned[i] ));
+                }
+                if (!vSpawned.empty()) {
+                    std::lock_guard<std::mutex> lock( mtxWork );
+                    nWorkVersion += 1;
+                    cvWork.notify_all();
+                }
+                // the lock makes sure that a thread that is about to wait sees the count drop to 0, or is woken up
+                if (--nPending == 0) {
+                    std::lock_guard<std::mutex> lock( mtxWork );
+                    cvWork.notify_all();
+                }
+            }
+            rScratch.nColumnLo = 0;
+            rScratch.nColumnHi = INT_MAX;
+        } );
+
+        // merge the minimap rays in a fixed order
+        vRayRanges.clear();
+        for (auto &elt : vThreadScratch) {
+            vRayRanges.insert( vRayRanges.end(), elt.vRayRanges.begin(), elt.vRayRanges.end());
+            elt.vRayRanges.clear();
+        }
+        std::sort( vRayRanges.begin(), vRayRanges.end(), []( const RayRangeRec &a, const RayRangeRec &b ) {
+            return (a.nDepth != b.nDepth) ? (a.nDepth < b.nDepth) : (a.nColumn < b.nColumn);
+        } );
+        for (auto &elt : vRayRanges) {
+            std::vector<RayType> &vThreadRays = vThreadScratch[ elt.nThread ].vRayList;
+            vRayList.insert( vRayList.end(), vThreadRays.begin() + elt.nFirstRay, vThreadRays.begin() + elt.nLastRay );
+        }
+        for (auto &elt : vThreadScratch) {
+            elt.vRayList.clear();
+        }
+    }
+
+// ==============================/  scaling benchmark  /==============================
+
+    // Generates a procedural single layer map layout of nSize x nSize cells for the scaling benchmark. It's mostly empty space, with
+    // a rectangular building and some pillars in about one out of four areas of 64 x 64 cells. The center cell is kept empty
+    // since that's where the benchmark rays are cast from.
+    // Returns false (and an empty layout) if nSize exceeds the max. map size.
+    bool GenerateBenchmarkLayout( int nSize, std::vector<std::string> &sLayout ) {
+        if (nSize > MAP_MAX_SIZE) {
+            std::cout << "ERROR: GenerateBenchmarkLayout() --> map size " << nSize << " exceeds max. map size " << MAP_MAX_SIZE << std::endl;
+            sLayout.clear();
+            return false;
+        }
+        sLayout.assign( nSize, std::string( nSize, '.' ));
+
+        // simple linear congruential generator, so that each run uses the same maps
+        uint32_t nSeed = 12345;
+        auto get_random = [&]( int nMax ) -> int {
+            nSeed = nSeed * 1664525u + 1013904223u;
+            return int( (nSeed >> 8) % uint32_t( nMax ));
+        };
+
+        for (int ay = 0; ay < nSize; ay += 64) {
+            for (int ax = 0; ax < nSize; ax += 64) {
+                // the areas at the right and bottom side of the map may be smaller
+                int nAreaX = std::min( 64, nSize - ax );
+                int nAreaY = std::min( 64, nSize - ay );
+                if (get_random( 4 ) == 0 && nAreaX >= 8 && nAreaY >= 8) {
+                    int nW = 2 + get_random( nAreaX / 4 );
+                    int nH = 2 + get_random( nAreaY / 4 );
+                    int nX = ax + get_random( nAreaX - nW );
+                    int nY = ay + get_random( nAreaY - nH );
+                    for (int y = nY; y < nY + nH; y++) {
+                        for (int x = nX; x < nX + nW; x++) {
+                            sLayout[y][x] = '#';
+                        }
+                    }
+                    // put some pillars around the building
+                    for (int i = 0; i < 8; i++) {
+                        sLayout[ ay + get_random( nAreaY ) ][ ax + get_random( nAreaX ) ] = '#';
+                    }
+                }
+            }
+        }
+        sLayout[ nSize / 2 ][ nSize / 2 ] = '.';
+        return true;
+    }
+
+    // returns a hash value over the hit lists in vHitLists, to compare DDA results bit for bit
+    uint64_t HashHitLists( uint64_t nHash, std::vector<std::vector<IntersectInfo>> &vHitLists ) {
+        // FNV-1a hash
+        auto add_to_hash = [&]( uint32_t nValue ) {
+            for (int i = 0; i < 4; i++) {
+                nHash ^= (nValue >> (i * 8)) & 0xff;
+                nHash *= 1099511628211ull;
+            }
+        };
+        for (auto &vList : vHitLists) {
+            add_to_hash( (uint32_t)vList.size() );
+            for (auto &elt : vList) {
+                uint32_t nDistBits;
+                memcpy( &nDistBits, &elt.fDistFrnt_raw, sizeof( nDistBits ));
+                add_to_hash( nDistBits );
+                add_to_hash( (uint32_t)elt.nHitX );
+                add_to_hash( (uint32_t)elt.nHitY );
+                add_to_hash( (uint32_t)elt.nFaceHit );
+            }
+        }
+        return nHash;
+    }
+
+    // Measures how the DDA scales with the map size, for maps of BENCH_MIN_MAP_SIZE x BENCH_MIN_MAP_SIZE up to
+    // nMaxMapSize x nMaxMapSize cells. For each map size a fan of BENCH_NR_RAYS rays is cast from the center of the map
+    // using the single pass DDA, without empty space skipping, with the distance fields and with distance fields + occupancy pyramid.
+    // This is done both for the float and for the fixed point DDA.
+    // The results are written to the console. Since skipping must not alter the result, the hit lists of the variants are compared
+    // (bit for bit, using a hash value). The fixed point results are also compared against the reference values in BENCH_REFERENCE_FILE.
+    // A missing reference file (or a missing map size in it) counts as a failure. With bWriteReference the reference file is (re)written from the
+    // results of this run instead, so it only holds the map sizes up to nMaxMapSize.
+    // Returns true if all checks passed. The benchmark can be run without the UI using the command line argument --bench (see main()).
+    bool RunScalingBenchmark( int nMaxMapSize, bool bWriteReference = false ) {
+
+        // cache the settings that are changed by the benchmark
+        float fCacheMaxDistance = fMaxDistance;
+        bool  bCacheSkipCells   = bSkipEmptyCells;
+        bool  bCacheSkipBlocks  = bSkipEmptyBlocks;
+        bool  bCacheFixedPoint  = bFixedPointDDA;
+
+        // read the reference hash values of the fixed point DDA (per map size) if available
+        std::vector<std::pair<int, uint64_t>> vReference, vResults;
+        std::string sRefPath = sBenchRefPath;
+        std::ifstream fileIn( sRefPath );
+        int nRefSize;
+        uint64_t nRefHash;
+        while (fileIn >> nRefSize >> std::hex >> nRefHash >> std::dec) {
+            vReference.push_back( { nRefSize, nRefHash } );
+        }
+        fileIn.close();
+
+        std::cout << "Scaling benchmark - " << BENCH_NR_RAYS << " rays per run, time in microseconds per ray" << std::endl;
+        std::cout << "             | float DDA                             | fixed point DDA                       |" << std::endl;
+        std::cout << "map size     | no skipping | dist. field | + pyramid | no skipping | dist. field | + pyramid | hit points per ray" << std::endl;
+
+        bool bPassed = true;
+        std::vector<std::vector<IntersectInfo>> vHitLists;
+        std::vector<PortalDescriptor> vNoPortals;
+        for (int nSize = BENCH_MIN_MAP_SIZE; nSize <= nMaxMapSize; nSize *= 4) {
+
+            // the benchmark map is temporarily added to the vector of maps, since the DDA functions address maps by index
+            std::vector<std::string> sLayout;
+            if (!GenerateBenchmarkLayout( nSize, sLayout )) {
+                bPassed = false;
+                break;
+            }
+            int nBenchMap = (int)vMaps.size();
+            vMaps.push_back( RC_Map() );
+            vMaps[ nBenchMap ].InitMap( nBenchMap, vNoPortals, vFlorSprites[0] );
+            vMaps[ nBenchMap ].AddLayer( sLayout, vWallSprites, vCeilSprites, vRoofSprites );
+            fMaxDistance = vMaps[ nBenchMap ].DiagonalLength();
+
+            float fPx = nSize / 2 + 0.5f;
+            float fPy = nSize / 2 + 0.5f;
+            float    vTimes[6];
+            int      vHitPoints[6];
+            uint64_t vHashes[6];
+            for (int nVariant = 0; nVariant < 6; nVariant++) {
+                bSkipEmptyCells  = (nVariant % 3 >= 1);
+                bSkipEmptyBlocks = (nVariant % 3 >= 2);
+                bFixedPointDDA   = (nVariant   >= 3);
+
+                vHitPoints[ nVariant ] = 0;
+                auto tStart = std::chrono::steady_clock::now();
+                for (int i = 0; i < BENCH_NR_RAYS; i++) {
+                    CameraRayRec sRay;
+                    InitCameraRay( sRay, 0.0f, 0.1f + 360.0f * float( i ) / float( BENCH_NR_RAYS ));
+                    CastRayAllLevelsAndAngle( nBenchMap, fPx, fPy, sRay, fMaxDistance, vHitLists );
+                    vHitPoints[ nVariant ] += (int)vHitLists[0].size();
+                }
+                auto tStop = std::chrono::steady_clock::now();
+                vTimes[ nVariant ] = std::chrono::duration<float, std::micro>( tStop - tStart ).count() / float( BENCH_NR_RAYS );
+
+                // cast the same rays again to hash the results - this is kept out of the timing
+                vHashes[ nVariant ] = 1469598103934665603ull;
+                for (int i = 0; i < BENCH_NR_RAYS; i++) {
+                    CameraRayRec sRay;
+                    InitCameraRay( sRay, 0.0f, 0.1f + 360.0f * float( i ) / float( BENCH_NR_RAYS ));
+                    CastRayAllLevelsAndAngle( nBenchMap, fPx, fPy, sRay, fMaxDistance, vHitLists );
+                    vHashes[ nVariant ] = HashHitLists( vHashes[ nVariant ], vHitLists );
+                }
+            }
+
+            std::cout << nSize << " x " << nSize << "\t| " << vTimes[0] << "\t| " << vTimes[1] << "\t| " << vTimes[2]
+                                                  << "\t| " << vTimes[3] << "\t| " << vTimes[4] << "\t| " << vTimes[5]
+                                                  << "\t| "
+                      << float( vHitPoints[0] ) / float( BENCH_NR_RAYS );
+            if (vHashes[1] != vHashes[0] || vHashes[2] != vHashes[0] || vHashes[4] != vHashes[3] || vHashes[5] != vHashes[3]) {
+                std::cout << " - ERROR: RunScalingBenchmark() --> hit lists differ per variant";
+                bPassed = false;
+            }
+            // check the fixed point results against the reference
+            vResults.push_back( { nSize, vHashes[3] } );
+            if (!bWriteReference) {
+                auto itRef = std::find_if( vReference.begin(), vReference.end(), [=]( const std::pair<int, uint64_t> &elt ) { return elt.first == nSize; } );
+                if (itRef == vReference.end()) {
+                    std::cout << " - ERROR: RunScalingBenchmark() --> no reference for this map size";
+                    bPassed = false;
+                } else if (itRef->second != vHashes[3]) {
+                    std::cout << " - ERROR: RunScalingBenchmark() --> fixed point hit lists differ from reference";
+                    bPassed = false;
+                }
+            }
+            std::cout << std::endl;
+
+            vMaps[ nBenchMap ].FinalizeMap();
+            vMaps.pop_back();
+        }
+
+        if (bWriteReference) {
+            std::ofstream fileOut( sRefPath );
+            for (auto &elt : vResults) {
+                fileOut << elt.first << " " << std::hex << elt.second << std::dec << std::endl;
+            }
+            if (fileOut.good()) {
+                std::cout << "Reference output of the fixed point DDA written to " << sRefPath << std::endl;
+            } else {
+                std::cout << "ERROR: RunScalingBenchmark() --> can't write reference file: " << sRefPath << std::endl;
+                bPassed = false;
+            }
+        } else if (vReference.empty()) {
+            std::cout << "ERROR: RunScalingBenchmark() --> missing or empty reference file: " << sRefPath << std::endl;
+            bPassed = false;
+        } else {
+            std::cout << "Fixed point DDA checked against reference output in " << sRefPath << std::endl;
+        }
+
+        // restore the cached settings
+        fMaxDistance     = fCacheMaxDistance;
+        bSkipEmptyCells  = bCacheSkipCells;
+        bSkipEmptyBlocks = bCacheSkipBlocks;
+        bFixedPointDDA   = bCacheFixedPoint;
+
+        return bPassed;
+    }
+
+    std::string sBenchRefPath = BENCH_REFERENCE_FILE;    // reference file of the fixed point DDA check, see SetBenchReferencePath()
+
+    // Sets the path of the reference file of the fixed point DDA check to sPath. If sPath is empty, BENCH_REFERENCE_FILE is looked up in the
+    // directory of the executable (sExePath is argv[0]), since the program is built next to its sources. So the check doesn't depend on the
+    // working directory of the program, unless it's started without a path (e.g. found via PATH).
+    void SetBenchReferencePath( const std::string &sPath, const std::string &sExePath ) {
+        if (!sPath.empty()) {
+            sBenchRefPath = sPath;
+        } else {
+            size_t nSeparator = sExePath.find_last_of( "/\\" );
+            sBenchRefPath = (nSeparator == std::string::npos) ? BENCH_REFERENCE_FILE : sExePath.substr( 0, nSeparator + 1 ) + BENCH_REFERENCE_FILE;
+        }
+    }
+
+    // Measures the ray queries for the game logic: BENCH_NR_QUERIES line of sight queries between random points of the active map are
+    // cast one by one on this thread, and as one batch on the render threads (see cRayQuery). The results of both must be identical.
+    void RunRayQueryBenchmark() {
+
+        RC_Map &rMap = vMaps[ nActiveMap ];
+        std::vector<RayQuery> vQueries( BENCH_NR_QUERIES );
+        for (auto &elt : vQueries) {
+            elt.nMap     = nActiveMap;
+            elt.nLayer   = int( fPlayerH );
+            elt.fOrgX    = float_rand_between( 0.0f, float( rMap.GetWidth()  ));
+            elt.fOrgY    = float_rand_between( 0.0f, float( rMap.GetHeight() ));
+            elt.fDirX    = float_rand_between( 0.0f, float( rMap.GetWidth()  )) - elt.fOrgX;
+            elt.fDirY    = float_rand_between( 0.0f, float( rMap.GetHeight() )) - elt.fOrgY;
+            elt.fMaxDist = sqrt( elt.fDirX * elt.fDirX + elt.fDirY * elt.fDirY );
+            elt.nFlags   = RAYQ_LINE_OF_SIGHT;
+            // prevent zero length queries
+            if (elt.fMaxDist == 0.0f) { elt.fDirX = 1.0f; elt.fMaxDist = 1.0f; }
+        }
+
+        std::vector<RayQueryResult> vSingle( BENCH_NR_QUERIES ), vBatch;
+        auto tStart = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCH_NR_QUERIES; i++) {
+            cRayQuery.CastRay( vQueries[i], vSingle[i] );
+        }
+        auto tMid = std::chrono::steady_clock::now();
+        cRayQuery.CastBatch( vQueries, vBatch );
+        auto tStop = std::chrono::steady_clock::now();
+
+        int nVisible = 0;
+        bool bDiffer = false;
+        for (int i = 0; i < BENCH_NR_QUERIES; i++) {
+            nVisible += vSingle[i].bHit ? 0 : 1;
+            bDiffer |= vSingle[i].bHit != vBatch[i].bHit || vSingle[i].nCellX != vBatch[i].nCellX || vSingle[i].nCellY != vBatch[i].nCellY;
+        }
+        std::cout << "Ray query benchmark - " << BENCH_NR_QUERIES << " line of sight queries (" << nVisible << " visible), time in microseconds" << std::endl;
+        std::cout << "single thread: " << std::chrono::duration<float, std::micro>( tMid  - tStart ).count()
+                  << "\tbatch on " << cRayQuery.NrOfThreads() << " threads: " << std::chrono::duration<float, std::micro>( tStop - tMid ).count();
+        if (bDiffer) {
+            std::cout << " - ERROR: RunRayQueryBenchmark() --> batch results differ from single thread results";
+        }
+        std::cout << std::endl;
+    }
+
+    // Renders the first level sub slices of the current player position (walls, floors, ceilings and roofs - no objects) into the
+    // draw target, with an empty ray cache, and returns a hash value over the draw target. It doesn't need the UI (the screen isn't
+    // touched), so it's used by the benchmarks and the checks that can be run from the command line.
+    uint64_t RenderHashedFrame( int nHorizonHeight, std::vector<float> &fHeightAngleCos ) {
+        int nCacheRays = (int)vRayList.size();
+        for (auto &elt : vRayCache) {
+            elt.bValid = false;
+        }
+        SliceQueue dFrameQueue;
+        for (int x = 0; x < RenderWidth(); x++) {
+            SubSliceRec tmp = {
+                vCameraRays[x].fViewAngle_deg, vCameraRays[x].fCurAngle_deg, fPlayerA_deg,
+                nActiveMap, fPlayerX, fPlayerY, fPlayerH,
+                0.0f,
+                x, 0, RenderHeight() - 1,
+                nHorizonHeight,
+                true
+            };
+            dFrameQueue.push( tmp );
+        }
+        bFloorRowPass = RENDER_FLOOR_ROWS;
+        RenderSlicesParallel( dFrameQueue, fHeightAngleCos );
+        if (bFloorRowPass) {
+            RenderFloorRows( nActiveMap, fPlayerX, fPlayerY, fPlayerH, nHorizonHeight );
+        }
+        vRayList.resize( nCacheRays );
+
+        // FNV-1a hash
+        uint64_t nHash = 1469598103934665603ull;
+        for (auto &elt : GetDrawTarget()->pColData) {
+            nHash ^= elt.n;
+            nHash *= 1099511628211ull;
+        }
+        return nHash;
+    }
+
+    // Checks that the adaptive column subdivision renders exactly the same frames as casting every column. CHECK_NR_FRAMES frames are
+    // rendered along a fixed camera path in the active map, once with bAdaptiveColumns off and once with it on, and the frames are
+    // compared using a hash value. The path circles around the start position while turning a full circle, and flies up and down and
+    // looks up and down on the way, so that the blocks are seen from below, from the side and from above.
+    // The nr of differing frames and the nr of rays cast resp. filled in are written to the console. Returns true if all frames are identical.
+    // The check can be run without the UI using the command line argument --check-adaptive (see main()).
+    bool RunAdaptiveColumnsCheck() {
+
+        // cache the settings that are changed by the check
+        float fCachePlayerX    = fPlayerX;
+        float fCachePlayerY    = fPlayerY;
+        float fCachePlayerH    = fPlayerH;
+        float fCachePlayerA    = fPlayerA_deg;
+        float fCachePlayerLU   = fPlayerLU;
+        bool  bCacheAdaptive   = bAdaptiveColumns;
+        bool  bCacheDeferFrame = bDeferFrame;
+        // the shading is done while sampling, as with bDeferred off
+        bDeferFrame = false;
+        cDDrawer.EnableShadeBuffer( false );
+        SetDrawTarget( pRenderSprite );
+
+        std::vector<uint64_t> vHashes[2];
+        int vRaysCast[2]     = { 0, 0 };
+        int vRaysFilledIn[2] = { 0, 0 };
+        for (int nRun = 0; nRun < 2; nRun++) {
+            bAdaptiveColumns = (nRun == 1);
+            for (int i = 0; i < CHECK_NR_FRAMES; i++) {
+                float fPhase = 2.0f * PI * float( i ) / float( CHECK_NR_FRAMES );
+                fPlayerX     = fStartPlayerX + 0.3f * cosf( fPhase );
+                fPlayerY     = fStartPlayerY + 0.3f * sinf( fPhase );
+                fPlayerH     = 0.85f - 0.7f * cosf( 2.0f * fPhase );
+                fPlayerA_deg = fmodf( fStartPlayerA + 360.0f * float( i ) / float( CHECK_NR_FRAMES ), 360.0f );
+                fPlayerLU    = 0.25f * float( ScreenHeight()) * sinf( 3.0f * fPhase );
+                UpdateCameraRays( fPlayerA_deg );
+
+                int nHorizonHeight = RenderHeight() * fPlayerH + int( fPlayerLU * float( RenderHeight()) / float( ScreenHeight()));
+                std::vector<float> fHeightAngleCos( RenderHeight() );
+                for (int y = 0; y < RenderHeight(); y++) {
+                    fHeightAngleCos[y] = std::abs( lu_cos( (y - nHorizonHeight) * fAnglePerPixel_deg ));
+                }
+                for (auto &elt : vThreadScratch) {
+                    elt.nRaysCast     = 0;
+                    elt.nRaysFilledIn = 0;
+                }
+                vHashes[ nRun ].push_back( RenderHashedFrame( nHorizonHeight, fHeightAngleCos ));
+                for (auto &elt : vThreadScratch) {
+                    vRaysCast[ nRun ]     += elt.nRaysCast;
+                    vRaysFilledIn[ nRun ] += elt.nRaysFilledIn;
+                }
+            }
+        }
+        int nDiffer = 0;
+        for (int i = 0; i < CHECK_NR_FRAMES; i++) {
+            nDiffer += (vHashes[0][i] != vHashes[1][i]) ? 1 : 0;
+        }
+        std::cout << "Adaptive columns check - " << CHECK_NR_FRAMES << " frames of " << RenderWidth() << " columns" << std::endl;
+        std::cout << "adaptive columns off: " << vRaysCast[0] << " rays cast" << std::endl;
+        std::cout << "adaptive columns on:  " << vRaysCast[1] << " rays cast, " << vRaysFilledIn[1] << " filled in" << std::endl;
+        if (nDiffer > 0) {
+            std::cout << "ERROR: RunAdaptiveColumnsCheck() --> " << nDiffer << " frames differ" << std::endl;
+        } else {
+            std::cout << "all frames identical" << std::endl;
+        }
+
+        // restore the cached settings and the ray cache
+        SetDrawTarget( nullptr );
+        fPlayerX         = fCachePlayerX;
+        fPlayerY         = fCachePlayerY;
+        fPlayerH         = fCachePlayerH;
+        fPlayerA_deg     = fCachePlayerA;
+        fPlayerLU        = fCachePlayerLU;
+        bAdaptiveColumns = bCacheAdaptive;
+        bDeferFrame      = bCacheDeferFrame;
+        cDDrawer.EnableShadeBuffer( bDeferFrame );
+        UpdateCameraRays( fPlayerA_deg );
+        for (auto &elt : vRayCache) {
+            elt.bValid = false;
+        }
+        return nDiffer == 0;
+    }
+
+    // Measures how the parallel rendering scales with the nr of threads, on a scene where most screen columns look through a long chain
+    // of portals. The benchmark map is a hall with portals in its west and east wall, that lead to the other side of the same hall. So the
+    // hall repeats itself until the portals get too small on screen, while the columns that look at the side walls are done quickly.
+    // For 1 up to the nr of hardware threads the scene is rendered BENCH_PORTAL_FRAMES times (each time with an empty ray cache), and the
+    // time per frame, the speed up and the nr of work items that were stolen are written to the console. The output must not depend on
+    // the nr of threads, so the rendered frames are compared (using a hash value) as well.
+    // The frames are rendered without deferred shading, since ShadeFrame() isn't part of the benchmark.
+    void RunPortalBenchmark() {
+
+        // cache the settings that are changed by the benchmark
+        int   nCacheMap         = nActiveMap;
+        float fCachePlayerX     = fPlayerX;
+        float fCachePlayerY     = fPlayerY;
+        float fCachePlayerH     = fPlayerH;
+        float fCachePlayerA     = fPlayerA_deg;
+        float fCachePlayerLU    = fPlayerLU;
+        float fCacheMaxDistance = fMaxDistance;
+        bool  bCacheDeferFrame  = bDeferFrame;
+
+        // the benchmark map is temporarily added to the vector of maps, since the portals address maps by index
+        std::vector<std::string> sLayout = {
+            "################",
+            "<..............>",
+            "<..............>",
+            "<..............>",
+            "<..............>",
+            "<..............>",
+            "################",
+        };
+        int nBenchMap = (int)vMaps.size();
+        int nLastX    = (int)sLayout[0].size() - 1;
+        std::vector<PortalDescriptor> vPortals;
+        for (int y = 1; y < (int)sLayout.size() - 1; y++) {
+            vPortals.push_back( { nBenchMap, 0,      0, y, nBenchMap, 0, nLastX - 1, y, FACE_WEST, 180.0f } );
+            vPortals.push_back( { nBenchMap, 0, nLastX, y, nBenchMap, 0,          1, y, FACE_EAST,   0.0f } );
+        }
+        vMaps.push_back( RC_Map() );
+        vMaps[ nBenchMap ].InitMap( nBenchMap, vPortals, vFlorSprites[0] );
+        vMaps[ nBenchMap ].AddLayer( sLayout, vWallSprites, vCeilSprites, vRoofSprites );
+
+        nActiveMap   = nBenchMap;
+        fPlayerX     = float( nLastX ) / 2.0f;
+        fPlayerY     = float( sLayout.size()) / 2.0f;
+        fPlayerH     = 0.5f;
+        fPlayerA_deg = 10.0f;
+        fPlayerLU    = 0.0f;
+        fMaxDistance = vMaps[ nBenchMap ].GetDrawDistance();
+        UpdateCameraRays( fPlayerA_deg );
+        // the shading is done while sampling, as with bDeferred off
+        bDeferFrame  = false;
+        cDDrawer.EnableShadeBuffer( false );
+
+        SetDrawTarget( pRenderSprite );
+        int nHorizonHeight = RenderHeight() * fPlayerH + (int)fPlayerLU;
+        std::vector<float> fHeightAngleCos( RenderHeight() );
+        for (int y = 0; y < RenderHeight(); y++) {
+            fHeightAngleCos[y] = std::abs( lu_cos( (y - nHorizonHeight) * fAnglePerPixel_deg ));
+        }
+
+        int nMaxThreads = std::max( 1, int( std::thread::hardware_concurrency()));
+        std::cout << "Portal benchmark - " << BENCH_PORTAL_FRAMES << " frames per run, time in milliseconds per frame" << std::endl;
+        std::cout << "threads | time    | speed up | stolen work items per frame" << std::endl;
+        float    fTimeSingle = 0.0f;
+        uint64_t nHashSingle = 0;
+        for (int nThreads = 1; nThreads <= nMaxThreads; nThreads++) {
+            cRenderPool.Init( nThreads );
+            vThreadScratch.resize( cRenderPool.NrOfThreads());
+            for (auto &elt : vThreadScratch) {
+                elt.nItemsStolen = 0;
+            }
+
+            uint64_t nHash = 0;
+            auto tStart = std::chrono::steady_clock::now();
+            for (int i = 0; i < BENCH_PORTAL_FRAMES; i++) {
+                nHash = RenderHashedFrame( nHorizonHeight, fHeightAngleCos );
+            }
+            auto tStop = std::chrono::steady_clock::now();
+            float fTime = std::chrono::duration<float, std::milli>( tStop - tStart ).count() / float( BENCH_PORTAL_FRAMES );
+
+            int nStolen = 0;
+            for (auto &elt : vThreadScratch) {
+                nStolen += elt.nItemsStolen;
+            }
+            if (nThreads == 1) {
+                fTimeSingle = fTime;
+                nHashSingle = nHash;
+            }
+            std::cout << nThreads << "\t| " << fTime << "\t| " << fTimeSingle / fTime << "\t| " << float( nStolen ) / float( BENCH_PORTAL_FRAMES );
+            if (nHash != nHashSingle) {
+                std::cout << " - ERROR: RunPortalBenchmark() --> rendered frame differs from the single thread frame";
+            }
+            std::cout << std::endl;
+        }
+        // the work items of the last frame are still in vRayRanges
+        int nMaxDepth = 0;
+        for (auto &elt : vRayRanges) {
+            nMaxDepth = std::max( nMaxDepth, elt.nDepth );
+        }
+        std::cout << "work items per frame: " << vRayRanges.size() << ", max nr of portals passed: " << nMaxDepth << std::endl;
+
+        // restore the render pool, the cached settings and the ray cache
+        SetDrawTarget( nullptr );
+        cRenderPool.Init( RENDER_THREADS );
+        vThreadScratch.resize( cRenderPool.NrOfThreads());
+        vMaps[ nBenchMap ].FinalizeMap();
+        vMaps.pop_back();
+
+        nActiveMap   = nCacheMap;
+        fPlayerX     = fCachePlayerX;
+        fPlayerY     = fCachePlayerY;
+        fPlayerH     = fCachePlayerH;
+        fPlayerA_deg = fCachePlayerA;
+        fPlayerLU    = fCachePlayerLU;
+        fMaxDistance = fCacheMaxDistance;
+        bDeferFrame  = bCacheDeferFrame;
+        cDDrawer.EnableShadeBuffer( bDeferFrame );
+        for (auto &elt : vRayCache) {
+            elt.bValid = false;
+        }
+        // the benchmark drew over the screen, so start on a new pass if progressive rendering was busy
+        while (!dSliceQueue.empty()) {
+            dSliceQueue.pop();
+        }
+    }
+
+// ==============================/  floor rendering  /==============================
+
+    // is the floor of the first level sub slices rendered by RenderFloorRows()? If not, RenderSubSlice() renders it per column
+    bool bFloorRowPass = false;
+
+    // Renders the floor of the first level sub slices row by row, after the walls are rendered. The distance to the floor only depends
+    // on the screen row, so the distance, fog and (most of the) shading are worked out once per row, and the floor point in each column
+    // follows from the camera ray table. Only the pixels that are untouched in the depth buffer are drawn, these are the pixels
+    // below the horizon that are not covered by walls, objects seen through portals etc.
+    // NOTE: only the ground floor is done this way. The roofs and ceilings are per map cell, at the height of the block, so within a screen
+    // row they are at different distances (and they are only visible where the DDA found the cell). Per row there's no single distance
+    // for them, so they stay in the per column pass of RenderSubSlice(). The same holds for the floor of the sub slices seen through portals,
+    // which has another distance offset per column (fStrtDist).
+    void RenderFloorRows( int nMap, float fPx, float fPy, float fPh, int nHorHght ) {
+        RC_Map &rMap = vMaps[ nMap ];
+        olc::Sprite *pFloorSprite = rMap.GetFloorSpritePtr();
+        bool       bFog     = rMap.HasFog();
+        float      fFogStop = rMap.GetDrawDistance();
+        float      fFogStrt = fFogStop * FOG_START_FACTOR;
+        olc::Pixel fogCol   = rMap.GetFogColour();
+        // the floor must be behind the sky and the backgrounds that RenderSubSlice() draws (at fMaxDistance + 1000.0f), so that
+        // only the untouched pixels are drawn
+        float fFloorDepth = fMaxDistance + 2000.0f;
+
+        // the rows are divided over the render threads using an atomic counter
+        std::atomic<int> nNextRow( std::max( nHorHght, 0 ));
+        cRenderPool.Run( [&]( int nThread ) {
+            ThreadScratchRec &rScratch = vThreadScratch[ nThread ];
+            if ((int)rScratch.vSpanPixels.size() < RenderWidth()) {
+                rScratch.vSpanPixels.resize( std::max( RenderWidth(), RenderHeight()));
+                rScratch.vSpanDepths.resize( std::max( RenderWidth(), RenderHeight()));
+                rScratch.vSpanShades.resize( std::max( RenderWidth(), RenderHeight()));
+            }
+            olc::Pixel *pRowPixels = rScratch.vSpanPixels.data();
+            float      *pRowShades = rScratch.vSpanShades.data();
+
+            for (int y = nNextRow++; y < RenderHeight(); y = nNextRow++) {
+                // work out the (uncorrected) distance to the floor in this row, and the fog and shading that follow from it
+                float fRowDist    = (fPh / float( y - nHorHght )) * fDistToProjPlane;
+                bool  bOnlyFog    = bFog && fRowDist >= fFogStop;
+                float fFogFactor  = (bFog && fRowDist > fFogStrt) ? std::min( 1.0f, (fRowDist - fFogStrt) / (fFogStop - fFogStrt)) : 0.0f;
+                // the shade factor is fObjectIntensity * fIntensityMultiplier / (fRowDist / fViewCos), see ShadePixel()
+                float fShadeRow   = fObjectIntensity * fIntensityMultiplier / fRowDist;
+                // with deferred shading the shading is left to ShadeFrame(), unless the row is in the fog
+                bool  bDeferRow   = bDeferFrame && !bOnlyFog && fFogFactor == 0.0f;
+
+                const float *pDepthRow = cDDrawer.GetDepthRow( y );
+                int x = 0;
+                while (x < RenderWidth()) {
+                    // skip the pixels that are drawn already, and sample the run of untouched pixels after them
+                    while (x < RenderWidth() && pDepthRow[x] < fFloorDepth) {
+                        x++;
+                    }
+                    int nRunStrtX = x;
+                    while (x < RenderWidth() && pDepthRow[x] >= fFloorDepth) {
+                        x++;
+                    }
+                    int nRunLen    = x - nRunStrtX;
+                    int nFirstSkip = FirstSkippedPixel( nRunStrtX, y, nRunLen );
+                    for (int i = 0; i < nRunLen; i++) {
+                        if (IsSkippedPixel( i, nFirstSkip )) {
+                            continue;
+                        }
+                        olc::Pixel floorSample = fogCol;
+                        pRowShades[i] = 0.0f;
+                        if (!bOnlyFog) {
+                            const CameraRayRec &rRay = vCameraRays[ nRunStrtX + i ];
+                            // calculate the world coordinates of the floor point, and the sample coordinates for it. Wrap around if the result < 0 or >= 1
+                            float fProjX = fPx + fRowDist * rRay.fFloorDX;
+                            float fProjY = fPy + fRowDist * rRay.fFloorDY;
+                            float fSampleX = fProjX - int(fProjX); if (fSampleX < 0.0f) fSampleX += 1.0f; if (fSampleX >= 1.0f) fSampleX -= 1.0f;
+                            float fSampleY = fProjY - int(fProjY); if (fSampleY < 0.0f) fSampleY += 1.0f; if (fSampleY >= 1.0f) fSampleY -= 1.0f;
+                            floorSample = pFloorSprite->Sample( fSampleX, fSampleY );
+                            if (bDeferRow) {
+                                pRowShades[i] = fRowDist / rRay.fViewCos;
+                            } else if (RENDER_SHADED) {
+                                floorSample = floorSample * std::max( SHADE_FACTOR_MIN, std::min( SHADE_FACTOR_MAX, fShadeRow * rRay.fViewCos ));
+                            }
+                            if (fFogFactor > 0.0f && floorSample.a != 0) {
+                                floorSample = FogPixel( floorSample, fFogFactor, fogCol );
+                            }
+                        }
+                        pRowPixels[i] = floorSample;
+                    }
+                    FillInSpan( pRowPixels, nRunLen, nFirstSkip, pRowShades );
+                    if (nRunLen > 0) {
+                        cDDrawer.DrawRowSpan( y, nRunStrtX, x - 1, fFloorDepth, pRowPixels, pRowShades );
+                    }
+                }
+            }
+        } );
+    }
+
+// ==============================/  deferred shading  /==============================
+
+    // With bDeferred, the walls, roofs, ceilings and floors are drawn with their texel colours, and the distance each pixel must be shaded with
+    // is put in the shade buffer of cDDrawer. ShadeFrame() then shades the whole frame in one pass, so that the sampling loops don't do the
+    // shading per pixel. The pixels in the fog are shaded as they're sampled, and so are the objects, which are drawn after ShadeFrame().
+    bool bDeferred   = RENDER_DEFERRED;
+    bool bDeferFrame = false;        // is the frame that's being rendered shaded deferred?
+
+    // Applies the shade formula of ShadePixel() to all pixels of the draw target that have a shade distance, and clears the shade buffer.
+    // The rows are divided over the render threads using an atomic counter.
+    void ShadeFrame() {
+        float fIntensity = fObjectIntensity;
+        float fMultiplier = fIntensityMultiplier;
+        olc::Pixel *pTarget = GetDrawTarget()->GetData();
+        std::atomic<int> nNextRow( 0 );
+        cRenderPool.Run( [&]( int nThread ) {
+            ThreadScratchRec &rScratch = vThreadScratch[ nThread ];
+            if ((int)rScratch.vSpanShades.size() < RenderWidth()) {
+                rScratch.vSpanShades.resize( std::max( RenderWidth(), RenderHeight()));
+            }
+            float *pFactors = rScratch.vSpanShades.data();
+
+            for (int y = nNextRow++; y < RenderHeight(); y = nNextRow++) {
+                float      *pShadeRow = cDDrawer.GetShadeRow( y );
+                olc::Pixel *pPixelRow = &pTarget[ y * RenderWidth() ];
+                // first the shade factors of the row are worked out, and then the pixels are multiplied by them. Both loops are
+                // without branches, so that they can be vectorised. A pixel without shade distance gets factor 1.0f, which leaves it as it is
+                for (int x = 0; x < RenderWidth(); x++) {
+                    float fDist   = pShadeRow[x];
+                    float fFactor = std::max( SHADE_FACTOR_MIN, std::min( SHADE_FACTOR_MAX, fIntensity * (fMultiplier / std::max( fDist, FLT_MIN ))));
+                    pFactors[x]   = (fDist > 0.0f && RENDER_SHADED) ? fFactor : 1.0f;
+                    pShadeRow[x]  = 0.0f;
+                }
+                for (int x = 0; x < RenderWidth(); x++) {
+                    olc::Pixel &p = pPixelRow[x];
+                    p.r = uint8_t( std::min( 255.0f, float( p.r ) * pFactors[x] ));
+                    p.g = uint8_t( std::min( 255.0f, float( p.g ) * pFactors[x] ));
+                    p.b = uint8_t( std::min( 255.0f, float( p.b ) * pFactors[x] ));
+                }
+            }
+        } );
+    }
+
+// ==============================/  update and render stages  /==============================
+
+    // The state of a frame that the render stage needs. The map cells and objects are not copied: the update stage doesn't change
+    // the maps while the render stage may be busy (see ScanMapCells()), and the objects are prepared for rendering (distance and
+    // angle to the player, sorted) when the snapshot is captured.
+    typedef struct sFrameSnapshotRec {
+        int   nMap;
+        float fPx, fPy, fPh;
+        float fPa_deg;
+        float fLU;
+        float fMaxDistance;
+    } FrameSnapshotRec;
+    FrameSnapshotRec sSnapshot;
+
+    // a map cell that needs an update, as found by ScanMapCells()
+    typedef struct sCellUpdateRec {
+        RC_MapCell *pMapCell;
+        int  nX, nY, nLayer;
+        bool bTrigger;           // should the state of its animated faces be set to nTestAnimState?
+    } CellUpdateRec;
+    std::vector<CellUpdateRec> vCellUpdates;
+    int nCellUpdatesMap = 0;     // the map these cells are in
+
+    // a portal transition of the player, as found by ScanMapCells()
+    typedef struct sTransitionRec {
+        bool  bPending = false;
+        int   nMap;
+        float fPx, fPy, fPh;
+        float fPa_deg;
+        float fLU;
+    } TransitionRec;
+    TransitionRec sTransition;
+
+    // Iterates over all the map cells in the active map, and collects the ones that need an update (dynamic map cells and map cells
+    // with animated faces) in vCellUpdates. If the player crossed a portal, this is recorded in sTransition.
+    // Nothing is changed here, so that this can run while the render stage renders the previous frame. The updates are applied
+    // by ApplyMapCellUpdates().
+    void ScanMapCells( bool bStateChanged ) {
+        // little lambda returns whether distance between b and c is <= a (note - sqrt not needed here)
+        auto within_distance = [=]( int a, int b, int c ) {
+            return (b * b + c * c) <= (a * a);
+        };
+        // the break out bool is needed in case a portal transition occurs, which should
+        // abruptly stop the updating since the player stepped into another map
+        bool bBreakOut = false;
+        vCellUpdates.clear();
+        nCellUpdatesMap = nActiveMap;
+        for (int h = 0; h < vMaps[ nActiveMap ].NrOfLayers() && !bBreakOut; h++) {
+            for (int y = 0; y < vMaps[ nActiveMap ].GetHeight() && !bBreakOut; y++) {
+                for (int x = 0; x < vMaps[ nActiveMap ].GetWidth() && !bBreakOut; x++) {
+
+                    // grab a pointer to the current map cell
+                    RC_MapCell *pMapCell = vMaps[ nActiveMap ].MapCellPtrAt( x, y, h );
+                    if (!pMapCell->IsEmpty()) {
+                        bool bNeedsUpdate = pMapCell->IsDynamic();
+                        bool bTrigger     = false;
+
+                        for (int i = 0; i < FACE_NR_OF && !bBreakOut; i++) {
+                            RC_Face *facePtr = pMapCell->GetFacePtr( i );
+                            if (facePtr->IsAnimated()) {
+                                bNeedsUpdate = true;
+                                // test code for manually changing state of animated faces - only trigger gate if close enough
+                                if (bStateChanged &&
+                                    within_distance( SENSE_RADIUS, x + 0.5f - fPlayerX, y + 0.5f - fPlayerY )) {
+                                    bTrigger = true;
+                                }
+                            } else if (facePtr->IsPortal()) {
+
+                                // check if player should cross over through the portal
+                                RC_FacePortal *portalFacePtr = (RC_FacePortal *)facePtr;
+                                if (
+                                    portalFacePtr->HasCrossedPortal(
+                                        fPlayerH_cached, fPlayerX_cached, fPlayerY_cached,
+                                        fPlayerH       , fPlayerX       , fPlayerY       ,
+                                        h              , x              , y
+                                    )
+                                ) {
+                                    // perform the cross over to the other side of the portal
+
+                                    // work out new view point angle (could be defected in portal)
+                                    float fExitAngle_deg = portalFacePtr->GetExitAngleDeg();     // angle of exit direction vector
+                                    float fToAngle_deg   = portalFacePtr->GetToAngle();          // orientation of other map
+                                    float fDiffAngle_deg = fToAngle_deg - fExitAngle_deg; // difference between those
+                                    float fVPAngle_deg   = fPlayerA_deg;                  // current view point angle
+
+                                    float fOtherVPA_deg = mod360( fVPAngle_deg + fDiffAngle_deg );
+
+                                    int nOtherMap = portalFacePtr->GetToMap();
+                                    int nOtherL   = portalFacePtr->GetToLevel();
+                                    int nOtherX   = portalFacePtr->GetToX();
+                                    int nOtherY   = portalFacePtr->GetToY();
+                                    float fOtherL = fPlayerH - int(fPlayerH) + nOtherL;
+                                    float fOtherX = fPlayerX - int(fPlayerX) + nOtherX;
+                                    float fOtherY = fPlayerY - int(fPlayerY) + nOtherY;
+
+                                    std::cout << "Map transition from map: " << nActiveMap
+                                                           << ", position (" << x
+                                                           << ", "           << y
+                                                           << ", "           << h
+                                                           << "), angle (deg): "   << fVPAngle_deg
+                                               << " to: " << nOtherMap
+                                                           << ", position (" << nOtherX
+                                                           << ", "           << nOtherY
+                                                           << ", "           << nOtherL
+                                                           << "), angle (deg): "   << fOtherVPA_deg
+                                               << std::endl;
+
+                                    int nCacheHorHght = ScreenHeight() * fPlayerH + (int)fPlayerLU;
+                                    sTransition.fLU   = fPlayerLU;
+                                    if (int(fPlayerH) != nOtherL) {   // the transition implies a layer change
+                                        // player moves vertically, compensate the fPlayerLU to keep horizon stable
+                                        sTransition.fLU = nCacheHorHght - float( ScreenHeight() * fOtherL );
+                                    }
+
+                                    // the player is moved when the updates are applied
+                                    sTransition.bPending = true;
+                                    sTransition.nMap     = nOtherMap;
+                                    sTransition.fPx      = fOtherX;
+                                    sTransition.fPy      = fOtherY;
+                                    sTransition.fPh      = fOtherL;
+                                    sTransition.fPa_deg  = fOtherVPA_deg;
+
+                                    bBreakOut = true;
+                                }
+                            }
+                        } // iterate faces
+                        if (bNeedsUpdate) {
+                            vCellUpdates.push_back( { pMapCell, x, y, h, bTrigger } );
+                        }
+                    } // else - block is empty, skip it
+                } // iterate x
+            } // iterate y
+        } // iterate layers
+    }
+
+    // applies the updates that ScanMapCells() found. This must not be called while the render stage is busy
+    void ApplyMapCellUpdates( float fElapsedTime ) {
+        for (auto &elt : vCellUpdates) {
+            // update this map cell (this will update all it's faces)
+            RC_MapCell *pMapCell = elt.pMapCell;
+            bool bTmp = pMapCell->IsPermeable();
+            float fCacheHeight = pMapCell->GetHeight();
+            pMapCell->Update( fElapsedTime, bTmp );
+            pMapCell->SetPermeable( bTmp );
+            // if the height of the map cell changed (dynamic map cells), let the map know
+            if (pMapCell->GetHeight() != fCacheHeight) {
+                vMaps[ nCellUpdatesMap ].SyncCellHeight( elt.nX, elt.nY, elt.nLayer );
+            }
+            if (elt.bTrigger) {
+                for (int i = 0; i < FACE_NR_OF; i++) {
+                    RC_Face *facePtr = pMapCell->GetFacePtr( i );
+                    if (facePtr->IsAnimated()) {
+                        // You must cast to RC_FaceAnimated * to get the function working properly...
+                        ((RC_FaceAnimated *)facePtr)->SetState( nTestAnimState );
+                    }
+                }
+            }
+        }
+        vCellUpdates.clear();
+
+        // carry out the map cell edit that was requested by the user
+        if (nEditCell != 0) {
+            EditAimedMapCell( nEditCell > 0 );
+            nEditCell = 0;
+        }
+
+        // move the player to the other side of the portal
+        if (sTransition.bPending) {
+            nActiveMap   = sTransition.nMap;
+            fMaxDistance = vMaps[ nActiveMap ].GetDrawDistance();
+            fPlayerH     = sTransition.fPh;
+            fPlayerX     = sTransition.fPx;
+            fPlayerY     = sTransition.fPy;
+            fPlayerA_deg = sTransition.fPa_deg;
+            fPlayerLU    = sTransition.fLU;
+            sTransition.bPending = false;
+        }
+    }
+
+    // Removes the wall block the player aims at (bPlace == false), or places one in the empty map cell in front of the face that the player
+    // aims at (bPlace == true). Only plain wall blocks ('#') are removed, and only empty map cells ('.') are filled. The map cell is swapped
+    // using ReplaceMapCellAt(), which keeps the height columns, distance fields, occupancy pyramid and boundary masks of the map in sync.
+    // NOTE: this must be called where the map cells may be changed, i.e. from ApplyMapCellUpdates()
+    void EditAimedMapCell( bool bPlace ) {
+        RayQuery sAim;
+        sAim.nMap     = nActiveMap;
+        sAim.nLayer   = int( fPlayerH );
+        sAim.fOrgX    = fPlayerX;
+        sAim.fOrgY    = fPlayerY;
+        sAim.fDirX    = lu_cos( fPlayerA_deg );
+        sAim.fDirY    = lu_sin( fPlayerA_deg );
+        sAim.fMaxDist = EDIT_CELL_MAX_DIST;
+        sAim.nFlags   = RAYQ_PASS_PERMEABLE;
+        RayQueryResult sAimResult;
+        if (!cRayQuery.CastRay( sAim, sAimResult ) || sAimResult.nLayer < 0 || sAimResult.nLayer >= vMaps[ nActiveMap ].NrOfLayers()) {
+            return;
+        }
+        RC_Map &rMap = vMaps[ nActiveMap ];
+        int nX = sAimResult.nCellX;
+        int nY = sAimResult.nCellY;
+        if (bPlace) {
+            // the map cell in front of the face that was hit
+            switch (sAimResult.nFaceHit) {
+                case FACE_EAST : nX += 1; break;
+                case FACE_WEST : nX -= 1; break;
+                case FACE_SOUTH: nY += 1; break;
+                case FACE_NORTH: nY -= 1; break;
+                default: return;
+            }
+            // don't wall in the player
+            if (!rMap.IsInBounds( nX, nY ) || (nX == int( fPlayerX ) && nY == int( fPlayerY ))) {
+                return;
+            }
+            if (rMap.CellValueAt( nX, nY, sAimResult.nLayer ) == '.') {
+                rMap.ReplaceMapCellAt( nX, nY, sAimResult.nLayer, '#' );
+            }
+        } else if (rMap.CellValueAt( nX, nY, sAimResult.nLayer ) == '#') {
+            rMap.ReplaceMapCellAt( nX, nY, sAimResult.nLayer, '.' );
+        }
+    }
+
+    // update all objects in active map
+    void UpdateObjects( float fElapsedTime ) {
+        for (auto &elt : vMaps[nActiveMap].vListObjects) {
+            elt.Update( &vMaps[ nActiveMap ], fElapsedTime );
+        }
+    }
+
+    // fills snapshot rSnap from the current state
+    void CaptureSnapshot( FrameSnapshotRec &rSnap ) {
+        rSnap.nMap         = nActiveMap;
+        rSnap.fPx          = fPlayerX;
+        rSnap.fPy          = fPlayerY;
+        rSnap.fPh          = fPlayerH;
+        rSnap.fPa_deg      = fPlayerA_deg;
+        rSnap.fLU          = fPlayerLU;
+        rSnap.fMaxDistance = fMaxDistance;
+
+        // the object rendering is split into two phases so that it can be sorted on distance (painters algo) before rendering
+
+        // phase 1 - just determine distance (and angle cause of convenience)
+        for (auto &object : vMaps[ rSnap.nMap ].vListObjects) {
+
+            // work out distance and angle between object and player, and
+            // store it in the object itself
+            object.PrepareRender( rSnap.fPx, rSnap.fPy, rSnap.fPa_deg );
+        }
+
+        // sort farthest object first (for painters algo)
+        vMaps[ rSnap.nMap ].vListObjects.sort(
+            [=]( RC_Object &a, RC_Object &b ) {
+                return a.GetDistToPlayer() > b.GetDistToPlayer();
+            }
+        );
+    }
+
+    // Renders the walls and objects of snapshot rSnap. When the stages are pipelined, this runs on a thread of cStagePool while the
+    // update stage runs on the main thread, so only the snapshot must be used here - not the player variables.
+    void RenderStage( const FrameSnapshotRec &rSnap ) {
+
+        // the scene is rendered at the render resolution, and upscaled to the screen at the end
+        SetDrawTarget( pRenderSprite );
+
+        // WALL RENDERING (aka BACK GROUND SCENE rendering)
+        // ==============
+
+        // typically, the horizon height is halfway the screen height. However, you have to offset with look up value,
+        // and the viewpoint of the player is variable too (since flying and crouching). The look up value is in screen pixels
+        int nHorizonHeight = RenderHeight() * rSnap.fPh + int( rSnap.fLU * float( RenderHeight()) / float( ScreenHeight()));
+
+        // having set the horizon height, determine the cos of all the angles through each of the pixels in this slice
+        std::vector<float> fHeightAngleCos( RenderHeight() );
+        for (int y = 0; y < RenderHeight(); y++) {
+            fHeightAngleCos[y] = std::abs( lu_cos( (y - nHorizonHeight) * fAnglePerPixel_deg ));
+        }
+
+        // with interleaved columns, only half of the columns are rendered if the previous frame can be reprojected into the other half
+        bool bInterleavedFrame = bInterleaved && !bProgressive && CanReproject( rSnap );
+        if (bInterleavedFrame) {
+            nInterleaveParity = 1 - nInterleaveParity;
+        }
+        nColumnStep = bInterleavedFrame ? 2 : 1;
+        nColumnsRerendered = 0;
+
+        // with deferred shading, the walls and flats are drawn unshaded, and ShadeFrame() shades them before the objects are drawn
+        bDeferFrame = bDeferred && !bProgressive;
+        cDDrawer.EnableShadeBuffer( bDeferFrame );
+
+        // start a new pass over the screen if the previous one is finished
+        if (dSliceQueue.empty()) {
+
+            // sub slice queue got empty, fill it
+            // the camera ray table is only rebuilt if the player turned since the last time
+            UpdateCameraRays( rSnap.fPa_deg );
+            // drop the cached rays that are affected by map changes
+            ValidateRayCache();
+            for (auto &elt : vThreadScratch) {
+                elt.nRaysCast      = 0;
+                elt.nRaysFilledIn  = 0;
+                elt.nHitsProcessed = 0;
+                elt.nHitsRendered  = 0;
+            }
+            // iterate over all screen slices, processing the screen in columns. For progressive rendering the columns are queued from
+            // the center of the screen outwards, so that the center is updated first if the budget runs out
+            for (int i = 0; i < RenderWidth(); i++) {
+                int x = i;
+                if (bProgressive) {
+                    x = (RenderWidth() / 2) + ((i % 2 == 0) ? i / 2 : -(i + 1) / 2);
+                    vColumnPending[x] = 1;
+                } else if (bInterleavedFrame && IsReprojectedColumn( x )) {
+                    continue;
+                }
+                float fViewAngle_deg = vCameraRays[x].fViewAngle_deg;
+                float fCurAngle_deg  = vCameraRays[x].fCurAngle_deg;
+
+                // enqueue the inital slices
+                SubSliceRec tmp = {
+                    fViewAngle_deg, fCurAngle_deg, rSnap.fPa_deg,
+                    rSnap.nMap, rSnap.fPx, rSnap.fPy, rSnap.fPh,
+                    0.0f,
+                    x, 0, RenderHeight() - 1,
+                    nHorizonHeight,
+                    true
+                };
+                dSliceQueue.push( tmp );
+            }
+            nColumnsDone = 0;
+        }
+
+        bFloorRowPass = RENDER_FLOOR_ROWS && !bProgressive;
+        if (!bProgressive) {
+            // process the slice queue until it's empty, using all render threads, and then fill in the floor
+            RenderSlicesParallel( dSliceQueue, fHeightAngleCos );
+            if (bInterleavedFrame) {
+                // fill the other columns from the previous frame, and render the ones that can't be filled
+                ReprojectColumns( rSnap, nHorizonHeight, fHeightAngleCos, dSliceQueue );
+                RenderSlicesParallel( dSliceQueue, fHeightAngleCos );
+                nColumnStep = 1;
+            }
+            if (bFloorRowPass) {
+                RenderFloorRows( rSnap.nMap, rSnap.fPx, rSnap.fPy, rSnap.fPh, nHorizonHeight );
+            }
+            if (bDeferFrame) {
+                ShadeFrame();
+            }
+            // keep the scene (without the objects) for the next frame
+            if (bInterleaved) {
+                StoreHistory( rSnap, nHorizonHeight, fHeightAngleCos );
+            }
+        } else {
+            // process the slice queue until it's empty or the budget is spent - at least one sub slice is rendered per frame.
+            // Since the queue is FIFO, all first level sub slices are rendered before the sub slices seen through portals
+            SetDrawTarget( pWorkSprite );
+            auto tStart = std::chrono::steady_clock::now();
+            bool bBudgetLeft = true;
+            while (!dSliceQueue.empty() && bBudgetLeft) {
+
+                SubSliceRec &curSubSlice = dSliceQueue.front();
+                nActiveSlice = curSubSlice.nSlice;
+                if (curSubSlice.bResetSlice) {
+                    cDDrawer.Reset( nActiveSlice, curSubSlice.nStrtY, curSubSlice.nStopY );
+                }
+                int nCacheSize = dSliceQueue.size();
+                RenderSubSlice( dSliceQueue, fHeightAngleCos );
+                // one sub slice was taken from the queue, and the ones that were spawned are added to it
+                vColumnPending[ nActiveSlice ] += dSliceQueue.size() - nCacheSize;
+                if (vColumnPending[ nActiveSlice ] == 0) {
+                    // this column is complete: make it visible
+                    for (int y = 0; y < RenderHeight(); y++) {
+                        pSceneSprite->SetPixel( nActiveSlice, y, pWorkSprite->GetPixel( nActiveSlice, y ));
+                    }
+                    cSceneDDrawer.CopyFrom( cDDrawer, nActiveSlice );
+                    nColumnsDone += 1;
+                }
+                bBudgetLeft = std::chrono::duration<float, std::milli>( std::chrono::steady_clock::now() - tStart ).count() < fFrameBudget_ms;
+            }
+            SetDrawTarget( pRenderSprite );
+            // show the scene, and let the objects be drawn against its depth buffer
+            DrawSprite( 0, 0, pSceneSprite );
+            cFrameDDrawer.CopyFrom( cSceneDDrawer );
+        }
+        if (bProgressive || !bInterleaved) {
+            bHistValid = false;
+        }
+        // the progressive rendering is done on the calling thread, collect its minimap rays
+        vRayList.insert( vRayList.end(), vThreadScratch[0].vRayList.begin(), vThreadScratch[0].vRayList.end());
+        vThreadScratch[0].vRayList.clear();
+
+
+        // OBJECT RENDERING
+        // ================
+
+        // display all objects after the background rendering and before displaying the minimap or debugging output
+        // they were sorted on distance (painters algo) when the snapshot was captured
+
+        // phase 2: render object - objects fade into the fog of the map the same way the scene does
+        RC_Map &rObjMap = vMaps[ rSnap.nMap ];
+        bool       bObjFog     = rObjMap.HasFog();
+        float      fObjFogStrt = rSnap.fMaxDistance * FOG_START_FACTOR;
+        olc::Pixel objFogCol   = rObjMap.GetFogColour();
+        for (auto &object : rObjMap.vListObjects) {
+            object.Render( bProgressive ? cFrameDDrawer : cDDrawer, rSnap.fPh, fPlayerFoV_rad, rSnap.fMaxDistance, nHorizonHeight, bObjFog, fObjFogStrt, objFogCol );
+        }
+        UpscaleRender();
+    }
+
+// ==============================/  temporal column interleaving  /==============================
+
+    // With bInterleaved, only the even or the odd screen columns are rendered each frame (alternating). The other columns are reprojected
+    // from the scene of the previous frame (the walls and floors, without the objects), using its depth buffer and the pose it was rendered
+    // for. Columns that get holes this way (disocclusions) are rendered after all, and so are the columns that show map cells that
+    // changed height since the previous frame. If the player moved or turned too much since the previous frame, or went into another
+    // map, the complete frame is rendered.
+    bool bInterleaved = RENDER_INTERLEAVED;
+    int  nColumnStep  = 1;                    // 2 while a frame renders every other column, see GetCachedHitLists()
+    int  nInterleaveParity = 0;               // the columns x with (x & 1) == nInterleaveParity are rendered in this frame
+    int  nColumnsRerendered = 0;              // nr of reprojected columns that had to be rendered after all, in this frame
+    std::vector<bool> vColumnForced;          // columns that must be rendered, since they show map cells that changed (see CanReproject())
+
+    olc::Sprite     *pHistSprite = nullptr;   // the scene of the previous frame ...
+    RC_DepthDrawer   cHistDDrawer;            // ... its depth buffer ...
+    std::vector<float> vHistHeightAngleCos;   // ... the vertical angle cosines it was rendered with ...
+    FrameSnapshotRec sHistSnap;               // ... and the pose it was rendered for
+    int  nHistHorHght = 0;
+    int  nHistChangeCount = 0;                // change count of the map when it was rendered
+    bool bHistValid   = false;
+
+    // returns whether the scene of the previous frame can be reprojected for snapshot rSnap. If so, the columns that show map cells
+    // that changed height since then are flagged in vColumnForced
+    bool CanReproject( const FrameSnapshotRec &rSnap ) {
+        if (!bHistValid || sHistSnap.nMap != rSnap.nMap) {
+            return false;
+        }
+        float fDX = rSnap.fPx - sHistSnap.fPx;
+        float fDY = rSnap.fPy - sHistSnap.fPy;
+        float fDH = rSnap.fPh - sHistSnap.fPh;
+        if (sqrt( fDX * fDX + fDY * fDY + fDH * fDH ) >= INTERLEAVE_MAX_MOVE ||
+            std::abs( mod360( rSnap.fPa_deg - sHistSnap.fPa_deg, -180.0f )) >= INTERLEAVE_MAX_TURN) {
+            return false;
+        }
+        RC_Map &rMap = vMaps[ rSnap.nMap ];
+        if (!rMap.GetChangedCells( nHistChangeCount, vChangedCells )) {
+            return false;
+        }
+        vColumnForced.assign( RenderWidth(), false );
+        for (auto &elt : vChangedCells) {
+            int nCellX = elt % rMap.GetWidth();
+            int nCellY = elt / rMap.GetWidth();
+            if (int( rSnap.fPx ) == nCellX && int( rSnap.fPy ) == nCellY) {
+                return false;
+            }
+            // the view angles of the corners of the cell (relative to its center, so that they don't wrap around) give the columns it covers
+            float fCenterA_deg = rad2deg( atan2f( float( nCellY ) + 0.5f - rSnap.fPy, float( nCellX ) + 0.5f - rSnap.fPx ));
+            float fMinA_deg = FLT_MAX, fMaxA_deg = -FLT_MAX;
+            for (int c = 0; c < 4; c++) {
+                float fCornerA_deg = rad2deg( atan2f( float( nCellY + c / 2 ) - rSnap.fPy, float( nCellX + c % 2 ) - rSnap.fPx ));
+                float fRelA_deg = mod360( fCornerA_deg - fCenterA_deg, -180.0f );
+                fMinA_deg = std::min( fMinA_deg, fRelA_deg );
+                fMaxA_deg = std::max( fMaxA_deg, fRelA_deg );
+            }
+            float fCenterView_deg = mod360( fCenterA_deg - rSnap.fPa_deg, -180.0f );
+            int nLeftX  = int( std::floor( float( RenderWidth() / 2 ) + (fCenterView_deg + fMinA_deg) / fAnglePerPixel_deg )) - 1;
+            int nRightX = int( std::ceil(  float( RenderWidth() / 2 ) + (fCenterView_deg + fMaxA_deg) / fAnglePerPixel_deg )) + 1;
+            for (int x = std::max( nLeftX, 0 ); x <= std::min( nRightX, RenderWidth() - 1 ); x++) {
+                vColumnForced[x] = true;
+            }
+        }
+        return true;
+    }
+
+    // returns whether screen column x is reprojected (instead of rendered) in an interleaved frame
+    bool IsReprojectedColumn( int x ) {
+        return (x & 1) != nInterleaveParity && !vColumnForced[x];
+    }
+
+    // keeps the scene that was just rendered for snapshot rSnap, for the reprojection in the next frame
+    void StoreHistory( const FrameSnapshotRec &rSnap, int nHorHght, std::vector<float> &vDownAngleCos ) {
+        std::copy( GetDrawTarget()->GetData(), GetDrawTarget()->GetData() + RenderWidth() * RenderHeight(), pHistSprite->GetData());
+        cHistDDrawer.CopyFrom( cDDrawer );
+        vHistHeightAngleCos = vDownAngleCos;
+        sHistSnap    = rSnap;
+        nHistHorHght = nHorHght;
+        nHistChangeCount = vMaps[ rSnap.nMap ].GetChangeCount();
+        bHistValid   = true;
+    }
+
+    // Reprojects the scene of the previous frame into the columns that are not rendered in this frame. Each pixel is moved to where it's
+    // seen from the pose of rSnap:
+    //   * the walls, roofs and ceilings (the pixels with a depth before the background) using their depth
+    //   * the floor that RenderSubSlice() drew (e.g. seen through a portal) as a point on the floor plane, since its depth is the background's
+    //   * the sky only depends on the view direction
+    // The floor that RenderFloorRows() drew is not reprojected, it's rendered anyway. Adjacent pixels of the same surface are stretched to
+    // close the gaps between them.
+    // Afterwards each reprojected pixel that is left empty is checked against the rendered columns on both sides of it:
+    //   * if both neighbours are walls etc., it's a hole (something became visible that wasn't in the previous frame) - the column
+    //     is pushed on dSliceQ to be rendered after all
+    //   * otherwise it takes over the background neighbour (sky or floor), or it's left to RenderFloorRows()
+    void ReprojectColumns( const FrameSnapshotRec &rSnap, int nHorHght, std::vector<float> &vDownAngleCos, SliceQueue &dSliceQ ) {
+        int   nW = RenderWidth(), nH = RenderHeight();
+        float fWellAway = fMaxDistance + 1000.0f;
+        float fCurA_rad = deg2rad( rSnap.fPa_deg );
+        float fCurCos   = cos( fCurA_rad ), fCurSin = sin( fCurA_rad );
+        for (int x = 0; x < nW; x++) {
+            if (IsReprojectedColumn( x )) {
+                cDDrawer.Reset( x, 0, nH - 1 );
+            }
+        }
+
+        // lambda to work out where the point at (corrected) distance fCorrDist in row nSrcY of the previous frame is on screen now,
+        // for the column with direction (fSrcDirX, fSrcDirY). Returns false if it's behind the player or off screen
+        auto reproject = [&]( int nSrcY, float fCorrDist, float fSrcDirX, float fSrcDirY, float fSrcViewCos, int &nX, int &nY, float &fNewCorrDist ) {
+            // the world position and the height of the point
+            float fDist   = fCorrDist / fSrcViewCos;
+            float fWorldX = sHistSnap.fPx + fDist * fSrcDirX;
+            float fWorldY = sHistSnap.fPy + fDist * fSrcDirY;
+            float fWorldZ = sHistSnap.fPh - float( nSrcY - nHistHorHght ) * fCorrDist / fDistToProjPlane;
+            // project it from the current pose - the screen columns are linear in the view angle
+            float fDX = fWorldX - rSnap.fPx;
+            float fDY = fWorldY - rSnap.fPy;
+            fNewCorrDist = fDX * fCurCos + fDY * fCurSin;
+            if (fNewCorrDist <= 0.01f) {
+                return false;
+            }
+            float fViewAngle_deg = mod360( rad2deg( atan2f( fDY, fDX )) - rSnap.fPa_deg, -180.0f );
+            nX = int( std::round( float( nW / 2 ) + fViewAngle_deg / fAnglePerPixel_deg ));
+            nY = int( std::round( float( nHorHght ) + (rSnap.fPh - fWorldZ) * fDistToProjPlane / fNewCorrDist ));
+            return nX >= 0 && nX < nW && nY >= 0 && nY < nH;
+        };
+
+        for (int nSrcX = 0; nSrcX < nW; nSrcX++) {
+            float fSrcViewAngle_deg = float( nSrcX - (nW / 2)) * fAnglePerPixel_deg;
+            float fSrcA_rad   = deg2rad( sHistSnap.fPa_deg + fSrcViewAngle_deg );
+            float fSrcDirX    = cos( fSrcA_rad );
+            float fSrcDirY    = sin( fSrcA_rad );
+            float fSrcViewCos = cos( deg2rad( fSrcViewAngle_deg ));
+            // the sky in this column shifts over the difference in view angle and horizon height
+            int nSkyX = int( std::round( float( nW / 2 ) + mod360( sHistSnap.fPa_deg + fSrcViewAngle_deg - rSnap.fPa_deg, -180.0f ) / fAnglePerPixel_deg ));
+
+            bool  bPrevValid = false;     // the pixel above this one was reprojected into column nPrevX, row nPrevY
+            int   nPrevX = 0, nPrevY = 0;
+            float fPrevCorrDist = 0.0f;
+            for (int nSrcY = 0; nSrcY < nH; nSrcY++) {
+                float fDepth = cHistDDrawer.GetDepthRow( nSrcY )[ nSrcX ];
+                bool  bSky   = false;
+                int   nX = 0, nY = 0;
+                float fCorrDist = 0.0f, fNewCorrDist = 0.0f;
+                bool  bValid = false;
+                if (fDepth < fWellAway) {
+                    // wall, roof or ceiling
+                    fCorrDist = fDepth * vHistHeightAngleCos[ nSrcY ];
+                    bValid    = reproject( nSrcY, fCorrDist, fSrcDirX, fSrcDirY, fSrcViewCos, nX, nY, fNewCorrDist );
+                } else if (fDepth == fWellAway && nSrcY > nHistHorHght) {
+                    // floor
+                    fCorrDist = sHistSnap.fPh * fDistToProjPlane / float( nSrcY - nHistHorHght );
+                    bValid    = reproject( nSrcY, fCorrDist, fSrcDirX, fSrcDirY, fSrcViewCos, nX, nY, fNewCorrDist );
+                } else if (fDepth == fWellAway) {
+                    // sky
+                    bSky   = true;
+                    nX     = nSkyX;
+                    nY     = nSrcY - nHistHorHght + nHorHght;
+                    bValid = nX >= 0 && nX < nW && nY >= 0 && nY < nH;
+                }
+                if (bValid && IsReprojectedColumn( nX )) {
+                    olc::Pixel p = pHistSprite->GetPixel( nSrcX, nSrcY );
+                    // if the pixel above is on the same surface, stretch this pixel up to it
+                    int nFromY = nY;
+                    if (bPrevValid && !bSky && nPrevX == nX && nPrevY < nY &&
+                        std::abs( fCorrDist - fPrevCorrDist ) <= INTERLEAVE_SAME_SURFACE * fCorrDist) {
+                        nFromY = nPrevY + 1;
+                    }
+                    cDDrawer.FillColumnSpan( nX, nFromY, nY, (fDepth < fWellAway) ? fNewCorrDist / vDownAngleCos[ nY ] : fWellAway, p );
+                }
+                bPrevValid    = bValid && !bSky;
+                nPrevX        = nX;
+                nPrevY        = nY;
+                fPrevCorrDist = fCorrDist;
+            }
+        }
+
+        // check the reprojected columns for holes
+        nColumnsRerendered = 0;
+        for (int x = 0; x < nW; x++) {
+            if (!IsReprojectedColumn( x )) {
+                continue;
+            }
+            bool bHole = false;
+            for (int y = 0; y < nH && !bHole; y++) {
+                const float *pDepthRow = cDDrawer.GetDepthRow( y );
+                if (pDepthRow[x] != FLT_MAX) {
+                    continue;
+                }
+                // the depths of the neighbours - at the edges of the screen, the one neighbour is used twice
+                int nLeftX  = (x > 0     ) ? x - 1 : x + 1;
+                int nRightX = (x < nW - 1) ? x + 1 : x - 1;
+                bool bLeftBg  = pDepthRow[ nLeftX  ] >= fWellAway;
+                bool bRightBg = pDepthRow[ nRightX ] >= fWellAway;
+                if (!bLeftBg && !bRightBg) {
+                    bHole = true;
+                } else if (pDepthRow[ nLeftX ] != FLT_MAX && pDepthRow[ nRightX ] != FLT_MAX) {
+                    // take over the background neighbour. If a neighbour is floor that still has to be rendered, this pixel is left to it too
+                    int nFromX = bLeftBg ? nLeftX : nRightX;
+                    float fShadeDist = cDDrawer.HasShadeBuffer() ? cDDrawer.GetShadeRow( y )[ nFromX ] : 0.0f;
+                    cDDrawer.Draw( pDepthRow[ nFromX ], x, y, GetDrawTarget()->GetPixel( nFromX, y ), fShadeDist );
+                }
+            }
+            if (bHole) {
+                // render this column after all
+                SubSliceRec tmp = {
+                    vCameraRays[x].fViewAngle_deg, vCameraRays[x].fCurAngle_deg, rSnap.fPa_deg,
+                    rSnap.nMap, rSnap.fPx, rSnap.fPy, rSnap.fPh,
+                    0.0f,
+                    x, 0, nH - 1,
+                    nHorHght,
+                    true
+                };
+                dSliceQ.push( tmp );
+                nColumnsRerendered += 1;
+            }
+        }
+    }
+
+// ==============================/  render resolution  /==============================
+
+    // The scene is rendered into pRenderSprite at the render resolution, which can be lower than the screen resolution, and then
+    // upscaled to the screen (see UpscaleRender()). The HUDs, the minimap and the test lines are drawn at the screen resolution.
+    // With bDynamicRes, the render resolution follows from the measured frame time (see UpdateRenderScale()). It's only changed
+    // between frames, when the render stage isn't running.
+    bool  bDynamicRes   = DYNAMIC_RESOLUTION;
+    float fRenderScale  = 1.0f;               // render resolution as a fraction of the screen resolution
+    float fAvgFrame_ms  = 0.0f;               // smoothed frame time
+    int   nSettleFrames = 0;                  // nr of frames to wait before the frame time is evaluated again
+    int   nRenderW = 0, nRenderH = 0;
+    olc::Sprite *pRenderSprite = nullptr;
+    std::vector<int> vUpscaleX;               // per screen column: the render column it shows
+
+    int RenderWidth() {  return nRenderW; }
+    int RenderHeight() { return nRenderH; }
+
+    // Sets the render resolution to nW x nH pixels, and rebuilds everything that depends on it: the projection, the sprites, the depth
+    // drawers and the per column tables. The ray cache, the interleaving history and a progressive pass that was busy are dropped.
+    void SetRenderResolution( int nW, int nH ) {
+        if (nW == nRenderW && nH == nRenderH) {
+            return;
+        }
+        nRenderW = nW;
+        nRenderH = nH;
+        // Work out distance to projection plane, depending on the width of the projection plane and the field of view.
+        fDistToProjPlane = ((RenderWidth() / 2.0f) / lu_sin( fPlayerFoV_deg / 2.0f )) * lu_cos( fPlayerFoV_deg / 2.0f );
+        // determine how much degrees one pixel shift represents.
+        fAnglePerPixel_deg = fPlayerFoV_deg / float( RenderWidth());
+
+        // the render target, the depth drawers and the buffers for progressive rendering and interleaving
+        delete pRenderSprite;
+        delete pWorkSprite;
+        delete pSceneSprite;
+        delete pHistSprite;
+        pRenderSprite = new olc::Sprite( RenderWidth(), RenderHeight());
+        pWorkSprite   = new olc::Sprite( RenderWidth(), RenderHeight());
+        pSceneSprite  = new olc::Sprite( RenderWidth(), RenderHeight());
+        pHistSprite   = new olc::Sprite( RenderWidth(), RenderHeight());
+        cDDrawer.Init(      this, RenderWidth(), RenderHeight());
+        cSceneDDrawer.Init( this, RenderWidth(), RenderHeight());
+        cSceneDDrawer.Reset();
+        cFrameDDrawer.Init( this, RenderWidth(), RenderHeight());
+        cHistDDrawer.Init(  this, RenderWidth(), RenderHeight());
+        bHistValid = false;
+        while (!dSliceQueue.empty()) {
+            dSliceQueue.pop();
+        }
+        vColumnPending.assign( RenderWidth(), 0 );
+        nColumnsDone = 0;
+
+        // one ray cache record per render column for the first level rays. The camera ray table is rebuilt in the next frame, since its
+        // width doesn't match anymore
+        vRayCache.assign( RenderWidth(), RayCacheRec());
+        vUpscaleX.resize( ScreenWidth());
+        for (int x = 0; x < ScreenWidth(); x++) {
+            vUpscaleX[x] = x * RenderWidth() / ScreenWidth();
+        }
+    }
+
+    // Copies the scene from pRenderSprite to the screen, scaling it up (nearest neighbour) if the render resolution is lower.
+    // Screen rows that show the same render row as the row above them are copied from that row.
+    void UpscaleRender() {
+        SetDrawTarget( nullptr );
+        olc::Pixel *pSrc = pRenderSprite->GetData();
+        olc::Pixel *pDst = GetDrawTarget()->GetData();
+        if (RenderWidth() == ScreenWidth() && RenderHeight() == ScreenHeight()) {
+            std::copy( pSrc, pSrc + RenderWidth() * RenderHeight(), pDst );
+            return;
+        }
+        int nPrevSrcY = -1;
+        for (int y = 0; y < ScreenHeight(); y++) {
+            int nSrcY = y * RenderHeight() / ScreenHeight();
+            olc::Pixel *pDstRow = pDst + y * ScreenWidth();
+            if (nSrcY == nPrevSrcY) {
+                std::copy( pDstRow - ScreenWidth(), pDstRow, pDstRow );
+            } else {
+                olc::Pixel *pSrcRow = pSrc + nSrcY * RenderWidth();
+                for (int x = 0; x < ScreenWidth(); x++) {
+                    pDstRow[x] = pSrcRow[ vUpscaleX[x] ];
+                }
+            }
+            nPrevSrcY = nSrcY;
+        }
+    }
+
+    // The controller of the dynamic resolution. The frame time is smoothed and compared to the budget. Since the render time is about
+    // proportional to the nr of pixels, the scale that meets the budget is the current scale times the square root of budget / frame
+    // time. It's only applied if it differs enough from the current scale, and after a change the frame time gets some frames to settle.
+    // Without bDynamicRes the screen resolution is restored.
+    void UpdateRenderScale( float fElapsedTime ) {
+        float fScale = 1.0f;
+        if (bDynamicRes) {
+            float fFrame_ms = fElapsedTime * 1000.0f;
+            fAvgFrame_ms = (fAvgFrame_ms == 0.0f) ? fFrame_ms : 0.9f * fAvgFrame_ms + 0.1f * fFrame_ms;
+            if (nSettleFrames > 0) {
+                nSettleFrames -= 1;
+                return;
+            }
+            fScale = fRenderScale * sqrt( RESOLUTION_BUDGET_MS / std::max( fAvgFrame_ms, 0.1f ));
+            fScale = std::min( 1.0f, std::max( RESOLUTION_MIN_SCALE, fScale ));
+            if (std::abs( fScale - fRenderScale ) < RESOLUTION_MIN_STEP) {
+                return;
+            }
+        }
+        if (fScale != fRenderScale) {
+            fRenderScale  = fScale;
+            fAvgFrame_ms  = 0.0f;
+            nSettleFrames = RESOLUTION_SETTLE;
+            SetRenderResolution( std::max( 1, int( float( ScreenWidth()) * fRenderScale )), std::max( 1, int( float( ScreenHeight()) * fRenderScale )));
+        }
+    }
+
+// ==============================/  game loop  /==============================
+
+    // this var is used to keep track of door opening or closing
+    int nTestAnimState = ANIM_STATE_CLOSED;
+    // pending map cell edit: +1 = place a wall block, -1 = remove one, 0 = none (see EditAimedMapCell())
+    int nEditCell = 0;
+
+    bool OnUserUpdate( float fElapsedTime ) override {
+
+        // step 1 - user input
+        // ===================
+
+        nFrameCntr += 1;
+
+        // update cached versions of player coordinates
+        fPlayerX_cached = fPlayerX;
+        fPlayerY_cached = fPlayerY;
+        fPlayerH_cached = fPlayerH;
+
+        // For all movements and rotation you can speed up by keeping SHIFT pressed
+        // or speed down by keeping CTRL pressed. This also affects shading/lighting
+        float fSpeedUp = 1.0f;
+        if (GetKey( olc::SHIFT ).bHeld) fSpeedUp = 3.0f;
+        if (GetKey( olc::CTRL  ).bHeld) fSpeedUp = 0.2f;
+
+        // set test mode and test slice values
+        bTestMode |= GetKey( olc::Key::T ).bPressed;
+        if (GetKey( olc::Key::F1 ).bHeld) fTestSlice = std::max( fTestSlice - 40.0f * fElapsedTime * fSpeedUp,                 0.0f );
+        if (GetKey( olc::Key::F2 ).bHeld) fTestSlice = std::min( fTestSlice + 40.0f * fElapsedTime * fSpeedUp, ScreenWidth() - 1.0f );
+
+        // toggle progressive rendering, and control its time budget per frame
+        if (GetKey( olc::Y ).bPressed) {
+            bProgressive = !bProgressive;
+            // a pass that was started in the other mode is dropped
+            while (!dSliceQueue.empty()) {
+                dSliceQueue.pop();
+            }
+        }
+        if (GetKey( olc::Key::F4 ).bPressed) { fFrameBudget_ms += 1.0f;                                                 }
+        if (GetKey( olc::Key::F3 ).bPressed) { fFrameBudget_ms = std::max( PROGRESSIVE_BUDGET_MIN, fFrameBudget_ms - 1.0f ); }
+        // toggle pipelining of the update and render stage
+        if (GetKey( olc::L ).bPressed) bPipelined = !bPipelined;
+        // toggle reduced rate rendering of the horizontal surfaces
+        if (GetKey( olc::C ).bPressed) bHalfRateFlats = !bHalfRateFlats;
+        // toggle interleaved column rendering
+        if (GetKey( olc::N ).bPressed) bInterleaved = !bInterleaved;
+        // toggle the dynamic render resolution
+        if (GetKey( olc::X ).bPressed) bDynamicRes = !bDynamicRes;
+        // toggle the deferred shading
+        if (GetKey( olc::M ).bPressed) bDeferred = !bDeferred;
+        // remove the wall block the player aims at, or place one in front of it (this is carried out in ApplyMapCellUpdates())
+        if (GetKey( olc::Z ).bPressed) nEditCell = -1;
+        if (GetKey( olc::F ).bPressed) nEditCell = +1;
+
+        // reset look up value and player height on pressing 'R'
+        if (GetKey( olc::R ).bReleased) { fPlayerH = 0.5f; fPlayerLU = 0.0f; }
+
+        // toggles for HUDs
+        if (GetKey( olc::U ).bPressed) bProcessInfo = !bProcessInfo;
+        if (GetKey( olc::I ).bPressed) bPlayerInfo  = !bPlayerInfo;
+        if (GetKey( olc::P ).bPressed) bMinimap     = !bMinimap;
+        if (GetKey( olc::O ).bPressed) bMapRays     = !bMapRays;
+        // toggles for on screen orientation lines
+        if (GetKey( olc::G ).bPressed) bTestSlice   = !bTestSlice;
+        if (GetKey( olc::H ).bPressed) bTestGrid    = !bTestGrid;
+        // run the benchmarks on pressing 'B' (DDA scaling), 'V' (ray queries) or 'K' (portal rendering) - output to console
+        if (GetKey( olc::B ).bPressed) RunScalingBenchmark( BENCH_MAX_MAP_SIZE_UI );
+        if (GetKey( olc::V ).bPressed) RunRayQueryBenchmark();
+        if (GetKey( olc::K ).bPressed) RunPortalBenchmark();
+        // toggle the adaptive column subdivision (the output is the same, only the nr of rays that are cast differs)
+        if (GetKey( olc::J ).bPressed) bAdaptiveColumns = !bAdaptiveColumns;
+
+        // Rotate - collision detection not necessary. Keep fPlayerA_deg between 0 and 360 degrees
+        if (GetKey( olc::D ).bHeld) { fPlayerA_deg += SPEED_ROTATE * fSpeedUp * fElapsedTime; if (fPlayerA_deg >= 360.0f) fPlayerA_deg -= 360.0f; }
+        if (GetKey( olc::A ).bHeld) { fPlayerA_deg -= SPEED_ROTATE * fSpeedUp * fElapsedTime; if (fPlayerA_deg <    0.0f) fPlayerA_deg += 360.0f; }
+        // Rotate to discrete angle
+        if (GetKey( olc::NP6 ).bPressed) { fPlayerA_deg =   0.0f; }
+        if (GetKey( olc::NP3 ).bPressed) { fPlayerA_deg =  45.0f; }
+        if (GetKey( olc::NP2 ).bPressed) { fPlayerA_deg =  90.0f; }
+        if (GetKey( olc::NP1 ).bPressed) { fPlayerA_deg = 135.0f; }
+        if (GetKey( olc::NP4 ).bPressed) { fPlayerA_deg = 180.0f; }
+        if (GetKey( olc::NP7 ).bPressed) { fPlayerA_deg = 225.0f; }
+        if (GetKey( olc::NP8 ).bPressed) { fPlayerA_deg = 270.0f; }
+        if (GetKey( olc::NP9 ).bPressed) { fPlayerA_deg = 315.0f; }
+
+        // variables used for collision detection - work out the new location in a separate coordinate pair, and only alter
+        // the players coordinate if there's no collision
+        float fNewX = fPlayerX;
+        float fNewY = fPlayerY;
+
+        // walking forward, backward and strafing left, right
+        if (GetKey( olc::W ).bHeld) { fNewX += lu_cos( fPlayerA_deg ) * SPEED_MOVE   * fSpeedUp * fElapsedTime; fNewY += lu_sin( fPlayerA_deg ) * SPEED_MOVE   * fSpeedUp * fElapsedTime; }   // walk forward
+        if (GetKey( olc::S ).bHeld) { fNewX -= lu_cos( fPlayerA_deg ) * SPEED_MOVE   * fSpeedUp * fElapsedTime; fNewY -= lu_sin( fPlayerA_deg ) * SPEED_MOVE   * fSpeedUp * fElapsedTime; }   // walk backwards
+
+        if (GetKey( olc::Q ).bHeld) { fNewX += lu_sin( fPlayerA_deg ) * SPEED_STRAFE * fSpeedUp * fElapsedTime; fNewY -= lu_cos( fPlayerA_deg ) * SPEED_STRAFE * fSpeedUp * fElapsedTime; }   // strafe left
+        if (GetKey( olc::E ).bHeld) { fNewX -= lu_sin( fPlayerA_deg ) * SPEED_STRAFE * fSpeedUp * fElapsedTime; fNewY += lu_cos( fPlayerA_deg ) * SPEED_STRAFE * fSpeedUp * fElapsedTime; }   // strafe right
+        // collision detection - only update position if no collision
+        if (!vMaps[ nActiveMap ].Collides( fNewX, fNewY, fPlayerH, RADIUS_PLAYER, 0.0f, 0.0f )) {
+            fPlayerX = fNewX;
+            fPlayerY = fNewY;
+        }
+
+        // looking up or down - collision detection not necessary
+        // NOTE - there's no clamping to extreme values (yet)
+        if (GetKey( olc::UP   ).bHeld) { fPlayerLU += SPEED_LOOKUP * fSpeedUp * fElapsedTime; }
+        if (GetKey( olc::DOWN ).bHeld) { fPlayerLU -= SPEED_LOOKUP * fSpeedUp * fElapsedTime; }
+
+        // flying or crouching
+        // NOTE - for multi layer rendering there's only clamping to keep fPlayerH > 0.0f, there's no upper limit.
+
+        // cache current height of horizon, so that you can compensate for changes in it via the look up value
+        float fCacheHorHeight = float( ScreenHeight() * fPlayerH ) + fPlayerLU;
+        if (MULTI_LAYERS) {
+            // if the player height is adapted, keep horizon height stable by compensating with look up value
+            if (GetKey( olc::PGUP ).bHeld) {
+                float fNewHeight = fPlayerH + SPEED_STRAFE_UP * fSpeedUp * fElapsedTime;
+                // do CD on the height map - player velocity is not relevant since movement is up/down
+                if (!vMaps[ nActiveMap ].Collides( fPlayerX, fPlayerY, fNewHeight, 0.1f, 0.0f, 0.0f )) {
+                    fPlayerH = fNewHeight;
+                    fPlayerLU = fCacheHorHeight - float( ScreenHeight() * fPlayerH );
+                }
+            }
+            if (GetKey( olc::PGDN ).bHeld) {
+                float fNewHeight = fPlayerH - SPEED_STRAFE_UP * fSpeedUp * fElapsedTime;
+                // prevent negative height, and do CD on the height map - player velocity is not relevant since movement is up/down
+                if (!vMaps[ nActiveMap ].Collides( fPlayerX, fPlayerY, fNewHeight, 0.1f, 0.0f, 0.0f )) {
+                    fPlayerH  = fNewHeight;
+                    fPlayerLU = fCacheHorHeight - float( ScreenHeight() * fPlayerH );
+                }
+            }
+        } else {
+            if (GetKey( olc::PGUP ).bHeld) {
+                float fNewHeight = fPlayerH + SPEED_STRAFE_UP * fSpeedUp * fElapsedTime;
+                if (fNewHeight < 1.0f) {
+                    fPlayerH = fNewHeight;
+                    // compensate look up value so that horizon remains stable
+                    fPlayerLU = fCacheHorHeight - float( ScreenHeight() * fPlayerH );
+                }
+            }
+            if (GetKey( olc::PGDN ).bHeld) {
+                float fNewHeight = fPlayerH - SPEED_STRAFE_UP * fSpeedUp * fElapsedTime;
+                if (fNewHeight > 0.0f) {
+                    fPlayerH = fNewHeight;
+                    // compensate look up value so that horizon remains stable
+                    fPlayerLU = fCacheHorHeight - float( ScreenHeight() * fPlayerH );
+                }
+            }
+        }
+
+        // alter object intensity and multiplier - for shading
+        if (GetKey( olc::INS  ).bHeld) fObjectIntensity     += INTENSITY_SPEED * fSpeedUp * fElapsedTime;
+        if (GetKey( olc::DEL  ).bHeld) fObjectIntensity     -= INTENSITY_SPEED * fSpeedUp * fElapsedTime;
+        if (GetKey( olc::HOME ).bHeld) fIntensityMultiplier += INTENSITY_SPEED * fSpeedUp * fElapsedTime;
+        if (GetKey( olc::END  ).bHeld) fIntensityMultiplier -= INTENSITY_SPEED * fSpeedUp * fElapsedTime;
+
+
+        // step 2 - game logic
+        // ===================
+
+        bool bStateChanged = false;
+        // directly setting to opened or closed is not useful. State can only become Opening if it was closed, and vice versa
+        if (GetKey( olc::F6 ).bPressed) { bStateChanged = true; nTestAnimState = ANIM_STATE_CLOSING; }
+        if (GetKey( olc::F5 ).bPressed) { bStateChanged = true; nTestAnimState = ANIM_STATE_OPENING; }
+
+        // step 3 - render
+        // ===============
+
+        if (bPipelined) {
+            // render the snapshot of the previous frame, while the update stage works on this frame
+            cStagePool.Run( [&]( int nThread ) {
+                if (nThread == 0) {
+                    ScanMapCells( bStateChanged );
+                    UpdateObjects( fElapsedTime );
+                } else {
+                    RenderStage( sSnapshot );
+                }
+            } );
+            ApplyMapCellUpdates( fElapsedTime );
+            CaptureSnapshot( sSnapshot );
+        } else {
+            ScanMapCells( bStateChanged );
+            ApplyMapCellUpdates( fElapsedTime );
+            UpdateObjects( fElapsedTime );
+            CaptureSnapshot( sSnapshot );
+            RenderStage( sSnapshot );
+        }
+        // the render stage is done, so the render resolution can be changed for the next frame
+        UpdateRenderScale( fElapsedTime );
+
+        // TEST STUFF RENDERING
+        // ====================
+
+        // to aim the slice that is output on testmode
+        if (bTestSlice) {
+            DrawLine( int( fTestSlice ), 0, int( fTestSlice ), ScreenHeight() - 1, olc::MAGENTA );
+        }
+
+        // horizontal grid lines for testing
+        if (bTestGrid) {
+            for (int i = 0; i < ScreenHeight(); i+= 100) {
+                for (int j = 0; j < 100; j+= 10) {
+                    DrawLine( 0, i + j, ScreenWidth() - 1, i + j, olc::BLACK );
+                }
+                DrawLine( 0, i, ScreenWidth() - 1, i, olc::DARK_GREY );
+                DrawString( 0, i - 5, std::to_string( i ), olc::WHITE );
+            }
+        }
+
+        // MINIMAP & HUD RENDERING
+        // =======================
+
+        if (bMinimap) {
+            RenderMap( 0 );
+            if (bMapRays) {
+                RenderMapRays( int( fPlayerH ));
+            }
+            RenderMapPlayer();
+            RenderMapObjects();
+
+            vRayList.clear();
+        }
+
+        if (bPlayerInfo) {
+            RenderPlayerInfo();
+        }
+
+        if (bProcessInfo) {
+            RenderProcessInfo();
+        }
+
+        return true;
+    }
+
+    bool OnUserDestroy() {
+
+        // the worker threads must be stopped before the maps are cleaned up
+        cRayQuery.Finalize();
+        cRenderPool.Finalize();
+        cStagePool.Finalize();
+
+        delete pWorkSprite;
+        delete pSceneSprite;
+        delete pHistSprite;
+        delete pRenderSprite;
+
+		for (int i = 0; i < (int)vMaps.size(); i++) {
+	        vMaps[i].FinalizeMap();
+		}
+
+        return true;
+    }
+};
+
+// Command line arguments (optional):
+//   --bench [ref. file]                  runs the scaling benchmark and its checks without the UI, the exit code is 0 if all checks passed
+//   --bench-write-reference [ref. file]  the same, but (re)writes the reference output of the fixed point DDA
+//   --check-adaptive                     renders a camera path with and without the adaptive column subdivision without the UI, the exit
+//                                        code is 0 if all frames are identical. It needs the sprite files in the current working directory
+// The reference file defaults to BENCH_REFERENCE_FILE in the directory of the executable.
+int main( int argc, char *argv[] )
+{
+	MyRayCaster demo;
+	demo.SetBenchReferencePath( (argc > 2) ? argv[2] : "", argv[0] );
+	if (argc > 1) {
+		std::string sArg = argv[1];
+		if (sArg != "--bench" && sArg != "--bench-write-reference" && sArg != "--check-adaptive") {
+			std::cout << "ERROR: main() --> unknown argument: " << sArg << std::endl;
+			return 1;
+		}
+		if (argc > ((sArg == "--check-adaptive") ? 2 : 3)) {
+			std::cout << "ERROR: main() --> too many arguments" << std::endl;
+			return 1;
+		}
+		// the engine is constructed and initialized but not started, so no window is opened. The scaling benchmark doesn't sample
+		// any sprites, so it doesn't matter if OnUserCreate() can't find the sprite files from the current working directory
+		if (!demo.Construct( SCREEN_X / PIXEL_SIZE, SCREEN_Y / PIXEL_SIZE, PIXEL_SIZE, PIXEL_SIZE ))
+			return 1;
+		bool bCreated = demo.OnUserCreate();
+		bool bPassed  = false;
+		if (sArg == "--check-adaptive") {
+			if (!bCreated) {
+				std::cout << "ERROR: main() --> can't load the sprite files from the current working directory" << std::endl;
+			} else {
+				bPassed = demo.RunAdaptiveColumnsCheck();
+			}
+		} else {
+			bPassed = demo.RunScalingBenchmark( BENCH_MAX_MAP_SIZE, sArg == "--bench-write-reference" );
+		}
+		demo.OnUserDestroy();
+		return bPassed ? 0 : 1;
+	}
+	if (demo.Construct( SCREEN_X / PIXEL_SIZE, SCREEN_Y / PIXEL_SIZE, PIXEL_SIZE, PIXEL_SIZE ))
+		demo.Start();
+
+	return 0;
+}
+
+//////////////////////////////////   put bloat behind main()  /////////////////////////////////
+
+// ==============================/   Mini map rendering stuff   /==============================
+
+// function to render the mini map on the screen
+void MyRayCaster::RenderMap( int nRenderLevel ) {
+
+    auto local_map_cell_height = [=]( int nLayer, int x, int y ) {
+        if (nLayer < 0) return vMaps[ nActiveMap ].CellHeight( x, y );
+        if (nLayer > vMaps[ nActiveMap ].NrOfLayers()) return 0.0f;
+        return vMaps[ nActiveMap ].CellHeightAt( x, y, nRenderLevel );
+    };
+    // fill background for minimap
+    float fMMFactor = MINIMAP_SCALE_FACTOR * MINIMAP_TILE_SIZE;
+    FillRect( 0, 0, vMaps[ nActiveMap ].GetWidth() * fMMFactor, vMaps[ nActiveMap ].GetHeight() * fMMFactor, COL_HUD_BG );
+    // draw each tile
+    for (int y = 0; y < vMaps[ nActiveMap ].GetHeight(); y++) {
+        for (int x = 0; x < vMaps[ nActiveMap ].GetWidth(); x++) {
+            // colour different for different heights
+            olc::Pixel p;
+            bool bBorderFlag = true;
+            if (local_map_cell_height( nRenderLevel, x, y ) == 0.0f) {
+                p = COL_HUD_BG;   // don't visibly render
+                bBorderFlag = false;
+            } else if (local_map_cell_height( nRenderLevel, x, y )  <  1.0f) {
+                p = olc::PixelF( vMaps[ nActiveMap ].CellHeight( x, y ), 0.0f, 0.0f );    // height < 1.0f = shades of red
+            } else {
+                float fColFactor = std::min( vMaps[ nActiveMap ].CellHeight( x, y ) / 4.0f + 0.5f, 1.0f );    // heights > 1.0f = shades of blue
+                p = olc::PixelF( 0.0f, 0.0f, fColFactor );
+            }
+            // render this tile
+            FillRect( x * fMMFactor + 1, y * fMMFactor + 1, fMMFactor - 1, fMMFactor - 1, p );
+
+            if (bBorderFlag) {
+                p = olc::WHITE;
+                DrawRect( x * fMMFactor, y * fMMFactor, fMMFactor, fMMFactor, p);
+
+                RC_MapCell *pMapCellPtr = vMaps[ nActiveMap ].MapCellPtrAt( x, y, 0 );
+                for (int i = FACE_EAST; i < FACE_TOP; i++) {
+                    RC_Face *auxFptr = pMapCellPtr->GetFacePtr( i );
+                    if (auxFptr->IsPortal()) {
+                        switch (i) {
+                            case FACE_EAST:  DrawLine( (x + 1) * fMMFactor,  y      * fMMFactor, (x + 1) * fMMFactor, (y + 1) * fMMFactor, olc::RED ); break;
+                            case FACE_NORTH: DrawLine(  x      * fMMFactor,  y      * fMMFactor, (x + 1) * fMMFactor,  y      * fMMFactor, olc::RED ); break;
+                            case FACE_WEST:  DrawLine(  x      * fMMFactor,  y      * fMMFactor,  x      * fMMFactor, (y + 1) * fMMFactor, olc::RED ); break;
+                            case FACE_SOUTH: DrawLine(  x      * fMMFactor, (y + 1) * fMMFactor, (x + 1) * fMMFactor, (y + 1) * fMMFactor, olc::RED ); break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// function to render the player in the mini map on the screen
+void MyRayCaster::RenderMapPlayer() {
+    float fMMFactor = MINIMAP_TILE_SIZE * MINIMAP_SCALE_FACTOR;
+    olc::Pixel p = olc::YELLOW;
+    float px = fPlayerX * fMMFactor;
+    float py = fPlayerY * fMMFactor;
+    float pr = 0.6f     * fMMFactor;
+
+    // draw sense radius around player - let it blend to get it semi-transparent
+    SetPixelBlend( SENSE_BLENDF );
+    SetPixelMode( olc::Pixel::ALPHA );
+    FillCircle( px, py, SENSE_RADIUS * fMMFactor, olc::DARK_GREY );
+    SetPixelMode( olc::Pixel::NORMAL );
+
+    // Draw player object itself
+    FillCircle( px, py, pr, p );
+    // Draw player direction pointer
+    float dx = lu_cos( fPlayerA_deg );
+    float dy = lu_sin( fPlayerA_deg );
+    float pdx = dx * 2.0f * fMMFactor;
+    float pdy = dy * 2.0f * fMMFactor;
+    DrawLine( px, py, px + pdx, py + pdy, p );
+}
+
+// function to render the rays in the mini map on the screen
+void MyRayCaster::RenderMapRays( int nPlayerLevel ) {
+    // choose different colour for each layer
+    auto get_layer_col = [=]( int nLvl ) {
+        olc::Pixel result = olc::WHITE;
+        switch (nLvl) {
+            case 0 : result = olc::GREEN;   break;
+            case 1 : result = olc::RED;     break;
+            case 2 : result = olc::BLUE;    break;
+            case 3 : result = olc::GREY;    break;
+            case 4 : result = olc::MAGENTA; break;
+            default: result = olc::YELLOW;  break;
+        }
+        return result;
+    };
+
+    float fMMFactor = MINIMAP_TILE_SIZE * MINIMAP_SCALE_FACTOR;
+    // draw an outline of the visible part of the world
+    // use a different colour per layer
+    olc::Pixel layerCol = get_layer_col( nPlayerLevel );
+    for (auto &elt : vRayList) {
+    if (elt.layer == nPlayerLevel) {
+            DrawLine(
+            elt.pointA.x * fMMFactor,
+            elt.pointA.y * fMMFactor,
+            elt.pointB.x * fMMFactor,
+            elt.pointB.y * fMMFactor,
+                layerCol
+            );
+        }
+    }
+}
+
+// function to render all the objects in the mini map on the screen
+void MyRayCaster::RenderMapObjects() {
+    float fMMFactor = MINIMAP_TILE_SIZE * MINIMAP_SCALE_FACTOR;
+    for (auto &elt : vMaps[nActiveMap].vListObjects) {
+
+        olc::Pixel p = (elt.bStationary ? olc::RED : olc::MAGENTA);
+
+        float px = elt.GetX() * fMMFactor;
+        float py = elt.GetY() * fMMFactor;
+        float pr = 0.4f  * fMMFactor;
+        FillCircle( px, py, pr, p );
+
+        if (!elt.bStationary) {
+            float dx = lu_cos( rad2deg( elt.GetAngle()));
+            float dy = lu_sin( rad2deg( elt.GetAngle()));
+            float pdx = dx * 0.3f * elt.GetSpeed() * fMMFactor;
+            float pdy = dy * 0.3f * elt.GetSpeed() * fMMFactor;
+            DrawLine( px, py, px + pdx, py + pdy, p );
+        }
+    }
+}
+
+// function to render player info in a separate hud on the screen
+void MyRayCaster::RenderPlayerInfo() {
+    int nStartX = ScreenWidth() - 200;
+    int nStartY =  10;
+    // render background pane for debug info
+    FillRect( nStartX, nStartY, 190, 65, COL_HUD_BG );
+    // output player and rendering values for debugging
+    DrawString( nStartX + 5, nStartY +   5, "X      = " + std::to_string( fPlayerX     ), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY +  15, "Y      = " + std::to_string( fPlayerY     ), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY +  25, "H      = " + std::to_string( fPlayerH     ), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY +  35, "Angle  = " + std::to_string( fPlayerA_deg ), COL_HUD_TXT );
+    // show the map cell the player is aiming at, using a hitscan query
+    RayQuery sAim;
+    sAim.nMap     = nActiveMap;
+    sAim.nLayer   = int( fPlayerH );
+    sAim.fOrgX    = fPlayerX;
+    sAim.fOrgY    = fPlayerY;
+    sAim.fDirX    = lu_cos( fPlayerA_deg );
+    sAim.fDirY    = lu_sin( fPlayerA_deg );
+    sAim.fMaxDist = vMaps[ nActiveMap ].DiagonalLength();
+    sAim.nFlags   = RAYQ_HITSCAN;
+    RayQueryResult sAimResult;
+    if (cRayQuery.CastRay( sAim, sAimResult )) {
+        DrawString( nStartX + 5, nStartY +  45, "Aim    = (" + std::to_string( sAimResult.nCellX ) + ", " + std::to_string( sAimResult.nCellY ) + ") map " + std::to_string( sAimResult.nMap ), COL_HUD_TXT );
+    } else {
+        DrawString( nStartX + 5, nStartY +  45, "Aim    = -", COL_HUD_TXT );
+    }
+    DrawString( nStartX + 5, nStartY +  55, "LookUp = " + std::to_string( fPlayerLU    ), COL_HUD_TXT );
+}
+
+// function to render performance info in a separate hud on the screen
+void MyRayCaster::RenderProcessInfo() {
+    int nStartX = ScreenWidth()  - 200;
+    int nStartY = ScreenHeight() - 210;
+    // render background pane for debug info
+    FillRect( nStartX, nStartY, 195, 210, COL_HUD_BG );
+    // output player and rendering values for debugging
+    DrawString( nStartX + 5, nStartY +  5, "Intensity  = " + std::to_string( fObjectIntensity        ), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY + 15, "Multiplier = " + std::to_string( fIntensityMultiplier    ), COL_HUD_TXT );
+
+    int nHitsProcessed = 0, nHitsRendered = 0;
+    for (auto &elt : vThreadScratch) {
+        nHitsProcessed += elt.nHitsProcessed;
+        nHitsRendered  += elt.nHitsRendered;
+    }
+    DrawString( nStartX + 5, nStartY +  25, "Hits = " + std::to_string( nHitsProcessed ) + " (" + std::to_string( nHitsRendered ) + " rendered)", COL_HUD_TXT );
+
+    DrawString( nStartX + 5, nStartY +  35, "Slice Q size = " + std::to_string( (int)dSliceQueue.size()), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY +  45, "Active slice = " + std::to_string( nActiveSlice           ), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY +  55, "Test slice   = " + std::to_string( int( fTestSlice )      ), COL_HUD_TXT );
+    int nRaysCast = 0, nRaysFilledIn = 0;
+    for (auto &elt : vThreadScratch) {
+        nRaysCast     += elt.nRaysCast;
+        nRaysFilledIn += elt.nRaysFilledIn;
+    }
+    DrawString( nStartX + 5, nStartY +  65, "Rays cast    = " + std::to_string( nRaysCast ) + (bAdaptiveColumns ? " +" + std::to_string( nRaysFilledIn ) : ""), COL_HUD_TXT );
+
+    DrawString( nStartX + 5, nStartY +  75, "Acive map    = " + std::to_string( nActiveMap                      ), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY +  85, "Map size - X = " + std::to_string( vMaps[ nActiveMap ].GetWidth()  ), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY +  95, "Map size - Y = " + std::to_string( vMaps[ nActiveMap ].GetHeight() ), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY + 105, "Map size - Z = " + std::to_string( vMaps[ nActiveMap ].NrOfLayers()), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY + 115, "# Objects    = " + std::to_string( (int)vMaps[nActiveMap].vListObjects.size()), COL_HUD_TXT );
+
+    DrawString( nStartX + 5, nStartY + 135, (bProgressive ? "progressive ON - " + std::to_string( nColumnsDone ) + " done" : "progressive OFF"), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY + 145, "budget (ms)  = " + std::to_string( fFrameBudget_ms ), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY + 155, (bPipelined ? "pipelined ON" : "pipelined OFF"), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY + 165, (bHalfRateFlats ? "half rate flats ON" : "half rate flats OFF"), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY + 175, (bInterleaved ? "interleaved ON - " + std::to_string( nColumnsRerendered ) + " redone" : "interleaved OFF"), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY + 185, "Resolution   = " + std::to_string( RenderWidth()) + "x" + std::to_string( RenderHeight()) + (bDynamicRes ? " dyn" : ""), COL_HUD_TXT );
+    DrawString( nStartX + 5, nStartY + 195, (bDeferred ? "deferred shading ON" : "deferred shading OFF"), COL_HUD_TXT );
+
+}
+
+// Shade the pixel p using fDistance as a factor in the shade formula
+olc::Pixel MyRayCaster::ShadePixel( const olc::Pixel &p, float fDistance ) {
+    if (RENDER_SHADED) {
+        float fShadeFactor = std::max( SHADE_FACTOR_MIN, std::min( SHADE_FACTOR_MAX, fObjectIntensity * ( fIntensityMultiplier /  fDistance )));
+        return p * fShadeFactor;
+    } else
+        return p;
+}
+
+// Blend the pixel p into fogCol, fFogFactor is in [0, 1] (0 means: no fog)
+olc::Pixel MyRayCaster::FogPixel( const olc::Pixel &p, float fFogFactor, const olc::Pixel &fogCol ) {
+    return olc::Pixel(
+        uint8_t( float( p.r ) + fFogFactor * (float( fogCol.r ) - float( p.r ))),
+        uint8_t( float( p.g ) + fFogFactor * (float( fogCol.g ) - float( p.g ))),
+        uint8_t( float( p.b ) + fFogFactor * (float( fogCol.b ) - float( p.b ))),
+        p.a
+    );
+}
+
+// ==============================/  end of file   /==============================
+
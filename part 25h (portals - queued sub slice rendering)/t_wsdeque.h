@@ -0,0 +1,59 @@
+#ifndef T_WSDEQUE_H_INCLUDED
+#define T_WSDEQUE_H_INCLUDED
+
+#include <deque>
+#include <mutex>
+
+// ==============================/  generic (templated) work stealing deque type   /==============================
+
+// A deque of work items for one thread of a pool. The owning thread pushes and pops at the bottom (so it works
+// LIFO on the items it spawned itself), other threads that ran out of work steal from the top (the oldest items).
+// Since an item typically holds a fair amount of work, a plain lock per deque is used instead of a lock free deque.
+template <class T>
+class t_wsdeque {
+
+private:
+    std::deque<T> dDeque;
+    std::mutex    mtxDeque;
+
+public:
+    t_wsdeque() {}
+    ~t_wsdeque() { dDeque.clear(); }
+
+    // for the owning thread - the item is moved into the deque
+    void push( T &&r ) {
+        std::lock_guard<std::mutex> lock( mtxDeque );
+        dDeque.push_back( std::move( r ));
+    }
+
+    bool pop( T &r ) {
+        std::lock_guard<std::mutex> lock( mtxDeque );
+        if (dDeque.empty())
+            return false;
+        r = std::move( dDeque.back());
+        dDeque.pop_back();
+        return true;
+    }
+
+    // for the other threads
+    bool steal( T &r ) {
+        std::lock_guard<std::mutex> lock( mtxDeque );
+        if (dDeque.empty())
+            return false;
+        r = std::move( dDeque.front());
+        dDeque.pop_front();
+        return true;
+    }
+
+    // characteristics queries
+    int size() {
+        std::lock_guard<std::mutex> lock( mtxDeque );
+        return dDeque.size();
+    }
+    bool empty() {
+        std::lock_guard<std::mutex> lock( mtxDeque );
+        return dDeque.empty();
+    }
+};
+
+#endif // T_WSDEQUE_H_INCLUDED